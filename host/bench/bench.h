@@ -0,0 +1,62 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+
+/* Micro-benchmark runner for the host build.
+ *
+ * Each case runs its body in growing batches until BENCH_MIN_MS of wall time
+ * has passed (BENCH_QUICK_MS with --quick, for a smoke run under ctest),
+ * then reports the mean time per call. Cases can attach a byte count, for
+ * memory per call. Wall time on a desktop CPU, so compare before/after on
+ * one machine rather than reading the numbers as ESP32 timings. */
+#define BENCH_MIN_MS 200
+#define BENCH_QUICK_MS 5
+
+class Bench {
+public:
+  Bench(const char *filter, bool quick) : _filter(filter), _quick(quick) {}
+
+  template <typename F> void run(const char *name, F body, size_t bytes = 0) {
+    if (!selected(name))
+      return;
+    uint64_t minNs = (uint64_t)(_quick ? BENCH_QUICK_MS : BENCH_MIN_MS) *
+                     1000000;
+    uint64_t calls = 0, ns = 0;
+    for (uint64_t batch = 1; ns < minNs; batch *= 2) {
+      auto start = std::chrono::steady_clock::now();
+      for (uint64_t i = 0; i < batch; i++)
+        body();
+      ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+      calls += batch;
+    }
+    report(name, (double)ns / calls, calls, bytes);
+  }
+
+  // Results computed elsewhere, e.g. counts from a simulation
+  void note(const char *name, const char *text);
+
+  static void header();
+
+private:
+  bool selected(const char *name) const;
+  void report(const char *name, double ns, uint64_t calls, size_t bytes);
+
+  const char *_filter;
+  bool _quick;
+};
+
+// Keep the optimiser from dropping a result
+template <typename T> inline void bench_keep(const T &v) {
+  asm volatile("" : : "g"(&v) : "memory");
+}
+
+// Benchmark groups, one per source file under host/bench
+void bench_model(Bench &b);
+void bench_input(Bench &b);
+#ifdef HOST_HAVE_ARDUINOJSON
+void bench_decode(Bench &b);
+#endif
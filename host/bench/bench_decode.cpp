@@ -0,0 +1,202 @@
+// rr_model decoding: the original buffered path against the filtered
+// streaming decode into PrinterModel, on the fixtures in host/bench/data.
+// They are synthetic, not captures: written by hand in the layout RRF 3.5
+// returns for each key, with every field it sends (heater models, monitors,
+// network interface details) so the filters have as much to skip as on a
+// real printer, for a two-unit, eight-lane AFC set-up with placeholder
+// filament names. "bytes" is what one poll holds on the heap: the buffered
+// body plus the JSON pool it parsed into, plus what the persistent mirror
+// document grew by on the original path.
+#include "bench.h"
+#include "network/model_decoder.h"
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+#ifndef BENCH_DATA_DIR
+#define BENCH_DATA_DIR "host/bench/data"
+#endif
+
+#define LEGACY_DOC_SIZE 24576   // DynamicJsonDocument per poll
+#define LEGACY_MIRROR_SIZE 8192 // _modelHeat, _modelGlobal, _modelTools
+#define MODEL_DOC_SIZE 8192     // network_manager.cpp
+
+static const struct {
+  const char *key; // rr_model key, "" for flags=d99fn
+  const char *file;
+} kPayloads[] = {
+    {"heat", "heat.json"},
+    {"tools", "tools.json"},
+    {"state", "state.json"},
+    {"job", "job.json"},
+    {"network", "network.json"},
+    {"global.AFC_lanes", "global_AFC_lanes.json"},
+    {"global.AFC_lane_to_tool", "global_AFC_lane_to_tool.json"},
+    {"global.AFC_LED_array", "global_AFC_LED_array.json"},
+    {"global.AFC_unit_total_lanes", "global_AFC_unit_total_lanes.json"},
+    {"", "d99fn.json"},
+};
+
+static bool load(const char *file, std::string &out) {
+  std::ifstream in(std::string(BENCH_DATA_DIR "/") + file);
+  if (!in)
+    return false;
+  std::stringstream ss;
+  ss << in.rdbuf();
+  out = ss.str();
+  return true;
+}
+
+// Before: http.getString(), a 24 KB document per poll, then a deep copy
+// of the result into the persistent mirror for that key
+static size_t legacy_store(const std::string &body, const char *key,
+                           DynamicJsonDocument &mirror) {
+  std::string payload(body); // getString()
+  DynamicJsonDocument doc(LEGACY_DOC_SIZE);
+  if (deserializeJson(doc, payload))
+    return 0;
+  size_t before = mirror.memoryUsage();
+  JsonVariant res = doc["result"];
+  if (strncmp(key, "global.", 7) == 0) {
+    mirror[key + 7] = res;
+    mirror.garbageCollect();
+  } else {
+    mirror.clear();
+    mirror.set(res);
+  }
+  size_t grown = mirror.memoryUsage() > before
+                     ? mirror.memoryUsage() - before
+                     : 0;
+  return payload.size() + 1 + doc.memoryUsage() + grown;
+}
+
+// After: the filtered document parsed from the socket and decoded into
+// the typed model, as NetworkManager::requestModel() and storeModelKey()
+static size_t filtered_store(const std::string &body, const char *key,
+                             PrinterModel &m) {
+  StaticJsonDocument<384> filter;
+  filter["key"] = true;
+  buildModelFilter(filter["result"].to<JsonVariant>(), key);
+  std::istringstream socket(body);
+  DynamicJsonDocument doc(MODEL_DOC_SIZE);
+  if (deserializeJson(doc, socket, DeserializationOption::Filter(filter)))
+    return 0;
+  JsonObjectConst result = doc["result"].as<JsonObjectConst>();
+  if (*key) {
+    decodeModelKey(m, key, doc["result"], false);
+  } else {
+    for (JsonPairConst kv : result) {
+      if (strcmp(kv.key().c_str(), "seqs") != 0)
+        decodeModelKey(m, kv.key().c_str(), kv.value(), false);
+    }
+  }
+  return doc.memoryUsage();
+}
+
+// The unfiltered document decoded the same way: the filter must keep
+// every field the decoder reads
+static bool same_model(const PrinterModel &a, const PrinterModel &b) {
+  if (a.status != b.status || strcmp(a.printerName, b.printerName) != 0 ||
+      a.heaterCount != b.heaterCount || a.toolCount != b.toolCount ||
+      a.filePosition != b.filePosition || a.fileSize != b.fileSize ||
+      a.unitCount != b.unitCount)
+    return false;
+  for (int i = 0; i < a.heaterCount; i++) {
+    if (a.heaters[i].current != b.heaters[i].current ||
+        a.heaters[i].active != b.heaters[i].active)
+      return false;
+  }
+  if (memcmp(a.toolHeater, b.toolHeater, sizeof(a.toolHeater)) != 0 ||
+      memcmp(a.unitLanes, b.unitLanes, sizeof(a.unitLanes)) != 0)
+    return false;
+  for (int i = 0; i < PM_MAX_LANES; i++) {
+    const LaneInfo &x = a.lanes[i], &y = b.lanes[i];
+    if (x.loaded != y.loaded || x.tool != y.tool || x.led != y.led ||
+        strcmp(x.filament, y.filament) != 0)
+      return false;
+  }
+  return true;
+}
+
+static void check_filters(Bench &b, const std::string *bodies) {
+  PrinterModel filtered, full;
+  for (size_t i = 0; i < sizeof(kPayloads) / sizeof(kPayloads[0]); i++) {
+    const char *key = kPayloads[i].key;
+    if (!*key)
+      continue; // d99fn only repeats live fields of the keys above
+    filtered_store(bodies[i], key, filtered);
+    DynamicJsonDocument doc(LEGACY_DOC_SIZE);
+    deserializeJson(doc, bodies[i]);
+    decodeModelKey(full, key, doc["result"], false);
+  }
+  b.note("decode.filter check", same_model(filtered, full)
+                                    ? "filtered decode matches unfiltered"
+                                    : "MISMATCH: a filter drops a used field");
+}
+
+// Before: the dashboard's AFC getters walked the global mirror each call
+static int legacy_lane_value(DynamicJsonDocument &global, const char *name,
+                             int unit, int lane, int fallback) {
+  if (global.containsKey(name)) {
+    JsonArray units = global[name].as<JsonArray>();
+    if (unit >= 0 && unit < (int)units.size()) {
+      JsonArray lanes = units[unit].as<JsonArray>();
+      if (lane >= 0 && lane < (int)lanes.size())
+        return lanes[lane].as<int>();
+    }
+  }
+  return fallback;
+}
+
+static void bench_legacy_getters(Bench &b, const std::string *bodies) {
+  static DynamicJsonDocument global(LEGACY_MIRROR_SIZE);
+  for (size_t i = 0; i < sizeof(kPayloads) / sizeof(kPayloads[0]); i++) {
+    if (strncmp(kPayloads[i].key, "global.", 7) == 0)
+      legacy_store(bodies[i], kPayloads[i].key, global);
+  }
+  // Same pass as model.getters: every lane of unit 1
+  b.run("legacy.getters (one dashboard pass)", [] {
+    int sum = 0;
+    for (int l = 0; l < 4; l++) {
+      sum += legacy_lane_value(global, "AFC_lane_to_tool", 1, l, 4 + l);
+      sum += legacy_lane_value(global, "AFC_LED_array", 1, l, -1);
+    }
+    bench_keep(sum);
+  });
+}
+
+void bench_decode(Bench &b) {
+  const size_t count = sizeof(kPayloads) / sizeof(kPayloads[0]);
+  std::string bodies[count];
+  for (size_t i = 0; i < count; i++) {
+    if (!load(kPayloads[i].file, bodies[i])) {
+      b.note("decode", "skipped: no payloads in " BENCH_DATA_DIR);
+      return;
+    }
+  }
+
+  check_filters(b, bodies);
+  for (size_t i = 0; i < count; i++) {
+    const char *key = kPayloads[i].key;
+    const std::string &body = bodies[i];
+    char name[64];
+    const char *label = *key ? key : "d99fn";
+
+    if (*key) { // The original firmware polled each key on its own
+      static DynamicJsonDocument mirror(LEGACY_MIRROR_SIZE);
+      mirror.clear();
+      size_t bytes = legacy_store(body, key, mirror);
+      snprintf(name, sizeof(name), "decode.buffered %s", label);
+      b.run(name, [&] { bench_keep(legacy_store(body, key, mirror)); },
+            bytes);
+    }
+
+    static PrinterModel m;
+    size_t bytes = filtered_store(body, key, m);
+    snprintf(name, sizeof(name), "decode.filtered %s", label);
+    b.run(name, [&] { bench_keep(filtered_store(body, key, m)); }, bytes);
+  }
+  bench_legacy_getters(b, bodies);
+}
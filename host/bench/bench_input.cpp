@@ -0,0 +1,52 @@
+#include "bench.h"
+#include "input/touch_calib.h"
+#include "input/touch_filter.h"
+#include "perf/phase_histogram.h"
+
+static void bench_filter(Bench &b) {
+  static TouchFilter f;
+  static uint32_t us = 0;
+  // A slow drag with sensor jitter, one report per 20 ms
+  b.run("touch.filter push + update", [] {
+    us += 20000;
+    uint16_t x = 100 + (us / 20000) % 200;
+    uint16_t y = 200 + (us / 20000) % 3;
+    f.push({us, x, y, true});
+    bench_keep(f.update(us));
+  });
+}
+
+static void bench_calibration(Bench &b) {
+  static TouchCalibration cal;
+  static uint16_t raw = 0;
+  b.run("touch.calibration map", [] {
+    int32_t x, y;
+    raw = (raw + 7) & 0x1FF;
+    cal.map(raw, 480 - raw, x, y);
+    bench_keep(x);
+    bench_keep(y);
+  });
+  static const TouchPair pairs[5] = {{305, 19, 20, 20},
+                                     {315, 478, 460, 20},
+                                     {5, 39, 20, 300},
+                                     {27, 474, 460, 300},
+                                     {160, 250, 240, 160}};
+  b.run("touch.calibration solve (5 points)",
+        [] { bench_keep(cal.solve(pairs, 5)); });
+}
+
+static void bench_histogram(Bench &b) {
+  static PhaseHistogram h;
+  static uint32_t us = 1;
+  b.run("profile.histogram add", [] {
+    us = us * 1103515245 + 12345;
+    h.add(us >> 16);
+  });
+  b.run("profile.histogram summarize", [] { bench_keep(h.summarize()); });
+}
+
+void bench_input(Bench &b) {
+  bench_filter(b);
+  bench_calibration(b);
+  bench_histogram(b);
+}
@@ -0,0 +1,48 @@
+#include "bench.h"
+#include <stdio.h>
+#include <string.h>
+
+// host_bench [--quick] [filter]: cases whose name contains filter
+int main(int argc, char **argv) {
+  bool quick = false;
+  const char *filter = "";
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--quick") == 0)
+      quick = true;
+    else
+      filter = argv[i];
+  }
+
+  Bench b(filter, quick);
+  Bench::header();
+  bench_model(b);
+  bench_input(b);
+#ifdef HOST_HAVE_ARDUINOJSON
+  bench_decode(b);
+#else
+  b.note("decode", "skipped: built without ArduinoJson");
+#endif
+  return 0;
+}
+
+void Bench::header() {
+  printf("%-40s %12s %12s %10s\n", "case", "ns/call", "calls", "bytes");
+}
+
+bool Bench::selected(const char *name) const {
+  return !*_filter || strstr(name, _filter);
+}
+
+void Bench::report(const char *name, double ns, uint64_t calls,
+                   size_t bytes) {
+  char mem[24] = "";
+  if (bytes)
+    snprintf(mem, sizeof(mem), "%zu", bytes);
+  printf("%-40s %12.1f %12llu %10s\n", name, ns, (unsigned long long)calls,
+         mem);
+}
+
+void Bench::note(const char *name, const char *text) {
+  if (selected(name))
+    printf("%-40s %s\n", name, text);
+}
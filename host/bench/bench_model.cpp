@@ -0,0 +1,146 @@
+#include "bench.h"
+#include "network/command_queue.h"
+#include "network/filament_catalog.h"
+#include "network/poll_scheduler.h"
+#include "network/printer_link.h"
+#include "network/printer_model.h"
+#include "network/temp_history.h"
+#include <stdio.h>
+
+// Two BoxTurtles, a bed and four tools, mid-print
+static PrinterModel sample_model() {
+  PrinterModel m;
+  m.status = PS_PROCESSING;
+  m.heaterCount = 5;
+  for (int h = 0; h < m.heaterCount; h++)
+    m.heaters[h] = {h ? 215.3f : 60.1f, h ? 215.0f : 60.0f};
+  m.toolCount = 4;
+  for (int t = 0; t < m.toolCount; t++)
+    m.toolHeater[t] = 1 + t;
+  m.unitCount = 2;
+  for (int u = 0; u < m.unitCount; u++) {
+    for (int l = 0; l < m.laneCount(u); l++) {
+      LaneInfo &lane = m.lanes[PrinterModel::laneIndex(u, l)];
+      lane.loaded = l != 3;
+      lane.tool = m.laneNumber(u, l);
+      lane.led = lane.loaded ? LED_GREEN : LED_RED;
+      snprintf(lane.filament, sizeof(lane.filament), "Generic PLA %d", l);
+    }
+  }
+  return m;
+}
+
+// The dashboard's per-refresh reads through the DataManager getters
+static void bench_getters(Bench &b) {
+  static const PrinterModel m = sample_model();
+  b.run("model.getters (one dashboard pass)", [] {
+    int sum = 0;
+    for (int l = 0; l < m.laneCount(1); l++) {
+      const LaneInfo *lane = m.lane(1, l);
+      sum += lane->loaded;
+      sum += lane->tool >= 0 ? lane->tool : m.laneNumber(1, l);
+      sum += lane->led;
+      sum += lane->filament[0];
+    }
+    const HeaterReading *h = m.toolHeaterReading(0);
+    sum += (int)(h->current + m.heaters[0].current + m.progress);
+    bench_keep(sum);
+  });
+}
+
+static void bench_snapshot(Bench &b) {
+  static SnapshotBuffer<PrinterModel> snap;
+  static const PrinterModel m = sample_model();
+  static PrinterModel out;
+  b.run("snapshot.publish", [] { snap.publish(m); }, sizeof(PrinterModel));
+  b.run("snapshot.read", [] { bench_keep(snap.read(out)); },
+        sizeof(PrinterModel));
+}
+
+static void bench_commands(Bench &b) {
+  static CommandQueue q;
+  static GCodeCommand batch[8];
+  // Ten "+5" taps on the bed, then the sender drains the merged command
+  b.run("commands.10 taps + send", [] {
+    for (int i = 0; i < 10; i++)
+      q.pushSetpoint(CMD_SETPOINT_BED, 60 + 5 * i, "M140 S60\nM144 S1");
+    size_t n = q.takeBatch(batch, 8, 384);
+    q.complete(n, true, 1);
+  });
+  b.run("commands.setpoint read-back", [] {
+    float v = 0;
+    bench_keep(q.setpoint(CMD_SETPOINT_BED, 0, v));
+  });
+}
+
+static void bench_scheduler(Bench &b) {
+  static PollScheduler s;
+  static uint32_t now = 0;
+  s.setEnabled((PK_MASK(PK_COUNT) - 1) & ~PK_MASK(PK_LIVE));
+  s.setActivity(PA_PRINTING);
+  b.run("scheduler.next + mark", [] {
+    now += 50;
+    int k = s.next(now);
+    if (k >= 0)
+      s.markFetched((PollKey)k, now);
+  });
+}
+
+static void bench_history(Bench &b) {
+  static TempHistory h;
+  static const PrinterModel m = sample_model();
+  static uint32_t now = 0;
+  b.run("history.sample", [] {
+    now += TH_FINE_MS;
+    h.sample(now, m);
+  });
+  static TempPoint pts[TH_FINE_LEN];
+  b.run("history.read fine tier", [] {
+    bench_keep(h.read(TT_FINE, 1, 0, pts, TH_FINE_LEN));
+  });
+}
+
+static void bench_catalog(Bench &b) {
+  static FilamentCatalog c;
+  static const char *const brands[] = {"Generic", "Prusament", "Polymaker",
+                                       "eSun", "Sunlu", "Elegoo"};
+  static const char *const kinds[] = {"PLA", "PETG", "ABS", "ASA", "TPU",
+                                      "PA-CF", "PC"};
+  char name[FC_MAX_NAME];
+  for (int i = 0; i < 2000; i++) {
+    int len = snprintf(name, sizeof(name), "%s %s %d", brands[i % 6],
+                       kinds[i / 6 % 7], i);
+    c.add(name, len);
+  }
+  c.finish();
+  static uint16_t out[64];
+  b.run("catalog.search prefix (2000 names)",
+        [] { bench_keep(c.search("pru", out, 64)); }, c.bytes());
+  b.run("catalog.search substring (2000 names)",
+        [] { bench_keep(c.search("petg", out, 64)); }, c.bytes());
+}
+
+// The link bookkeeping around one request, transport cost excluded
+static void bench_link(Bench &b) {
+  static PrinterLink link;
+  fake_http_set_handler([](const FakeHttpRequest &, FakeHttpResponse &res) {
+    res.body = "{\"key\":\"state\",\"flags\":\"\",\"result\":{}}";
+  });
+  link.setHost("192.168.1.20");
+  static const String uri = "/rr_model?key=state";
+  b.run("link.get bookkeeping", [] {
+    bench_keep(link.get(uri, 500));
+    link.end();
+  });
+  fake_http_set_handler(nullptr);
+}
+
+void bench_model(Bench &b) {
+  bench_getters(b);
+  bench_snapshot(b);
+  bench_commands(b);
+  bench_scheduler(b);
+  bench_history(b);
+  bench_catalog(b);
+  bench_link(b);
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "IPAddress.h"
+#include "Stream.h"
+#include "WString.h"
+#include "freertos/FreeRTOS.h"
+#include "host_clock.h"
+
+/* Host stand-in for the Arduino-ESP32 core: just enough for the modules
+ * under src/ that do not touch hardware. Widths follow the ESP32, where
+ * millis() and micros() are 32 bits and wrap. */
+
+using std::max;
+using std::min;
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+
+inline long random(long howbig) { return howbig > 0 ? rand() % howbig : 0; }
+inline long random(long howsmall, long howbig) {
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+inline uint32_t getCpuFrequencyMhz() { return 240; }
+
+#if !defined(__APPLE__) && !defined(__FreeBSD__) &&                          \
+    !(defined(__GLIBC__) &&                                                   \
+      (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 38)))
+inline size_t strlcpy(char *dst, const char *src, size_t size) {
+  size_t len = strlen(src);
+  if (size) {
+    size_t n = len < size - 1 ? len : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return len;
+}
+#endif
+
+// Serial goes to stdout; HOST_QUIET=1 in the environment silences it
+class HostSerial {
+public:
+  void begin(unsigned long) {}
+  int printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+  size_t print(const char *s) { return write(s); }
+  size_t print(const String &s) { return write(s.c_str()); }
+  size_t print(int v) { return write(String(v).c_str()); }
+  size_t print(unsigned v) { return write(String(v).c_str()); }
+  size_t print(long v) { return write(String(v).c_str()); }
+  size_t print(unsigned long v) { return write(String(v).c_str()); }
+  size_t print(double v) { return write(String(v).c_str()); }
+  size_t print(const IPAddress &ip) { return write(ip.toString().c_str()); }
+  template <typename T> size_t println(const T &v) {
+    size_t n = print(v);
+    return n + write("\n");
+  }
+  size_t println() { return write("\n"); }
+
+private:
+  size_t write(const char *s);
+};
+
+extern HostSerial Serial;
@@ -0,0 +1,76 @@
+#pragma once
+#include <Arduino.h>
+
+#include "WiFi.h"
+#include "fake_http.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_NO_STREAM (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM (-8)
+#define HTTPC_ERROR_ENCODING (-9)
+#define HTTPC_ERROR_STREAM_WRITE (-10)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+// Response body as a stream, read once like a socket
+class BodyStream : public Stream {
+public:
+  void reset(const String &body) {
+    _body = body;
+    _pos = 0;
+  }
+  int available() override { return (int)(_body.length() - _pos); }
+  int read() override {
+    return _pos < _body.length() ? (uint8_t)_body[_pos++] : -1;
+  }
+  int peek() override {
+    return _pos < _body.length() ? (uint8_t)_body[_pos] : -1;
+  }
+  String rest() {
+    String r = _body.substring(_pos);
+    _pos = _body.length();
+    return r;
+  }
+
+private:
+  String _body;
+  unsigned int _pos = 0;
+};
+
+/* The HTTPClient calls PrinterLink makes, answered by fake_http.h */
+class HTTPClient {
+public:
+  void setReuse(bool reuse) { _reuse = reuse; }
+  void setTimeout(uint16_t ms) { _timeoutMs = ms; }
+  void setConnectTimeout(int32_t) {}
+
+  bool begin(WiFiClient &client, const String &host, uint16_t port,
+             const String &uri) {
+    (void)port;
+    _client = &client;
+    _host = host;
+    _uri = uri;
+    return true;
+  }
+  int GET();
+  int getSize() { return _size; }
+  Stream &getStream() { return _body; }
+  String getString() { return _body.rest(); }
+  void end() {
+    if (_client && !_reuse)
+      _client->stop();
+  }
+
+private:
+  WiFiClient *_client = nullptr;
+  String _host;
+  String _uri;
+  bool _reuse = true;
+  uint16_t _timeoutMs = 5000;
+  int _size = -1;
+  BodyStream _body;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+
+#include "WString.h"
+
+/* IPv4 address in network byte order, as the ESP32 core keeps it */
+class IPAddress {
+public:
+  IPAddress() { _a.dword = 0; }
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    _a.bytes[0] = a;
+    _a.bytes[1] = b;
+    _a.bytes[2] = c;
+    _a.bytes[3] = d;
+  }
+  IPAddress(uint32_t address) { _a.dword = address; }
+
+  operator uint32_t() const { return _a.dword; }
+  bool operator==(const IPAddress &rhs) const {
+    return _a.dword == rhs._a.dword;
+  }
+  bool operator!=(const IPAddress &rhs) const { return !(*this == rhs); }
+  uint8_t operator[](int i) const { return _a.bytes[i]; }
+
+  bool fromString(const char *s) {
+    unsigned v[4];
+    char tail;
+    if (sscanf(s, "%u.%u.%u.%u%c", &v[0], &v[1], &v[2], &v[3], &tail) != 4)
+      return false;
+    for (int i = 0; i < 4; i++) {
+      if (v[i] > 255)
+        return false;
+      _a.bytes[i] = v[i];
+    }
+    return true;
+  }
+  bool fromString(const String &s) { return fromString(s.c_str()); }
+
+  String toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _a.bytes[0], _a.bytes[1],
+             _a.bytes[2], _a.bytes[3]);
+    return String(buf);
+  }
+
+private:
+  union {
+    uint8_t bytes[4];
+    uint32_t dword;
+  } _a;
+};
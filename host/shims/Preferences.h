@@ -0,0 +1,6 @@
+#pragma once
+#include <Arduino.h>
+
+/* NVS settings. Nothing on the host persists them, so only the type is
+ * here: code that reads or writes settings is not built for the host. */
+class Preferences {};
@@ -0,0 +1,22 @@
+#pragma once
+#include <stddef.h>
+
+/* Byte source with the Arduino Stream read interface */
+class Stream {
+public:
+  virtual ~Stream() {}
+  virtual int available() = 0;
+  virtual int read() = 0; // -1 when empty
+  virtual int peek() = 0;
+
+  size_t readBytes(char *buf, size_t len) {
+    size_t n = 0;
+    while (n < len) {
+      int c = read();
+      if (c < 0)
+        break;
+      buf[n++] = (char)c;
+    }
+    return n;
+  }
+};
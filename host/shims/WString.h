@@ -0,0 +1,151 @@
+#pragma once
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+/* Arduino String on top of std::string: the constructors, concatenation
+ * and queries the firmware uses, with the same number formatting. */
+class String {
+public:
+  String() {}
+  String(const char *s) : _s(s ? s : "") {}
+  String(const String &other) = default;
+  String &operator=(const String &other) = default;
+  explicit String(char c) : _s(1, c) {}
+  explicit String(unsigned char v, unsigned char base = 10) {
+    format((unsigned long)v, base);
+  }
+  explicit String(int v, unsigned char base = 10) { format((long)v, base); }
+  explicit String(unsigned int v, unsigned char base = 10) {
+    format((unsigned long)v, base);
+  }
+  explicit String(long v, unsigned char base = 10) { format(v, base); }
+  explicit String(unsigned long v, unsigned char base = 10) {
+    format(v, base);
+  }
+  explicit String(long long v) { _s = std::to_string(v); }
+  explicit String(unsigned long long v) { _s = std::to_string(v); }
+  explicit String(float v, unsigned int decimals = 2) {
+    formatFloat(v, decimals);
+  }
+  explicit String(double v, unsigned int decimals = 2) {
+    formatFloat(v, decimals);
+  }
+
+  const char *c_str() const { return _s.c_str(); }
+  unsigned int length() const { return (unsigned int)_s.size(); }
+  bool isEmpty() const { return _s.empty(); }
+  bool reserve(unsigned int size) {
+    _s.reserve(size);
+    return true;
+  }
+  char operator[](unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+  char charAt(unsigned int i) const { return (*this)[i]; }
+
+  String &operator+=(const String &rhs) {
+    _s += rhs._s;
+    return *this;
+  }
+  String &operator+=(const char *rhs) {
+    _s += rhs ? rhs : "";
+    return *this;
+  }
+  String &operator+=(char c) {
+    _s += c;
+    return *this;
+  }
+
+  bool operator==(const String &rhs) const { return _s == rhs._s; }
+  bool operator==(const char *rhs) const { return _s == (rhs ? rhs : ""); }
+  bool operator!=(const String &rhs) const { return !(*this == rhs); }
+  bool operator!=(const char *rhs) const { return !(*this == rhs); }
+  bool equals(const String &rhs) const { return *this == rhs; }
+
+  int indexOf(char c, unsigned int from = 0) const {
+    size_t i = _s.find(c, from);
+    return i == std::string::npos ? -1 : (int)i;
+  }
+  int indexOf(const String &s, unsigned int from = 0) const {
+    size_t i = _s.find(s._s, from);
+    return i == std::string::npos ? -1 : (int)i;
+  }
+  bool startsWith(const String &s) const {
+    return _s.compare(0, s._s.size(), s._s) == 0;
+  }
+  bool endsWith(const String &s) const {
+    return _s.size() >= s._s.size() &&
+           _s.compare(_s.size() - s._s.size(), s._s.size(), s._s) == 0;
+  }
+  String substring(unsigned int from) const {
+    return from < _s.size() ? String(_s.substr(from)) : String();
+  }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+      unsigned int t = from;
+      from = to;
+      to = t;
+    }
+    return from < _s.size() ? String(_s.substr(from, to - from)) : String();
+  }
+  long toInt() const { return atol(_s.c_str()); }
+  float toFloat() const { return (float)atof(_s.c_str()); }
+  void trim() {
+    size_t b = _s.find_first_not_of(" \t\r\n");
+    size_t e = _s.find_last_not_of(" \t\r\n");
+    _s = b == std::string::npos ? "" : _s.substr(b, e - b + 1);
+  }
+
+  friend String operator+(const String &a, const String &b) {
+    String r(a);
+    r += b;
+    return r;
+  }
+  friend String operator+(const String &a, const char *b) {
+    String r(a);
+    r += b;
+    return r;
+  }
+  friend String operator+(const char *a, const String &b) {
+    String r(a);
+    r += b;
+    return r;
+  }
+  friend String operator+(const String &a, char b) {
+    String r(a);
+    r += b;
+    return r;
+  }
+
+private:
+  explicit String(const std::string &s) : _s(s) {}
+
+  void format(long v, unsigned char base) {
+    if (v < 0 && base == 10) {
+      format((unsigned long)-v, base);
+      _s.insert(_s.begin(), '-');
+    } else {
+      format((unsigned long)v, base);
+    }
+  }
+  void format(unsigned long v, unsigned char base) {
+    char buf[8 * sizeof(v) + 1];
+    char *p = buf + sizeof(buf) - 1;
+    *p = '\0';
+    if (base < 2)
+      base = 10;
+    do {
+      int d = v % base;
+      *--p = d < 10 ? '0' + d : 'a' + d - 10;
+      v /= base;
+    } while (v);
+    _s = p;
+  }
+  void formatFloat(double v, unsigned int decimals) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+    _s = buf;
+  }
+
+  std::string _s;
+};
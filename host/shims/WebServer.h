@@ -0,0 +1,8 @@
+#pragma once
+#include <Arduino.h>
+
+/* The panel's web server, as a type only: it is not built for the host */
+class WebServer {
+public:
+  explicit WebServer(int port) {}
+};
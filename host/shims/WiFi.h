@@ -0,0 +1,24 @@
+#pragma once
+#include <Arduino.h>
+
+/* Client socket as HTTPClient sees it. The fake transport (fake_http.h)
+ * opens and closes it, so keep-alive reuse behaves as on the device. When
+ * requests are forwarded to a real server (fake_http_forward()) it also
+ * holds the TCP socket, which stop() closes. */
+class WiFiClient {
+public:
+  WiFiClient() {}
+  WiFiClient(const WiFiClient &) = delete;
+  WiFiClient &operator=(const WiFiClient &) = delete;
+  ~WiFiClient() { stop(); }
+
+  bool connected() const { return _open; }
+  void stop(); // http_forward.cpp
+  int fd() const { return _fd; }
+  void attach(int fd); // Host only: adopt a connected socket
+
+private:
+  friend class HTTPClient;
+  bool _open = false;
+  int _fd = -1;
+};
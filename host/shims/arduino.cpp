@@ -0,0 +1,28 @@
+#include <Arduino.h>
+
+HostSerial Serial;
+
+static bool quiet() {
+  static int q = -1;
+  if (q < 0) {
+    const char *env = getenv("HOST_QUIET");
+    q = env && *env && strcmp(env, "0") != 0;
+  }
+  return q;
+}
+
+int HostSerial::printf(const char *fmt, ...) {
+  if (quiet())
+    return 0;
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vprintf(fmt, ap);
+  va_end(ap);
+  return n;
+}
+
+size_t HostSerial::write(const char *s) {
+  if (quiet())
+    return 0;
+  return fputs(s, stdout) < 0 ? 0 : strlen(s);
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include <stdlib.h>
+
+/* One heap on the host: the capability bits are accepted and ignored */
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+inline void *heap_caps_malloc(size_t size, unsigned caps) {
+  return malloc(size);
+}
+inline void heap_caps_free(void *ptr) { free(ptr); }
@@ -0,0 +1,84 @@
+#include "fake_dns.h"
+#include "lwip/dns.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+struct Answer {
+  uint32_t addr;
+  FakeDnsMode mode;
+};
+
+struct Waiting {
+  std::string name;
+  dns_found_callback found;
+  void *arg;
+};
+
+std::map<std::string, Answer> s_answers;
+std::vector<Waiting> s_waiting;
+int s_queries = 0;
+
+const Answer &answer(const std::string &name) {
+  static const Answer unknown = {0, FAKE_DNS_ASYNC};
+  auto it = s_answers.find(name);
+  return it == s_answers.end() ? unknown : it->second;
+}
+
+void call(const Waiting &w, uint32_t addr) {
+  ip_addr_t ip = {};
+  ip.type = IPADDR_TYPE_V4;
+  ip.u_addr.ip4.addr = addr;
+  w.found(w.name.c_str(), addr ? &ip : nullptr, w.arg);
+}
+} // namespace
+
+void fake_dns_reset() {
+  s_answers.clear();
+  s_waiting.clear();
+  s_queries = 0;
+}
+
+void fake_dns_set(const char *name, uint32_t addr, FakeDnsMode mode) {
+  s_answers[name] = {addr, mode};
+}
+
+int fake_dns_deliver() {
+  std::vector<Waiting> due;
+  due.swap(s_waiting);
+  int n = 0;
+  for (const Waiting &w : due) {
+    const Answer &a = answer(w.name);
+    if (a.mode == FAKE_DNS_SILENT) {
+      s_waiting.push_back(w);
+      continue;
+    }
+    call(w, a.addr);
+    n++;
+  }
+  return n;
+}
+
+int fake_dns_queries() { return s_queries; }
+
+int fake_dns_waiting() { return (int)s_waiting.size(); }
+
+err_t dns_gethostbyname(const char *hostname, ip_addr_t *addr,
+                        dns_found_callback found, void *callback_arg) {
+  s_queries++;
+  const Answer &a = answer(hostname);
+  switch (a.mode) {
+  case FAKE_DNS_CACHED:
+    if (!a.addr)
+      return ERR_ARG;
+    addr->type = IPADDR_TYPE_V4;
+    addr->u_addr.ip4.addr = a.addr;
+    return ERR_OK;
+  case FAKE_DNS_REJECT:
+    return ERR_ARG;
+  default:
+    s_waiting.push_back({hostname, found, callback_arg});
+    return ERR_INPROGRESS;
+  }
+}
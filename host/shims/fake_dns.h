@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+
+/* Scripted stand-in for lwIP's resolver behind dns_gethostbyname().
+ *
+ * Each name is given an answer and a way of delivering it. Asynchronous
+ * answers wait until the test calls fake_dns_deliver(), the way lwIP calls
+ * back from its own thread some time after the query. Unknown names fail
+ * asynchronously, like an NXDOMAIN. */
+enum FakeDnsMode : uint8_t {
+  FAKE_DNS_CACHED, // Answered at once (ERR_OK), as from lwIP's cache
+  FAKE_DNS_ASYNC,  // ERR_INPROGRESS, answered by fake_dns_deliver()
+  FAKE_DNS_SILENT, // ERR_INPROGRESS, never answered
+  FAKE_DNS_REJECT, // Refused outright (ERR_ARG)
+};
+
+void fake_dns_reset();
+// addr in network byte order, 0 for a name that does not resolve
+void fake_dns_set(const char *name, uint32_t addr,
+                  FakeDnsMode mode = FAKE_DNS_ASYNC);
+int fake_dns_deliver();  // Answer every waiting query; returns how many
+int fake_dns_queries();  // dns_gethostbyname() calls since the reset
+int fake_dns_waiting();  // Queries not answered yet
@@ -0,0 +1,36 @@
+#include "HTTPClient.h"
+#include <atomic>
+
+static FakeHttpHandler s_handler;
+static std::atomic<uint32_t> s_requests{0};
+
+void fake_http_set_handler(FakeHttpHandler handler) {
+  s_handler = handler;
+  s_requests = 0;
+}
+
+uint32_t fake_http_requests() { return s_requests.load(); }
+
+int HTTPClient::GET() {
+  s_requests++;
+  FakeHttpRequest req = {_host, _uri, _client->connected(), _timeoutMs,
+                         _reuse, _client};
+  FakeHttpResponse res;
+  if (s_handler)
+    s_handler(req, res);
+  else
+    res.code = HTTPC_ERROR_CONNECTION_REFUSED;
+
+  if (res.code <= 0) {
+    _client->stop();
+    _size = -1;
+    _body.reset(String());
+    return res.code;
+  }
+  _client->_open = _reuse && res.keepAlive;
+  if (!_client->_open)
+    _client->stop();
+  _size = res.chunked ? -1 : (int)res.body.length();
+  _body.reset(res.body);
+  return res.code;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <Arduino.h>
+#include <WiFi.h>
+#include <functional>
+
+/* Scripted transport behind the HTTPClient shim. Every GET() is handed to
+ * the installed handler, which fills in the response. Latency is up to the
+ * handler: delay() advances the virtual clock, or really sleeps on the
+ * monotonic one. Without a handler every request is refused. */
+struct FakeHttpRequest {
+  String host;
+  String uri;
+  bool reused;        // Sent on a socket kept alive from an earlier request
+  uint16_t timeoutMs;
+  bool reuse;         // The client asks to keep the socket open
+  WiFiClient *client; // Its socket, for handlers that forward the request
+};
+
+struct FakeHttpResponse {
+  int code = 200;         // <= 0: an HTTPC_ERROR_* transport failure
+  String body;
+  bool chunked = false;   // No Content-Length
+  bool keepAlive = true;  // Socket stays open after the response
+};
+
+typedef std::function<void(const FakeHttpRequest &, FakeHttpResponse &)>
+    FakeHttpHandler;
+
+void fake_http_set_handler(FakeHttpHandler handler);
+// Send every request to a real HTTP server at addr:port instead, whatever
+// host it names, e.g. tools/mock_rrf. The socket stays open on the client
+// for the next request when both sides allow keep-alive.
+void fake_http_forward(const char *addr, uint16_t port);
+uint32_t fake_http_requests(); // GET() calls since the handler was set
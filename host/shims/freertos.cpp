@@ -0,0 +1,23 @@
+#include "freertos/FreeRTOS.h"
+#include <chrono>
+#include <mutex>
+
+// Never deleted, like the firmware's locks
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+  return new std::recursive_timed_mutex;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t m, TickType_t wait) {
+  auto *mutex = static_cast<std::recursive_timed_mutex *>(m);
+  if (wait == portMAX_DELAY) {
+    mutex->lock();
+    return pdTRUE;
+  }
+  return mutex->try_lock_for(std::chrono::milliseconds(wait)) ? pdTRUE
+                                                              : pdFALSE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t m) {
+  static_cast<std::recursive_timed_mutex *>(m)->unlock();
+  return pdTRUE;
+}
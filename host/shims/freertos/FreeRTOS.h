@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+
+/* ESP-IDF critical sections as spinlocks between host threads, so the
+ * cross-core hand-offs (CommandQueue, HostResolver) can be exercised with
+ * std::thread standing in for the two cores. */
+typedef struct {
+  volatile int locked;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+
+static inline void host_mux_lock(portMUX_TYPE *mux) {
+  while (__atomic_test_and_set(&mux->locked, __ATOMIC_ACQUIRE)) {
+  }
+}
+
+static inline void host_mux_unlock(portMUX_TYPE *mux) {
+  __atomic_clear(&mux->locked, __ATOMIC_RELEASE);
+}
+
+#define portENTER_CRITICAL(mux) host_mux_lock(mux)
+#define portEXIT_CRITICAL(mux) host_mux_unlock(mux)
+
+typedef void *TaskHandle_t;
+typedef uint32_t TickType_t;
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+/* Recursive mutexes, for the locks NetworkManager's header takes. Queues
+ * only exist as a type: nothing on the host posts to the network task. */
+typedef void *SemaphoreHandle_t;
+typedef void *QueueHandle_t;
+typedef int BaseType_t;
+#define pdFALSE 0
+#define pdTRUE 1
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex();
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t m, TickType_t wait);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t m);
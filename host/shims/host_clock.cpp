@@ -0,0 +1,39 @@
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+static std::atomic<bool> s_virtual{false};
+static std::atomic<uint64_t> s_virtualUs{0};
+static const std::chrono::steady_clock::time_point s_start =
+    std::chrono::steady_clock::now();
+
+void host_clock_set(uint64_t us) {
+  s_virtualUs.store(us);
+  s_virtual.store(true);
+}
+
+void host_clock_advance(uint64_t us) { s_virtualUs.fetch_add(us); }
+
+void host_clock_real() { s_virtual.store(false); }
+
+bool host_clock_virtual() { return s_virtual.load(); }
+
+uint64_t host_clock_us() {
+  if (s_virtual.load())
+    return s_virtualUs.load();
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - s_start)
+      .count();
+}
+
+uint32_t millis() { return (uint32_t)(host_clock_us() / 1000); }
+
+uint32_t micros() { return (uint32_t)host_clock_us(); }
+
+void delay(uint32_t ms) {
+  if (s_virtual.load())
+    host_clock_advance((uint64_t)ms * 1000);
+  else
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include <stdint.h>
+
+/* Time source behind millis(), micros() and delay() on the host.
+ *
+ * Runs on the monotonic clock until a test calls host_clock_set(); from
+ * then on time only moves through host_clock_advance() and delay(), so a
+ * test can step the modules through minutes of activity instantly and
+ * reproducibly. Safe to read from any thread. */
+void host_clock_set(uint64_t us);     // Switch to virtual time at `us`
+void host_clock_advance(uint64_t us); // Virtual time only
+void host_clock_real();               // Back to the monotonic clock
+bool host_clock_virtual();
+uint64_t host_clock_us();
@@ -0,0 +1,163 @@
+#include "HTTPClient.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // macOS: SIGPIPE is off per socket instead
+#endif
+
+static std::string lower(std::string s) {
+  for (char &c : s)
+    c = (c >= 'A' && c <= 'Z') ? c + 32 : c;
+  return s;
+}
+
+// Length of a complete chunked body at the start of in, or npos while
+// more is to come. The body itself is copied to out.
+static size_t dechunk(const std::string &in, std::string &out) {
+  out.clear();
+  for (size_t pos = 0;;) {
+    size_t eol = in.find("\r\n", pos);
+    if (eol == std::string::npos)
+      return std::string::npos;
+    size_t len = strtoul(in.c_str() + pos, nullptr, 16);
+    if (len == 0) {
+      size_t end = in.find("\r\n\r\n", eol); // After any trailers
+      return end == std::string::npos ? end : end + 4;
+    }
+    if (in.size() < eol + 2 + len + 2)
+      return std::string::npos;
+    out.append(in, eol + 2, len);
+    pos = eol + 2 + len + 2;
+  }
+}
+
+static void socket_timeout(int fd, uint16_t ms) {
+  timeval tv = {ms / 1000, (ms % 1000) * 1000};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+static int open_socket(const std::string &addr, uint16_t port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    return -1;
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_NOSIGPIPE
+  setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+  sockaddr_in sa = {};
+  sa.sin_family = AF_INET;
+  sa.sin_port = htons(port);
+  inet_pton(AF_INET, addr.c_str(), &sa.sin_addr);
+  if (connect(fd, (sockaddr *)&sa, sizeof(sa)) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// One request, on the client's kept-alive socket or a new one, with the
+// request's timeout on every read as the ESP32 client has. The response is
+// read up to its Content-Length or last chunk, so the socket can carry the
+// next request; only a response without either is read to the close.
+static void forward(const std::string &addr, uint16_t port,
+                    const FakeHttpRequest &req, FakeHttpResponse &res) {
+  WiFiClient &client = *req.client;
+  res.keepAlive = false;
+  if (!req.reused || client.fd() < 0) {
+    client.stop();
+    int fd = open_socket(addr, port);
+    if (fd < 0) {
+      res.code = HTTPC_ERROR_CONNECTION_REFUSED;
+      return;
+    }
+    client.attach(fd);
+  }
+  int fd = client.fd();
+  socket_timeout(fd, req.timeoutMs);
+
+  std::string out = std::string("GET ") + req.uri.c_str() +
+                    " HTTP/1.1\r\nHost: " + req.host.c_str() +
+                    (req.reuse ? "\r\nConnection: keep-alive\r\n\r\n"
+                               : "\r\nConnection: close\r\n\r\n");
+  if (send(fd, out.data(), out.size(), MSG_NOSIGNAL) != (ssize_t)out.size()) {
+    res.code = HTTPC_ERROR_SEND_HEADER_FAILED;
+    return;
+  }
+
+  std::string in, headers, body;
+  size_t head = std::string::npos;
+  size_t length = std::string::npos; // Content-Length
+  bool chunked = false, framed = false;
+  char buf[4096];
+  ssize_t n = 1;
+  for (;;) {
+    if (head == std::string::npos && (head = in.find("\r\n\r\n")) !=
+                                         std::string::npos) {
+      headers = lower(in.substr(0, head));
+      size_t cl = headers.find("content-length:");
+      if (cl != std::string::npos)
+        length = strtoul(headers.c_str() + cl + 15, nullptr, 10);
+      chunked = headers.find("transfer-encoding: chunked") != std::string::npos;
+    }
+    if (head != std::string::npos) {
+      if (chunked) {
+        framed = dechunk(in.substr(head + 4), body) != std::string::npos;
+      } else if (length != std::string::npos &&
+                 in.size() >= head + 4 + length) {
+        body = in.substr(head + 4, length);
+        framed = true;
+      }
+    }
+    if (framed || n <= 0)
+      break;
+    if ((n = recv(fd, buf, sizeof(buf), 0)) > 0)
+      in.append(buf, n);
+  }
+  bool timedOut = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+
+  int code = 0;
+  if (head == std::string::npos ||
+      sscanf(in.c_str(), "HTTP/1.%*d %d", &code) != 1 || timedOut ||
+      (!framed && (chunked || length != std::string::npos))) {
+    // Nothing, or not all of it, before the server closed or timed out
+    res.code = timedOut ? HTTPC_ERROR_READ_TIMEOUT
+                        : HTTPC_ERROR_CONNECTION_LOST;
+    return;
+  }
+  if (!framed)
+    body = in.substr(head + 4); // Read to the close
+  res.chunked = chunked;
+  res.code = code;
+  res.body = body.c_str();
+  res.keepAlive = framed && in.compare(0, 8, "HTTP/1.1") == 0 &&
+                  headers.find("connection: close") == std::string::npos;
+}
+
+void WiFiClient::attach(int fd) {
+  stop();
+  _fd = fd;
+}
+
+void WiFiClient::stop() {
+  _open = false;
+  if (_fd >= 0)
+    close(_fd);
+  _fd = -1;
+}
+
+void fake_http_forward(const char *addr, uint16_t port) {
+  std::string a(addr);
+  fake_http_set_handler(
+      [a, port](const FakeHttpRequest &req, FakeHttpResponse &res) {
+        forward(a, port, req, res);
+      });
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <stdint.h>
+
+/* The slice of lwIP's DNS API that HostResolver uses. Lookups are answered
+ * by a scripted resolver, see fake_dns.h. */
+typedef int8_t err_t;
+#define ERR_OK 0
+#define ERR_INPROGRESS -5
+#define ERR_ARG -16
+
+#define IPADDR_TYPE_V4 0
+#define IPADDR_TYPE_V6 6
+
+typedef struct {
+  uint32_t addr; // Network byte order
+} ip4_addr_t;
+
+typedef struct {
+  struct {
+    ip4_addr_t ip4;
+  } u_addr;
+  uint8_t type;
+} ip_addr_t;
+
+#define IP_IS_V4(ipaddr) ((ipaddr)->type == IPADDR_TYPE_V4)
+#define ip_2_ip4(ipaddr) (&((ipaddr)->u_addr.ip4))
+#define ip4_addr_get_u32(src) ((src)->addr)
+
+typedef void (*dns_found_callback)(const char *name, const ip_addr_t *ipaddr,
+                                   void *callback_arg);
+
+err_t dns_gethostbyname(const char *hostname, ip_addr_t *addr,
+                        dns_found_callback found, void *callback_arg);
@@ -0,0 +1,46 @@
+/* LVGL configuration for the host simulator (ui_sim). Mirrors what the
+ * firmware sets through platformio.ini build_flags; everything else is
+ * LVGL's default. The device's own lv_conf.h is not part of this
+ * repository, so set LV_MEM_SIZE to match it before comparing heap
+ * figures with the panel. */
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#include <stdint.h>
+
+#define LV_COLOR_DEPTH 16
+#define LV_COLOR_16_SWAP 0 // Byte order only matters on the SPI bus
+
+#define LV_MEM_CUSTOM 0
+#ifndef LV_MEM_SIZE
+#define LV_MEM_SIZE (96U * 1024U)
+#endif
+
+#define LV_DISP_DEF_REFR_PERIOD 30
+#define LV_INDEV_DEF_READ_PERIOD 30
+
+/* LVGL reads the simulator's virtual clock, as it reads millis() on the
+ * device (LV_TICK_CUSTOM=1) */
+#define LV_TICK_CUSTOM 1
+#define LV_TICK_CUSTOM_INCLUDE "sim_tick.h"
+#define LV_TICK_CUSTOM_SYS_TIME_EXPR (sim_tick_ms())
+
+#define LV_SHADOW_CACHE_SIZE 40
+#define LV_USE_SNAPSHOT 1
+
+#define LV_FONT_MONTSERRAT_14 1
+#define LV_FONT_MONTSERRAT_16 1
+#define LV_FONT_MONTSERRAT_20 1
+#define LV_FONT_MONTSERRAT_24 1
+#define LV_FONT_MONTSERRAT_28 1
+#define LV_TXT_ENC LV_TXT_ENC_UTF8
+
+#define LV_USE_LOG 1
+#define LV_LOG_LEVEL LV_LOG_LEVEL_WARN
+#define LV_LOG_PRINTF 1
+
+/* Fail the run instead of spinning in LVGL's default while(1) */
+#define LV_ASSERT_HANDLER_INCLUDE <stdlib.h>
+#define LV_ASSERT_HANDLER abort();
+
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+#include <lvgl.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Headless UI simulator: the firmware's src/ui on LVGL 8.3 with an
+ * in-memory 480x320 RGB565 display, a DataManager fed by a script instead
+ * of the network task, and scripted touches. Time is virtual, so a script
+ * draws the same frames on every run; render times are real. */
+
+#define SIM_WIDTH 480
+#define SIM_HEIGHT 320
+#define SIM_TICK_MS 5 // Virtual time per UI loop pass
+
+/* Display and touch (sim_display.cpp) */
+void sim_display_init(FILE *csv); // Per-frame CSV rows to csv, if not NULL
+void sim_touch(bool pressed, int16_t x, int16_t y);
+void sim_run(uint32_t ms); // Loop passes for ms of virtual time
+uint32_t sim_frames();     // Frames drawn so far
+bool sim_dump_png(const char *path); // The framebuffer as it is now
+
+/* Report sections: frames are summed per section, as named by the script */
+void sim_mark(const char *name);
+void sim_report(FILE *out);
+
+/* Scripts (sim_script.cpp) */
+void sim_script_init(); // Start from the model DataManager shows
+bool sim_script_run(const char *path, const char *outDir);
@@ -0,0 +1,50 @@
+#include "network/network_manager.h"
+
+/* DataManager without the network task. The model, the filament catalog
+ * and the heater history come from the script through the UI_BENCHMARK
+ * hooks in network_manager.h; what the UI asks of the printer is logged
+ * instead of sent. Only the members the UI calls are defined here. */
+NetworkManager DataManager;
+
+void NetworkManager::init(TaskHandle_t uiTask) {
+  _uiTask = uiTask;
+  _lock = xSemaphoreCreateRecursiveMutex();
+  strlcpy(_view.printerName, "PanelDue SC01+ v" FIRMWARE_VERSION,
+          sizeof(_view.printerName));
+  _viewSeq++;
+}
+
+void NetworkManager::log(const char *msg) { Serial.printf("SIM: %s\n", msg); }
+
+uint32_t NetworkManager::sendGCode(const char *gcode) {
+  Serial.printf("SIM: G-code %s\n", gcode);
+  return ++_requestCount;
+}
+
+void NetworkManager::connectWiFi(const char *ssid, const char *password) {
+  {
+    NetLock lock(_lock);
+    _ssid = ssid;
+    _password = password;
+  }
+  Serial.printf("SIM: connect to WiFi %s\n", ssid);
+}
+
+void NetworkManager::setPrinterIP(const char *ip) {
+  {
+    NetLock lock(_lock);
+    _printerIP = ip;
+  }
+  Serial.printf("SIM: printer address %s\n", ip);
+}
+
+void NetworkManager::requestPoll() { log("poll requested"); }
+
+void NetworkManager::fetchFilamentList() { log("filament list requested"); }
+
+void NetworkManager::setLaneFilament(int unit, int lane, String filamentName) {
+  char buf[256];
+  snprintf(buf, sizeof(buf), "set global.AFC_lanes[%d][%d][4][0] = \"%s\"",
+           unit, lane, filamentName.c_str());
+  sendGCode(buf);
+}
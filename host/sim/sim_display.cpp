@@ -0,0 +1,275 @@
+#include "input/touch_input.h"
+#include "network/network_manager.h"
+#include "sim.h"
+#include "sim_tick.h"
+#include "ui/ui.h"
+#include <time.h>
+#include <string>
+#include <vector>
+
+/* Display driver: LVGL renders into two bands of DISP_BUF_LINES rows, as on
+ * the panel, and each flush is copied into a full-screen framebuffer that
+ * is ready again at once (no DMA to wait for). */
+#ifndef DISP_BUF_LINES
+#define DISP_BUF_LINES 40
+#endif
+
+static lv_color_t s_fb[SIM_WIDTH * SIM_HEIGHT];
+static lv_color_t s_buf[2][SIM_WIDTH * DISP_BUF_LINES];
+static lv_disp_draw_buf_t s_draw_buf;
+
+static FILE *s_csv = NULL;
+static uint32_t s_frames = 0;
+
+// Current frame, filled by the driver callbacks
+static uint32_t s_flushes = 0;
+static uint32_t s_px = 0;
+static uint64_t s_update_us = 0; // ui_update_status() since the last frame
+
+struct SimSection {
+  std::string name;
+  uint32_t frames = 0;
+  uint64_t renderUs = 0;
+  uint32_t maxRenderUs = 0;
+  uint64_t px = 0;
+  uint32_t maxPx = 0;
+  uint32_t maxMemUsed = 0;
+  uint8_t maxFrag = 0;
+};
+static std::vector<SimSection> s_sections;
+
+uint32_t sim_tick_ms(void) { return millis(); }
+
+// Render time is measured on the real clock; millis() is virtual
+static uint64_t real_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void sim_flush(lv_disp_drv_t *disp, const lv_area_t *area,
+                      lv_color_t *color_p) {
+  int32_t w = area->x2 - area->x1 + 1;
+  for (int32_t y = area->y1; y <= area->y2; y++) {
+    memcpy(&s_fb[y * SIM_WIDTH + area->x1], color_p, w * sizeof(lv_color_t));
+    color_p += w;
+  }
+  s_flushes++;
+  lv_disp_flush_ready(disp);
+}
+
+/* Called by LVGL after each refresh with the number of pixels redrawn */
+static void sim_monitor(lv_disp_drv_t *disp, uint32_t time, uint32_t px) {
+  s_px += px;
+  ui_observe_record_redraw(time, px);
+  ui_modal_record_redraw();
+}
+
+/* Touch: the last scripted state, read through LVGL like the panel */
+static TouchPoint s_touch;
+static TouchCalibration s_calibration;
+
+void sim_touch(bool pressed, int16_t x, int16_t y) {
+  s_touch.pressed = pressed;
+  if (pressed) {
+    s_touch.x = x;
+    s_touch.y = y;
+    s_touch.rawX = x;
+    s_touch.rawY = y;
+  }
+}
+
+static void sim_touch_read(lv_indev_drv_t *drv, lv_indev_data_t *data) {
+  data->state = s_touch.pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+  data->point.x = s_touch.x;
+  data->point.y = s_touch.y;
+}
+
+/* The calibration screen's view of the touch driver. Scripted points are
+ * already in screen coordinates, so they also stand in for raw ones. */
+TouchPoint touch_input_last() { return s_touch; }
+void touch_input_set_raw(bool raw) {}
+void touch_input_set_calibration(const TouchCalibration &cal, bool save) {
+  s_calibration = cal;
+}
+const TouchCalibration &touch_input_calibration() { return s_calibration; }
+
+void sim_display_init(FILE *csv) {
+  s_csv = csv;
+  lv_disp_draw_buf_init(&s_draw_buf, s_buf[0], s_buf[1],
+                        SIM_WIDTH * DISP_BUF_LINES);
+
+  static lv_disp_drv_t disp_drv;
+  lv_disp_drv_init(&disp_drv);
+  disp_drv.hor_res = SIM_WIDTH;
+  disp_drv.ver_res = SIM_HEIGHT;
+  disp_drv.flush_cb = sim_flush;
+  disp_drv.monitor_cb = sim_monitor;
+  disp_drv.draw_buf = &s_draw_buf;
+  lv_disp_drv_register(&disp_drv);
+
+  static lv_indev_drv_t indev_drv;
+  lv_indev_drv_init(&indev_drv);
+  indev_drv.type = LV_INDEV_TYPE_POINTER;
+  indev_drv.read_cb = sim_touch_read;
+  lv_indev_drv_register(&indev_drv);
+
+  if (s_csv)
+    fprintf(s_csv, "frame,ms,section,update us,render us,px,flushes,"
+                   "lvgl used,lvgl frag %%\n");
+  sim_mark("boot");
+}
+
+static void record_frame(uint32_t renderUs) {
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  uint32_t used = mon.total_size - mon.free_size;
+
+  SimSection &s = s_sections.back();
+  s.frames++;
+  s.renderUs += renderUs;
+  s.px += s_px;
+  if (renderUs > s.maxRenderUs)
+    s.maxRenderUs = renderUs;
+  if (s_px > s.maxPx)
+    s.maxPx = s_px;
+  if (used > s.maxMemUsed)
+    s.maxMemUsed = used;
+  if (mon.frag_pct > s.maxFrag)
+    s.maxFrag = mon.frag_pct;
+
+  if (s_csv)
+    fprintf(s_csv, "%u,%u,%s,%u,%u,%u,%u,%u,%u\n", (unsigned)s_frames,
+            (unsigned)millis(), s.name.c_str(), (unsigned)s_update_us,
+            (unsigned)renderUs, (unsigned)s_px, (unsigned)s_flushes,
+            (unsigned)used, (unsigned)mon.frag_pct);
+  s_frames++;
+  s_update_us = 0;
+}
+
+/* One loop pass per SIM_TICK_MS, as loop() on the panel: sample history
+ * the way the network task would, deliver model changes, run LVGL */
+void sim_run(uint32_t ms) {
+  for (uint32_t t = 0; t < ms; t += SIM_TICK_MS) {
+    host_clock_advance(SIM_TICK_MS * 1000);
+    DataManager.benchSampleHistory(millis());
+
+    uint64_t start = real_us();
+    ui_update_status();
+    uint64_t updated = real_us();
+    s_update_us += updated - start;
+
+    s_flushes = 0;
+    s_px = 0;
+    lv_timer_handler();
+    if (s_flushes)
+      record_frame((uint32_t)(real_us() - updated));
+  }
+}
+
+uint32_t sim_frames() { return s_frames; }
+
+void sim_mark(const char *name) {
+  if (!s_sections.empty() && s_sections.back().frames == 0)
+    s_sections.pop_back(); // Nothing drawn under the previous name
+  s_sections.push_back(SimSection());
+  s_sections.back().name = name;
+}
+
+void sim_report(FILE *out) {
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  fprintf(out, "%-24s %6s %9s %9s %8s %8s %9s %5s\n", "section", "frames",
+          "avg us", "max us", "avg px", "max px", "lvgl used", "frag");
+  for (const SimSection &s : s_sections) {
+    if (!s.frames)
+      continue;
+    fprintf(out, "%-24s %6u %9u %9u %8u %8u %9u %4u%%\n", s.name.c_str(),
+            (unsigned)s.frames, (unsigned)(s.renderUs / s.frames),
+            (unsigned)s.maxRenderUs, (unsigned)(s.px / s.frames),
+            (unsigned)s.maxPx, (unsigned)s.maxMemUsed, (unsigned)s.maxFrag);
+  }
+  fprintf(out, "LVGL heap: %u/%u used, peak %u, largest free %u\n",
+          (unsigned)(mon.total_size - mon.free_size),
+          (unsigned)mon.total_size, (unsigned)mon.max_used,
+          (unsigned)mon.free_biggest_size);
+}
+
+/* PNG with stored (uncompressed) deflate blocks: larger than a real
+ * encoder's output, but it needs neither zlib nor libpng */
+static uint32_t crc32(uint32_t crc, const uint8_t *p, size_t n) {
+  crc = ~crc;
+  while (n--) {
+    crc ^= *p++;
+    for (int k = 0; k < 8; k++)
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+  }
+  return ~crc;
+}
+
+static void put32(std::vector<uint8_t> &v, uint32_t x) {
+  v.push_back(x >> 24);
+  v.push_back(x >> 16);
+  v.push_back(x >> 8);
+  v.push_back(x);
+}
+
+static void png_chunk(FILE *f, const char *type,
+                      const std::vector<uint8_t> &data) {
+  std::vector<uint8_t> buf;
+  put32(buf, data.size());
+  buf.insert(buf.end(), type, type + 4);
+  buf.insert(buf.end(), data.begin(), data.end());
+  put32(buf, crc32(0, &buf[4], buf.size() - 4));
+  fwrite(buf.data(), 1, buf.size(), f);
+}
+
+bool sim_dump_png(const char *path) {
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+  static const uint8_t kSignature[] = {0x89, 'P',  'N',  'G',
+                                       '\r', '\n', 0x1A, '\n'};
+  fwrite(kSignature, 1, sizeof(kSignature), f);
+
+  std::vector<uint8_t> ihdr;
+  put32(ihdr, SIM_WIDTH);
+  put32(ihdr, SIM_HEIGHT);
+  const uint8_t kFormat[] = {8, 2, 0, 0, 0}; // 8-bit RGB, no interlace
+  ihdr.insert(ihdr.end(), kFormat, kFormat + sizeof(kFormat));
+  png_chunk(f, "IHDR", ihdr);
+
+  // Rows of filter type 0 followed by RGB
+  std::vector<uint8_t> raw;
+  raw.reserve(SIM_HEIGHT * (1 + SIM_WIDTH * 3));
+  for (int y = 0; y < SIM_HEIGHT; y++) {
+    raw.push_back(0);
+    for (int x = 0; x < SIM_WIDTH; x++) {
+      uint32_t c = lv_color_to32(s_fb[y * SIM_WIDTH + x]);
+      raw.push_back(c >> 16);
+      raw.push_back(c >> 8);
+      raw.push_back(c);
+    }
+  }
+
+  std::vector<uint8_t> z = {0x78, 0x01};
+  uint32_t a = 1, b = 0; // Adler-32
+  for (size_t pos = 0; pos < raw.size();) {
+    size_t n = std::min<size_t>(raw.size() - pos, 65535);
+    z.push_back(pos + n == raw.size()); // BFINAL, BTYPE 00
+    z.push_back(n);
+    z.push_back(n >> 8);
+    z.push_back(~n);
+    z.push_back(~n >> 8);
+    for (size_t i = pos; i < pos + n; i++) {
+      a = (a + raw[i]) % 65521;
+      b = (b + a) % 65521;
+    }
+    z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + n);
+    pos += n;
+  }
+  put32(z, (b << 16) | a);
+  png_chunk(f, "IDAT", z);
+  png_chunk(f, "IEND", std::vector<uint8_t>());
+  return fclose(f) == 0;
+}
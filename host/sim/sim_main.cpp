@@ -0,0 +1,74 @@
+// ui_sim: the firmware's UI on the host, driven by scripts (see
+// sim_script.cpp for the commands).
+//
+//   ui_sim [--out <dir>] [--csv <frames.csv>] script.sim...
+//
+// PNG dumps go to --out (default: the working directory). The report sums
+// render time, redrawn area and LVGL heap per script section; --csv adds
+// one row per frame.
+#include "network/network_manager.h"
+#include "sim.h"
+#include "ui/ui.h"
+#include <time.h>
+
+#ifdef __GLIBC__
+// The panel shows uptime until NTP has synced. Keep the simulator there
+// too, on the virtual clock, so the clock label and every frame with it
+// are the same on each run.
+extern "C" time_t time(time_t *t) __THROW {
+  if (t)
+    *t = 0;
+  return 0;
+}
+#endif
+
+static int usage() {
+  fprintf(stderr,
+          "usage: ui_sim [--out <dir>] [--csv <frames.csv>] script.sim...\n");
+  return 2;
+}
+
+int main(int argc, char **argv) {
+  const char *outDir = "";
+  FILE *csv = NULL;
+  int first = 1;
+  for (; first < argc && argv[first][0] == '-'; first++) {
+    if (first + 1 >= argc)
+      return usage();
+    if (strcmp(argv[first], "--out") == 0) {
+      outDir = argv[++first];
+    } else if (strcmp(argv[first], "--csv") == 0) {
+      csv = fopen(argv[++first], "w");
+      if (!csv) {
+        fprintf(stderr, "%s: cannot write\n", argv[first]);
+        return 1;
+      }
+    } else {
+      return usage();
+    }
+  }
+  if (first == argc)
+    return usage();
+
+  host_clock_set(0); // Boot
+  lv_init();
+  sim_display_init(csv);
+  DataManager.init(NULL);
+  ui_init();
+  sim_run(100); // First frame
+  sim_script_init();
+
+  bool ok = true;
+  for (int i = first; ok && i < argc; i++) {
+    char name[64];
+    const char *base = strrchr(argv[i], '/');
+    snprintf(name, sizeof(name), "%s", base ? base + 1 : argv[i]);
+    sim_mark(name);
+    ok = sim_script_run(argv[i], outDir);
+  }
+
+  sim_report(stdout);
+  if (csv)
+    fclose(csv);
+  return ok ? 0 : 1;
+}
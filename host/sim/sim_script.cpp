@@ -0,0 +1,318 @@
+#include "network/model_decoder.h"
+#include "network/network_manager.h"
+#include "sim.h"
+#include "ui/ui.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* Simulator scripts: one command per line, '#' starts a comment.
+ *
+ *   wait <ms>                    Run the UI for ms of virtual time
+ *   mark <name>                  Sum the frames that follow under name
+ *   dump <file.png>              Write the screen as it is now
+ *   screen <name>                dashboard, settings, calibration,
+ *                                overview or temps, as its button would
+ *   tap <x> <y>                  Press and release at a point
+ *   press <x> <y> / release      Hold, for long presses and drags
+ *   drag <x1> <y1> <x2> <y2> <ms>
+ *   close                        Hide any open modal
+ *   bench                        Run ui_bench_run(), the on-device benchmark
+ *   repeat <n> ... end           Repeat the lines between; $i is the pass
+ *
+ * Model changes, each published to the UI like a network snapshot:
+ *
+ *   rr <key> <file.json>         An rr_model response ("d99fn" for the
+ *                                live query), path relative to the script
+ *   status <rrf status>          processing, idle, paused, ...
+ *   offline | disconnected       Connection states of the panel
+ *   name <printer name>
+ *   wifi <ssid> <a.b.c.d>
+ *   heater <i> <current> <active>
+ *   progress <percent>
+ *   units <count> [lanes per unit ...]
+ *   unit <u>                     Active AFC unit, as the unit button sets it
+ *   lane <u> <l> loaded <0|1> | led <-1..6> | tool <t> | filament <name>
+ *   filaments <n>                A synthetic catalog of n names */
+
+static PrinterModel s_model; // What the script has published so far
+static std::string s_dir;    // Script directory, for rr payloads
+static std::string s_out;    // Where dump writes
+
+static void publish() { DataManager.benchSetModel(s_model); }
+
+static void script_error(const char *path, int line, const char *what) {
+  fprintf(stderr, "%s:%d: %s\n", path, line, what);
+}
+
+static void bench_wait_flush() {} // Flushes complete inside the call
+
+static void run_bench() {
+  // ui_bench_run() times itself with micros(): run it on the real clock,
+  // then carry on in virtual time from where it left off
+  uint64_t now = host_clock_us();
+  host_clock_real();
+  uint64_t start = host_clock_us();
+  ui_bench_run(bench_wait_flush);
+  host_clock_set(now + (host_clock_us() - start));
+}
+
+static void tap(int x, int y) {
+  sim_touch(true, x, y);
+  sim_run(2 * LV_INDEV_DEF_READ_PERIOD);
+  sim_touch(false, x, y);
+  sim_run(2 * LV_INDEV_DEF_READ_PERIOD);
+}
+
+static void drag(int x1, int y1, int x2, int y2, int ms) {
+  int steps = ms > SIM_TICK_MS ? ms / SIM_TICK_MS : 1;
+  for (int i = 0; i <= steps; i++) {
+    sim_touch(true, x1 + (x2 - x1) * i / steps, y1 + (y2 - y1) * i / steps);
+    sim_run(SIM_TICK_MS);
+  }
+  sim_touch(false, x2, y2);
+  sim_run(2 * LV_INDEV_DEF_READ_PERIOD);
+}
+
+static bool load_rr(const std::string &key, const std::string &file) {
+  std::ifstream in(file[0] == '/' ? file : s_dir + file);
+  if (!in)
+    return false;
+  std::stringstream body;
+  body << in.rdbuf();
+  DynamicJsonDocument doc(16384);
+  if (deserializeJson(doc, body.str()))
+    return false;
+  if (key != "d99fn") {
+    decodeModelKey(s_model, key.c_str(), doc["result"], false);
+  } else {
+    for (JsonPairConst kv : doc["result"].as<JsonObjectConst>()) {
+      if (strcmp(kv.key().c_str(), "seqs") != 0)
+        decodeModelKey(s_model, kv.key().c_str(), kv.value(), false);
+    }
+  }
+  return true;
+}
+
+static void load_filaments(int n) {
+  static const char *const kBrands[] = {"Prusament", "Polymaker", "eSun",
+                                        "Sunlu",     "Elegoo",    "Bambu"};
+  static const char *const kTypes[] = {"PLA", "PETG", "ABS", "ASA", "TPU"};
+  FilamentCatalog catalog;
+  for (int i = 0; i < n; i++) {
+    char name[FC_MAX_NAME];
+    int len = snprintf(name, sizeof(name), "%s %s %04d", kBrands[i % 6],
+                       kTypes[i / 6 % 5], i);
+    catalog.add(name, len);
+  }
+  catalog.finish();
+  DataManager.benchSetFilaments(catalog);
+}
+
+static bool set_lane(const std::vector<std::string> &a) {
+  int unit = atoi(a[1].c_str()), l = atoi(a[2].c_str());
+  if (unit < 0 || unit >= PM_MAX_UNITS || l < 0 || l >= PM_MAX_UNIT_LANES)
+    return false;
+  LaneInfo &lane = s_model.lanes[PrinterModel::laneIndex(unit, l)];
+  const std::string &field = a[3];
+  if (field == "loaded")
+    lane.loaded = atoi(a[4].c_str()) != 0;
+  else if (field == "led")
+    lane.led = (LedColor)atoi(a[4].c_str());
+  else if (field == "tool")
+    lane.tool = atoi(a[4].c_str());
+  else if (field == "filament")
+    strlcpy(lane.filament, a[4].c_str(), sizeof(lane.filament));
+  else
+    return false;
+  return true;
+}
+
+static bool load_screen(const std::string &name) {
+  static const char *const kNames[UI_SCREEN_COUNT] = {
+      "dashboard", "settings", "calibration", "overview", "temps"};
+  for (int i = 0; i < UI_SCREEN_COUNT; i++) {
+    if (name == kNames[i]) {
+      ui_screen_load((UiScreen)i);
+      return true;
+    }
+  }
+  return false;
+}
+
+// Split a line into words. A printer or filament name takes the rest of
+// the line, so it may contain spaces.
+static std::vector<std::string> split(const std::string &line) {
+  std::vector<std::string> words;
+  std::istringstream in(line);
+  std::string w;
+  while (in >> w) {
+    if (w[0] == '#')
+      break;
+    bool rest = (words.size() == 1 && words[0] == "name") ||
+                (words.size() == 4 && words[0] == "lane" &&
+                 words[3] == "filament");
+    if (rest) {
+      std::string tail;
+      std::getline(in, tail);
+      w += tail;
+    }
+    words.push_back(w);
+  }
+  return words;
+}
+
+// One command. Returns false with `error` set when the line is not valid.
+static bool run_command(std::vector<std::string> &a, const char *&error) {
+  const std::string &cmd = a[0];
+  size_t n = a.size();
+  error = "wrong number of arguments";
+  if (cmd == "wait" && n == 2) {
+    sim_run(atoi(a[1].c_str()));
+  } else if (cmd == "mark" && n == 2) {
+    sim_mark(a[1].c_str());
+  } else if (cmd == "dump" && n == 2) {
+    error = "cannot write the PNG";
+    return sim_dump_png((a[1][0] == '/' ? a[1] : s_out + a[1]).c_str());
+  } else if (cmd == "screen" && n == 2) {
+    error = "unknown screen";
+    return load_screen(a[1]);
+  } else if (cmd == "tap" && n == 3) {
+    tap(atoi(a[1].c_str()), atoi(a[2].c_str()));
+  } else if (cmd == "press" && n == 3) {
+    sim_touch(true, atoi(a[1].c_str()), atoi(a[2].c_str()));
+  } else if (cmd == "release" && n == 1) {
+    sim_touch(false, 0, 0);
+  } else if (cmd == "drag" && n == 6) {
+    drag(atoi(a[1].c_str()), atoi(a[2].c_str()), atoi(a[3].c_str()),
+         atoi(a[4].c_str()), atoi(a[5].c_str()));
+  } else if (cmd == "close" && n == 1) {
+    ui_modal_hide_all();
+  } else if (cmd == "bench" && n == 1) {
+    run_bench();
+  } else if (cmd == "filaments" && n == 2) {
+    load_filaments(atoi(a[1].c_str()));
+  } else if (cmd == "unit" && n == 2) {
+    DataManager.setActiveAFCUnit(atoi(a[1].c_str()));
+  } else {
+    // Everything else changes the model
+    if (cmd == "rr" && n == 3) {
+      error = "cannot read or parse the response";
+      if (!load_rr(a[1], a[2]))
+        return false;
+    } else if (cmd == "status" && n == 2) {
+      s_model.status = parsePrinterStatus(a[1].c_str());
+    } else if (cmd == "offline" && n == 1) {
+      s_model.status = PS_OFFLINE;
+    } else if (cmd == "disconnected" && n == 1) {
+      s_model.status = PS_DISCONNECTED;
+    } else if (cmd == "name" && n == 2) {
+      strlcpy(s_model.printerName, a[1].c_str(), sizeof(s_model.printerName));
+    } else if (cmd == "wifi" && n == 3) {
+      IPAddress ip;
+      error = "bad IP address";
+      if (!ip.fromString(a[2].c_str()))
+        return false;
+      s_model.wifiConnected = true;
+      s_model.localIP = ip;
+      strlcpy(s_model.ssid, a[1].c_str(), sizeof(s_model.ssid));
+    } else if (cmd == "heater" && n == 4) {
+      int h = atoi(a[1].c_str());
+      error = "no such heater";
+      if (h < 0 || h >= PM_MAX_HEATERS)
+        return false;
+      s_model.heaters[h].current = atof(a[2].c_str());
+      s_model.heaters[h].active = atof(a[3].c_str());
+      if (s_model.heaterCount <= h)
+        s_model.heaterCount = h + 1;
+    } else if (cmd == "progress" && n == 2) {
+      s_model.progress = atof(a[1].c_str()) / 100;
+    } else if (cmd == "units" && n >= 2 && n <= 2 + PM_MAX_UNITS) {
+      int units = atoi(a[1].c_str());
+      error = "bad unit count";
+      if (units < 1 || units > PM_MAX_UNITS)
+        return false;
+      s_model.unitCount = units;
+      for (size_t u = 2; u < n; u++)
+        s_model.unitLanes[u - 2] = atoi(a[u].c_str());
+    } else if (cmd == "lane" && n == 5) {
+      error = "bad lane";
+      if (!set_lane(a))
+        return false;
+    } else {
+      error = "unknown command";
+      return false;
+    }
+    publish();
+  }
+  return true;
+}
+
+void sim_script_init() { s_model = DataManager.getModel(); }
+
+bool sim_script_run(const char *path, const char *outDir) {
+  std::ifstream in(path);
+  if (!in) {
+    fprintf(stderr, "%s: cannot open\n", path);
+    return false;
+  }
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(in, line);)
+    lines.push_back(line);
+  const char *slash = strrchr(path, '/');
+  s_dir = slash ? std::string(path, slash + 1 - path) : "";
+  s_out = *outDir ? std::string(outDir) + "/" : "";
+
+  struct Loop {
+    size_t body; // First line after repeat
+    int count, pass;
+  };
+  std::vector<Loop> loops;
+  for (size_t pc = 0; pc < lines.size(); pc++) {
+    std::string line = lines[pc];
+    if (!loops.empty()) {
+      std::string pass = std::to_string(loops.back().pass);
+      for (size_t p; (p = line.find("$i")) != std::string::npos;)
+        line.replace(p, 2, pass);
+    }
+    std::vector<std::string> a = split(line);
+    if (a.empty())
+      continue;
+    int lineNo = (int)pc + 1;
+    if (a[0] == "repeat" && a.size() == 2) {
+      loops.push_back({pc + 1, atoi(a[1].c_str()), 0});
+      if (loops.back().count > 0)
+        continue;
+      // Zero passes: skip to the matching end
+      for (int depth = 1; depth && ++pc < lines.size();) {
+        std::vector<std::string> w = split(lines[pc]);
+        if (!w.empty())
+          depth += (w[0] == "repeat") - (w[0] == "end");
+      }
+      loops.pop_back();
+      continue;
+    }
+    if (a[0] == "end" && a.size() == 1) {
+      if (loops.empty()) {
+        script_error(path, lineNo, "end without repeat");
+        return false;
+      }
+      if (++loops.back().pass < loops.back().count)
+        pc = loops.back().body - 1;
+      else
+        loops.pop_back();
+      continue;
+    }
+    const char *error;
+    if (!run_command(a, error)) {
+      script_error(path, lineNo, error);
+      return false;
+    }
+  }
+  if (!loops.empty()) {
+    script_error(path, (int)lines.size(), "repeat without end");
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <stdint.h>
+
+/* LVGL's time source in the simulator: millis() on the host clock. LVGL is
+ * C, so it cannot include the Arduino shim. */
+#ifdef __cplusplus
+extern "C" {
+#endif
+uint32_t sim_tick_ms(void);
+#ifdef __cplusplus
+}
+#endif
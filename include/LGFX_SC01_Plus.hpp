@@ -70,7 +70,7 @@ public:
       cfg.x_max = 320;
       cfg.y_min = 0;
       cfg.y_max = 480;
-      cfg.pin_int = -1; // Force Polling
+      cfg.pin_int = -1; // GPIO7 belongs to src/input/touch_input.cpp
       cfg.bus_shared = false;
       cfg.offset_rotation = 0;
       cfg.i2c_port = 0; // Port 0 is confirmed working for raw I2C
@@ -0,0 +1,96 @@
+#include "touch_calib.h"
+#include <math.h>
+
+#define TCAL_ONE (1 << TCAL_FRAC_BITS)
+#define TCAL_MAX_ENTRY ((int32_t)TCAL_MAX_GAIN * TCAL_ONE)
+#define TCAL_MAX_SHIFT ((int32_t)TCAL_MAX_OFFSET * TCAL_ONE)
+
+TouchCalibration::TouchCalibration() {
+  // Measured on the first panel: dots at (20,20), (460,20), (20,300) and
+  // (460,300) read raw (305,19), (315,478), (5,39) and (27,474).
+  // x = (rawY - 19) * 440 / 459 + 20, y = (310 - rawX) * 280 / 294 + 20
+  setAffine(0, 440.0 / 459, 20 - 19 * 440.0 / 459, -280.0 / 294, 0,
+            20 + 310 * 280.0 / 294);
+}
+
+static int32_t fixed(double v) { return (int32_t)lround(v * TCAL_ONE); }
+
+void TouchCalibration::setAffine(double a, double b, double c, double d,
+                                 double e, double f) {
+  _m[0] = fixed(a);
+  _m[1] = fixed(b);
+  _m[2] = fixed(c) + TCAL_ONE / 2; // map() then rounds to nearest
+  _m[3] = fixed(d);
+  _m[4] = fixed(e);
+  _m[5] = fixed(f) + TCAL_ONE / 2;
+}
+
+bool TouchCalibration::set(const int32_t m[6]) {
+  // Bounded so that map() cannot overflow for 12-bit raw values
+  for (int i = 0; i < 6; i++) {
+    int32_t max = (i == 2 || i == 5) ? TCAL_MAX_SHIFT : TCAL_MAX_ENTRY;
+    if (m[i] > max || m[i] < -max)
+      return false;
+  }
+  for (int i = 0; i < 6; i++)
+    _m[i] = m[i];
+  _rmsError = 0;
+  return true;
+}
+
+bool TouchCalibration::solve(const TouchPair *pairs, int n) {
+  if (n < 3)
+    return false;
+
+  // Centre the readings: the offsets then drop out of the normal
+  // equations, leaving one 2x2 system shared by both screen axes
+  double mx = 0, my = 0, mX = 0, mY = 0;
+  for (int i = 0; i < n; i++) {
+    mx += pairs[i].rawX;
+    my += pairs[i].rawY;
+    mX += pairs[i].x;
+    mY += pairs[i].y;
+  }
+  mx /= n;
+  my /= n;
+  mX /= n;
+  mY /= n;
+
+  double sxx = 0, sxy = 0, syy = 0, sxX = 0, syX = 0, sxY = 0, syY = 0;
+  for (int i = 0; i < n; i++) {
+    double dx = pairs[i].rawX - mx, dy = pairs[i].rawY - my;
+    double dX = pairs[i].x - mX, dY = pairs[i].y - mY;
+    sxx += dx * dx;
+    sxy += dx * dy;
+    syy += dy * dy;
+    sxX += dx * dX;
+    syX += dy * dX;
+    sxY += dx * dY;
+    syY += dy * dY;
+  }
+  double det = sxx * syy - sxy * sxy;
+  if (fabs(det) < 1e-6 * (sxx * syy + 1)) // Points (nearly) on one line
+    return false;
+
+  double a = (sxX * syy - syX * sxy) / det;
+  double b = (syX * sxx - sxX * sxy) / det;
+  double d = (sxY * syy - syY * sxy) / det;
+  double e = (syY * sxx - sxY * sxy) / det;
+  double c = mX - a * mx - b * my;
+  double f = mY - d * mx - e * my;
+  if (fabs(a) > TCAL_MAX_GAIN || fabs(b) > TCAL_MAX_GAIN ||
+      fabs(d) > TCAL_MAX_GAIN || fabs(e) > TCAL_MAX_GAIN)
+    return false;
+  if (fabs(c) >= TCAL_MAX_OFFSET || fabs(f) >= TCAL_MAX_OFFSET)
+    return false;
+  setAffine(a, b, c, d, e, f);
+
+  double sq = 0;
+  for (int i = 0; i < n; i++) {
+    double ex = a * pairs[i].rawX + b * pairs[i].rawY + c - pairs[i].x;
+    double ey = d * pairs[i].rawX + e * pairs[i].rawY + f - pairs[i].y;
+    sq += ex * ex + ey * ey;
+  }
+  _rmsError = sqrt(sq / n);
+  return true;
+}
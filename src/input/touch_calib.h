@@ -0,0 +1,49 @@
+#pragma once
+#include <stdint.h>
+
+#define TCAL_FRAC_BITS 16 // Fixed-point fraction of the matrix entries
+#define TCAL_MAX_GAIN 2   // Reject fits scaling an axis by more than this
+#define TCAL_MAX_OFFSET 4096 // ...or shifting it by more pixels than this
+
+// A raw sensor reading and the screen point it should map to
+struct TouchPair {
+  float rawX, rawY; // Averaged raw readings
+  int16_t x, y;     // Target on screen
+};
+
+// Affine map from raw touch coordinates to the screen:
+//   x = a*rawX + b*rawY + c
+//   y = d*rawX + e*rawY + f
+// fitted by least squares to any number of pairs (three or more, not all
+// on one line) and kept as fixed-point integers, so map() is one
+// multiply-add per term and a shift, with no division. The rounding
+// offset is folded into c and f.
+//
+// Pure logic, no Arduino dependencies.
+class TouchCalibration {
+public:
+  TouchCalibration(); // The factory mapping measured on one panel
+
+  // Returns false, leaving the matrix and rmsError() unchanged, when the
+  // pairs do not determine a usable map
+  bool solve(const TouchPair *pairs, int n);
+
+  void map(uint16_t rawX, uint16_t rawY, int32_t &x, int32_t &y) const {
+    x = (_m[0] * rawX + _m[1] * rawY + _m[2]) >> TCAL_FRAC_BITS;
+    y = (_m[3] * rawX + _m[4] * rawY + _m[5]) >> TCAL_FRAC_BITS;
+  }
+
+  // Raw matrix for storage; set() rejects entries out of range
+  const int32_t *matrix() const { return _m; }
+  bool set(const int32_t m[6]);
+  void setAffine(double a, double b, double c, double d, double e,
+                 double f);
+
+  // Residual of the last successful solve() in px; 0 before any, and
+  // after set() loads a stored matrix
+  float rmsError() const { return _rmsError; }
+
+private:
+  int32_t _m[6];
+  float _rmsError = 0;
+};
@@ -0,0 +1,52 @@
+#include "touch_filter.h"
+#include <stdlib.h>
+
+// Move out towards raw; returns how far raw was from out
+int16_t TouchFilter::smooth(uint16_t &out, uint16_t raw) {
+  int16_t d = (int16_t)(raw - out);
+  if (abs(d) >= TF_SNAP)
+    out = raw;
+  else if (abs(d) > TF_DEADBAND)
+    out += d / 2;
+  return d;
+}
+
+void TouchFilter::push(const TouchSample &s) {
+  if (!s.down) {
+    if (_pressed && !_lifting) {
+      _lifting = true;
+      _liftUs = s.us;
+    }
+    return;
+  }
+
+  // A lift long enough to count, seen only now: that press ended
+  if (_lifting && s.us - _liftUs >= TF_RELEASE_US)
+    _pressed = false;
+
+  if (!_pressed) {
+    _pressed = true;
+    _pressUs = s.us;
+    _x = s.x;
+    _y = s.y;
+    _presses++;
+  } else {
+    if (_lifting)
+      _merged++;
+    int16_t dx = smooth(_x, s.x);
+    int16_t dy = smooth(_y, s.y);
+    if (abs(dx) <= TF_DEADBAND && abs(dy) <= TF_DEADBAND)
+      _held++;
+  }
+  _lifting = false;
+  _lastUs = s.us;
+}
+
+bool TouchFilter::update(uint32_t nowUs) {
+  if (_pressed && ((_lifting && nowUs - _liftUs >= TF_RELEASE_US) ||
+                   nowUs - _lastUs >= TF_STALE_US)) {
+    _pressed = false;
+    _lifting = false;
+  }
+  return _pressed;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+
+#define TF_RELEASE_US 30000 // A lift shorter than this is a dropout
+#define TF_STALE_US 250000  // Pressed with no samples this long: released
+#define TF_DEADBAND 2       // Raw units a held finger may wander unseen
+#define TF_SNAP 24          // Moves this large are taken as is
+
+// One controller report, in raw sensor coordinates
+struct TouchSample {
+  uint32_t us; // IRQ time of the report, or read time if none
+  uint16_t x, y;
+  bool down;
+};
+
+// Debounce and jitter filter between the touch controller and LVGL.
+//
+// A press is reported from its first sample, so filtering adds no latency
+// to the first touch. A lift is only reported once no contact has been
+// seen for TF_RELEASE_US, so a report dropping out mid-press does not turn
+// one tap into two. While pressed, moves within TF_DEADBAND are ignored,
+// mid-sized moves are halved (a two-tap IIR) and moves of TF_SNAP or more
+// are followed at once, so a held finger stays put and a drag does not
+// lag.
+//
+// Pure logic with caller-supplied time, no Arduino dependencies, so
+// recorded traces (TOUCH_TRACE) can be replayed through it on a host.
+class TouchFilter {
+public:
+  void push(const TouchSample &s);
+  bool update(uint32_t nowUs); // Apply timeouts; returns pressed()
+
+  bool pressed() const { return _pressed; }
+  uint16_t x() const { return _x; }
+  uint16_t y() const { return _y; }
+  uint32_t pressUs() const { return _pressUs; } // Sample that began it
+
+  uint32_t presses() const { return _presses; }
+  uint32_t merged() const { return _merged; } // Dropouts not reported
+  uint32_t held() const { return _held; }     // Samples inside the deadband
+
+private:
+  static int16_t smooth(uint16_t &out, uint16_t raw);
+
+  bool _pressed = false;
+  bool _lifting = false; // Lift seen, not yet reported
+  uint32_t _liftUs = 0;
+  uint32_t _lastUs = 0; // Last sample while pressed
+  uint32_t _pressUs = 0;
+  uint16_t _x = 0, _y = 0;
+  uint32_t _presses = 0, _merged = 0, _held = 0;
+};
@@ -0,0 +1,164 @@
+#include "touch_input.h"
+#include "perf/task_stats.h"
+#include "task_layout.h"
+#include "touch_ring.h"
+#include <Arduino.h>
+#include <Preferences.h>
+#include <Wire.h>
+
+#define TOUCH_READ_TRIES 3 // Failed reads in a row before giving up
+#define TOUCH_WIDTH 480
+#define TOUCH_HEIGHT 320
+
+static TaskHandle_t s_task = NULL;
+static TaskHandle_t s_notify = NULL; // Consumer, woken for new samples
+static volatile uint32_t s_irqUs = 0;
+static TouchRing<TouchSample, TOUCH_QUEUE_DEPTH> s_ring;
+static TouchFilter s_filter;
+static TouchStats s_stats;
+static TouchCalibration s_cal;
+static TouchPoint s_last;
+static bool s_raw = false;
+
+static void IRAM_ATTR touch_isr() {
+  s_irqUs = micros();
+  s_stats.irqs++;
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(s_task, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+
+// TD_STATUS and the first touch point, registers 0x02-0x06
+static bool read_report(TouchSample &s) {
+  Wire.beginTransmission(TOUCH_I2C_ADDR);
+  Wire.write(0x02);
+  if (Wire.endTransmission() != 0 ||
+      Wire.requestFrom(TOUCH_I2C_ADDR, 5) != 5)
+    return false;
+  uint8_t points = Wire.read() & 0x0F;
+  uint8_t xh = Wire.read();
+  uint8_t xl = Wire.read();
+  uint8_t yh = Wire.read();
+  uint8_t yl = Wire.read();
+  s.down = points > 0 && points <= 5;
+  s.x = ((xh & 0x0F) << 8) | xl;
+  s.y = ((yh & 0x0F) << 8) | yl;
+  return true;
+}
+
+static void touch_task(void *arg) {
+  for (;;) {
+    // Idle: nothing on the bus until the controller raises INT
+    uint32_t waitUs = micros();
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    task_stats_wait(AT_TOUCH, waitUs);
+    uint32_t irqUs = s_irqUs;
+    bool fresh = true; // This read answers an interrupt
+
+    int fails = 0;
+    for (;;) {
+      TouchSample s;
+      if (!read_report(s)) {
+        s_stats.errors++;
+        if (++fails >= TOUCH_READ_TRIES)
+          break; // The filter's stale timeout ends the press
+      } else {
+        fails = 0;
+        s_stats.reads++;
+        s.us = fresh ? irqUs : micros();
+        if (!s_ring.push(s))
+          s_stats.dropped++;
+        else if (s_notify)
+          xTaskNotifyGive(s_notify);
+#ifdef TOUCH_TRACE
+        Serial.printf("TRACE: %u,%u,%u,%d\n", (unsigned)s.us, s.x, s.y,
+                      s.down);
+#endif
+        if (!s.down)
+          break;
+      }
+      // Next report, or poll if the controller holds INT low instead
+      waitUs = micros();
+      fresh = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TOUCH_PERIOD_MS)) > 0;
+      task_stats_wait(AT_TOUCH, waitUs);
+      irqUs = s_irqUs;
+    }
+  }
+}
+
+static void load_calibration() {
+  Preferences prefs;
+  if (!prefs.begin("touch", true))
+    return; // Never saved: the namespace does not exist yet
+  int32_t m[6];
+  if (prefs.getBytesLength("cal") == sizeof(m) &&
+      prefs.getBytes("cal", m, sizeof(m)) == sizeof(m) && s_cal.set(m))
+    Serial.println("TOUCH: Stored calibration loaded");
+  prefs.end();
+}
+
+bool touch_input_begin(TaskHandle_t notify) {
+  s_notify = notify;
+  load_calibration();
+  if (!Wire.begin(TOUCH_PIN_SDA, TOUCH_PIN_SCL, TOUCH_I2C_HZ))
+    return false;
+  xTaskCreatePinnedToCore(touch_task, "touch", TOUCH_TASK_STACK, NULL,
+                          TOUCH_TASK_PRIORITY, &s_task, TOUCH_TASK_CORE);
+  task_stats_register(AT_TOUCH, s_task);
+  pinMode(TOUCH_PIN_INT, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(TOUCH_PIN_INT), touch_isr, FALLING);
+  return true;
+}
+
+bool touch_input_pending() { return !s_ring.empty(); }
+
+TouchPoint touch_input_read() {
+  bool was = s_filter.pressed();
+  TouchSample s;
+  while (s_ring.pop(s))
+    s_filter.push(s);
+
+  uint32_t now = micros();
+  bool pressed = s_filter.update(now);
+  if (pressed && (!was || s_filter.presses() != s_stats.presses)) {
+    // A new press reached LVGL
+    uint32_t us = now - s_filter.pressUs();
+    s_stats.presses = s_filter.presses();
+    s_stats.lastLatencyUs = us;
+    if (us > s_stats.maxLatencyUs)
+      s_stats.maxLatencyUs = us;
+    s_stats.totalLatencyUs += us;
+  }
+
+  uint16_t xr = s_filter.x(), yr = s_filter.y();
+  int32_t x, y;
+  if (s_raw) {
+    // Sensor is 320x480 portrait, display rotated to landscape
+    x = yr;
+    y = TOUCH_HEIGHT - 1 - xr;
+  } else {
+    s_cal.map(xr, yr, x, y);
+  }
+  x = constrain(x, 0, TOUCH_WIDTH - 1);
+  y = constrain(y, 0, TOUCH_HEIGHT - 1);
+  s_last = {pressed, (int16_t)x, (int16_t)y, xr, yr};
+  return s_last;
+}
+
+TouchPoint touch_input_last() { return s_last; }
+
+const TouchStats &touch_input_stats() { return s_stats; }
+
+void touch_input_set_raw(bool raw) { s_raw = raw; }
+
+void touch_input_set_calibration(const TouchCalibration &cal, bool save) {
+  s_cal = cal;
+  if (!save)
+    return;
+  Preferences prefs;
+  prefs.begin("touch", false);
+  prefs.putBytes("cal", cal.matrix(), 6 * sizeof(int32_t));
+  prefs.end();
+}
+
+const TouchCalibration &touch_input_calibration() { return s_cal; }
@@ -0,0 +1,60 @@
+#pragma once
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdint.h>
+
+#include "touch_calib.h"
+#include "touch_filter.h"
+
+/* Touch input.
+ *
+ * The FT5x06 pulls its INT line low when it has a report. A small task
+ * sleeps until that interrupt, reads the report over I2C at 400 kHz and
+ * queues a timestamped sample; while a finger stays down it keeps reading
+ * at the controller's report rate (or every TOUCH_PERIOD_MS at most), and
+ * after the lift it goes back to sleep, so an idle panel puts nothing on
+ * the bus. The LVGL read callback drains the queue through a TouchFilter
+ * and maps the result to the screen with a TouchCalibration, kept in NVS
+ * (namespace "touch") once the calibration screen has solved one.
+ *
+ * Build with -D TOUCH_TRACE to log every raw sample as
+ * "TRACE: us,x,y,down" for replaying through TouchFilter on a host. */
+#define TOUCH_PIN_SDA 6
+#define TOUCH_PIN_SCL 5
+#define TOUCH_PIN_INT 7
+#define TOUCH_I2C_ADDR 0x38
+#define TOUCH_I2C_HZ 400000
+#define TOUCH_PERIOD_MS 20 // Longest gap between reads while pressed
+
+struct TouchStats {
+  uint32_t irqs;
+  uint32_t reads;   // I2C reports read
+  uint32_t errors;  // Failed I2C reads
+  uint32_t dropped; // Samples lost to a full queue
+  uint32_t presses;
+  uint32_t lastLatencyUs; // Touch interrupt to LVGL seeing the press
+  uint32_t maxLatencyUs;
+  uint64_t totalLatencyUs;
+};
+
+struct TouchPoint {
+  bool pressed;
+  int16_t x, y;        // Screen, clamped to the display
+  uint16_t rawX, rawY; // Filtered sensor coordinates
+};
+
+/* I2C, interrupt, reader task, stored calibration. The reader notifies
+ * `notify` (if not NULL) whenever it queues samples. */
+bool touch_input_begin(TaskHandle_t notify);
+
+/* LVGL side: drain queued samples through the filter */
+bool touch_input_pending(); // Samples queued since the last read
+TouchPoint touch_input_read();
+TouchPoint touch_input_last(); // What touch_input_read() last returned
+const TouchStats &touch_input_stats();
+
+/* Skip the calibration and use the sensor's nominal orientation, so the
+ * calibration screen still works with a bad matrix */
+void touch_input_set_raw(bool raw);
+void touch_input_set_calibration(const TouchCalibration &cal, bool save);
+const TouchCalibration &touch_input_calibration();
@@ -0,0 +1,41 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+
+// Single-producer, single-consumer ring with no locks: the producer only
+// writes _head and the consumer only writes _tail. N must be a power of
+// two. A full ring refuses new items rather than overwrite unread ones.
+template <typename T, uint32_t N> class TouchRing {
+  static_assert((N & (N - 1)) == 0, "N must be a power of two");
+
+public:
+  // Producer side
+  bool push(const T &item) {
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) == N)
+      return false;
+    _buf[head & (N - 1)] = item;
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side
+  bool empty() const {
+    return _tail.load(std::memory_order_relaxed) ==
+           _head.load(std::memory_order_acquire);
+  }
+
+  bool pop(T &item) {
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail == _head.load(std::memory_order_acquire))
+      return false;
+    item = _buf[tail & (N - 1)];
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::atomic<uint32_t> _head{0};
+  std::atomic<uint32_t> _tail{0};
+  T _buf[N];
+};
@@ -0,0 +1,19 @@
+#pragma once
+#include <stdint.h>
+
+/* Longest loop() sleep. LVGL's own timers usually wake it sooner; this
+ * bounds the work loop() polls itself (clock, heater history). */
+#define LOOP_MAX_SLEEP_MS 50
+
+/* How long loop() sleeps after a pass, given lv_timer_handler()'s "ms
+ * until an LVGL timer is due" (LV_NO_TIMER_READY when none is). The touch
+ * and network tasks wake it sooner with a notification. A flush still on
+ * the bus is polled every tick, as the DMA completion raises no event, and
+ * the sleep is at least one tick so the idle task on the core still runs.
+ *
+ * Pure logic, so the loop can be simulated on a host clock. */
+static inline uint32_t loop_sleep_ms(uint32_t idle, bool flushPending) {
+  if (flushPending || idle == 0)
+    return 1;
+  return idle > LOOP_MAX_SLEEP_MS ? LOOP_MAX_SLEEP_MS : idle;
+}
@@ -1,52 +1,164 @@
 #include <Arduino.h>
 #define LGFX_USE_V1
 #include "LGFX_SC01_Plus.hpp"
+#include "input/touch_input.h"
+#include "loop_timing.h"
 #include "network/network_manager.h"
+#include "perf/profiler.h"
+#include "perf/task_stats.h"
+#include "task_layout.h"
 #include "ui/ui.h"
-#include <Wire.h> // Custom Touch Driver
+#include <esp_heap_caps.h>
 #include <lvgl.h>
 
-#define TP_ADDR 0x38
+/* LVGL takes its time from millis() (esp_timer) rather than counting
+ * lv_tick_inc() calls, so a slow loop pass cannot make it lose time */
+#if !LV_TICK_CUSTOM
+#error "Build with -D LV_TICK_CUSTOM=1"
+#endif
 
 static LGFX tft;
 
+SET_LOOP_TASK_STACK_SIZE(UI_TASK_STACK); // loop() is the UI task
+
 /* Change to your screen resolution */
 static const uint16_t screenWidth = 480;
 static const uint16_t screenHeight = 320;
 
+/* Draw buffers: two bands of DISP_BUF_LINES rows each. While one band is on
+ * the bus via DMA, LVGL renders the next one into the other buffer.
+ * Build with -D DISP_BUF_PSRAM to place them in PSRAM and keep internal
+ * SRAM free; internal SRAM is faster since DMA reads it directly. */
+#ifndef DISP_BUF_LINES
+#define DISP_BUF_LINES 40
+#endif
+#ifdef DISP_BUF_PSRAM
+#define DISP_BUF_CAPS (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#else
+#define DISP_BUF_CAPS (MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL)
+#endif
+
 static lv_disp_draw_buf_t draw_buf;
-static lv_color_t buf[screenWidth * 10];
+static uint32_t buf_lines = 0;
+
+/* Display whose flush is still on the bus; released by flush_poll() */
+static lv_disp_drv_t *volatile g_flush_pending = NULL;
 
-/* Display flushing */
+static TaskHandle_t g_loop_task = NULL; // Woken by touch and network events
+static lv_indev_t *g_touch_indev = NULL;
+
+/* Display flushing: start the DMA transfer and return. The write
+ * transaction stays open for the lifetime of the program (see setup()), so
+ * nothing here waits for the bus. */
 void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area,
                    lv_color_t *color_p) {
   uint32_t w = (area->x2 - area->x1 + 1);
   uint32_t h = (area->y2 - area->y1 + 1);
 
-  tft.startWrite();
   tft.setAddrWindow(area->x1, area->y1, w, h);
-  tft.writePixels((lgfx::rgb565_t *)&color_p->full, w * h);
-  tft.endWrite();
+  profiler_flush_start();
+  tft.writePixelsDMA((lgfx::rgb565_t *)&color_p->full, w * h);
+  g_flush_pending = disp;
+}
+
+/* Signal LVGL once the transfer has completed, so it can reuse the buffer */
+static void flush_poll() {
+  lv_disp_drv_t *disp = g_flush_pending;
+  if (disp && !tft.dmaBusy()) {
+    g_flush_pending = NULL;
+    profiler_flush_done();
+    lv_disp_flush_ready(disp);
+  }
+}
 
-  lv_disp_flush_ready(disp);
+/* Called by LVGL while it waits for a buffer to come back */
+static void my_disp_wait(lv_disp_drv_t *disp) {
+  uint32_t start = profiler_cycles();
+  flush_poll();
+  profiler_wait(start);
 }
 
-// Global touch state
-static bool g_touched = false;
-static int32_t g_last_x = 0;
-static int32_t g_last_y = 0;
-static uint16_t g_raw_x = 0; // Raw touch sensor values
-static uint16_t g_raw_y = 0;
-bool g_bypass_calibration = false; // Set to true to use raw coordinates
+/* Called by LVGL after each refresh with the number of pixels redrawn */
+static void my_disp_monitor(lv_disp_drv_t *disp, uint32_t time, uint32_t px) {
+  static bool first = true;
+  if (first) {
+    Serial.printf("Display: first frame %u ms after boot\n",
+                  (unsigned)millis());
+    first = false;
+  }
+  ui_observe_record_redraw(time, px);
+  ui_modal_record_redraw();
+  profiler_frame();
+}
+
+/* Allocate both draw buffers, shrinking the band if memory is short */
+static bool alloc_draw_buffers() {
+  for (uint32_t lines = DISP_BUF_LINES; lines >= 10; lines /= 2) {
+    size_t bytes = screenWidth * lines * sizeof(lv_color_t);
+    void *a = heap_caps_malloc(bytes, DISP_BUF_CAPS);
+    void *b = heap_caps_malloc(bytes, DISP_BUF_CAPS);
+    if (a && b) {
+      lv_disp_draw_buf_init(&draw_buf, a, b, screenWidth * lines);
+      buf_lines = lines;
+      Serial.printf("Display: 2 x %u lines (%u bytes) in %s\n",
+                    (unsigned)lines, (unsigned)bytes,
+                    (DISP_BUF_CAPS & MALLOC_CAP_SPIRAM) ? "PSRAM" : "SRAM");
+      return true;
+    }
+    heap_caps_free(a);
+    heap_caps_free(b);
+  }
+  return false;
+}
+
+#if defined(DISP_BENCHMARK) || defined(UI_BENCHMARK)
+/* Block until the last flush has gone out over DMA */
+static void wait_flush() {
+  while (g_flush_pending)
+    flush_poll();
+}
+#endif
 
-/* Read the touchpad */
+#ifdef DISP_BENCHMARK
+/* Time full-screen redraws of the current screen and report the result for
+ * this buffer configuration. Enable with -D DISP_BENCHMARK. */
+static void run_display_benchmark() {
+  const int frames = 30;
+  uint32_t start = micros();
+  for (int i = 0; i < frames; i++) {
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    wait_flush();
+  }
+  unsigned us = (micros() - start) / frames;
+  unsigned fps10 = us ? 10000000 / us : 0; // Frames per 10 s
+  Serial.printf("BENCH: %u lines x2 %s: %u.%03u ms/frame, %u.%u FPS\n",
+                (unsigned)buf_lines,
+                (DISP_BUF_CAPS & MALLOC_CAP_SPIRAM) ? "PSRAM" : "SRAM",
+                us / 1000, us % 1000, fps10 / 10, fps10 % 10);
+}
+#endif
+
+/* Read the touchpad: filtered samples from the touch task, no bus access */
 void my_touchpad_read(lv_indev_drv_t *indev_driver, lv_indev_data_t *data) {
-  if (g_touched) {
-    data->state = LV_INDEV_STATE_PR;
-    data->point.x = (lv_coord_t)g_last_x;
-    data->point.y = (lv_coord_t)g_last_y;
-  } else {
+  uint32_t start = profiler_cycles();
+  TouchPoint tp = touch_input_read();
+  profiler_mark(PP_TOUCH, start);
+  if (!tp.pressed) {
     data->state = LV_INDEV_STATE_REL;
+    return;
+  }
+
+  data->state = LV_INDEV_STATE_PR;
+  data->point.x = tp.x;
+  data->point.y = tp.y;
+
+  // Calibration logging - outputs raw and calibrated coordinates
+  static uint32_t lastLog = 0;
+  if (millis() - lastLog > 500) { // Log every 500ms when touched
+    Serial.printf("TOUCH: Raw(xr=%d, yr=%d) -> Calibrated(x=%d, y=%d)\n",
+                  tp.rawX, tp.rawY, tp.x, tp.y);
+    lastLog = millis();
   }
 }
 
@@ -64,16 +176,34 @@ void setup() {
   tft.setBrightness(255);
   tft.fillScreen(TFT_BLACK);
 
-  Wire.begin(6, 5, 100000);
+  g_loop_task = xTaskGetCurrentTaskHandle();
+  vTaskPrioritySet(NULL, UI_TASK_PRIORITY);
+  task_stats_register(AT_UI, g_loop_task);
+  if (xPortGetCoreID() != UI_TASK_CORE)
+    Serial.printf("Tasks: loop() on core %d, expected %d\n", xPortGetCoreID(),
+                  UI_TASK_CORE);
+  if (!touch_input_begin(g_loop_task))
+    Serial.println("Touch: I2C init failed");
+
+  // One long-lived write transaction: DMA transfers queue back to back
+  // without a wait-for-idle at every endWrite()
+  tft.startWrite();
 
   lv_init();
-  lv_disp_draw_buf_init(&draw_buf, buf, NULL, screenWidth * 10);
+  if (!alloc_draw_buffers()) {
+    Serial.println("Display: draw buffer allocation failed");
+    static lv_color_t fallback[screenWidth * 10];
+    lv_disp_draw_buf_init(&draw_buf, fallback, NULL, screenWidth * 10);
+    buf_lines = 10;
+  }
 
   static lv_disp_drv_t disp_drv;
   lv_disp_drv_init(&disp_drv);
   disp_drv.hor_res = screenWidth;
   disp_drv.ver_res = screenHeight;
   disp_drv.flush_cb = my_disp_flush;
+  disp_drv.wait_cb = my_disp_wait;
+  disp_drv.monitor_cb = my_disp_monitor;
   disp_drv.draw_buf = &draw_buf;
   lv_disp_drv_register(&disp_drv);
 
@@ -81,90 +211,58 @@ void setup() {
   lv_indev_drv_init(&indev_drv);
   indev_drv.type = LV_INDEV_TYPE_POINTER;
   indev_drv.read_cb = my_touchpad_read;
-  lv_indev_drv_register(&indev_drv);
+  g_touch_indev = lv_indev_drv_register(&indev_drv);
 
+  DataManager.init(g_loop_task); // Loads settings, starts the network task
   ui_init();
-  DataManager.init();
-  Serial.println("System Ready - Polling I2C...");
+#ifdef DISP_BENCHMARK
+  run_display_benchmark();
+#endif
+#ifdef UI_BENCHMARK
+  ui_update_status(); // Settle the initial fill first
+  lv_refr_now(NULL);
+  wait_flush();
+  ui_bench_run(wait_flush);
+#endif
+  profiler_begin();
+  Serial.println("System Ready");
 }
 
-void loop() {
-  // 1. READ I2C (Centralized)
-  Wire.beginTransmission(0x38);
-  Wire.write(0x02);
-  Wire.endTransmission();
-
-  if (Wire.requestFrom(0x38, 5) == 5) {
-    uint8_t p = Wire.read();
-    uint8_t xh = Wire.read();
-    uint8_t xl = Wire.read();
-    uint8_t yh = Wire.read();
-    uint8_t yl = Wire.read();
-
-    if ((p & 0x0F) > 0) {
-      uint16_t xr = ((xh & 0x0F) << 8) | xl;
-      uint16_t yr = ((yh & 0x0F) << 8) | yl;
-
-      // Store raw values
-      g_raw_x = xr;
-      g_raw_y = yr;
-
-      if (g_bypass_calibration) {
-        // RAW MODE - No calibration, direct mapping for calibration screen
-        // Touch sensor is 320x480 (portrait), display is rotated to 480x320
-        // (landscape) With rotation=1: sensor Y becomes display X, inverted
-        // sensor X becomes display Y Sensor ranges: xr (0-320), yr (0-480)
-        // Display ranges: x (0-479), y (0-319)
-        g_last_x = yr;       // Sensor Y (0-480) → Display X (0-479)
-        g_last_y = 319 - xr; // Inverted Sensor X (320-0) → Display Y (0-319)
-      } else {
-        // CALIBRATED MATH - Based on 4-point calibration data
-        // Dot 1 (20,20): Raw(xr=305, yr=19)
-        // Dot 2 (460,20): Raw(xr=315, yr=478)
-        // Dot 3 (20,300): Raw(xr=5, yr=39)
-        // Dot 4 (460,300): Raw(xr=27, yr=474)
-
-        // X-axis: yr (raw sensor Y) maps to display X
-        // yr range: 19-478 (459 units) → x range: 20-460 (440 pixels)
-        // Linear mapping: x = (yr - 19) * 440 / 459 + 20
-        g_last_x = ((int32_t)yr - 19) * 440 / 459 + 20;
-
-        // Y-axis: xr (raw sensor X) maps to display Y (inverted)
-        // xr range: 305-5 (inverted) → y range: 20-300 (280 pixels)
-        // Average top xr: (305+315)/2 = 310 → y=20
-        // Average bottom xr: (5+27)/2 = 16 → y=300
-        // Linear mapping: y = (310 - xr) * 280 / 294 + 20
-        g_last_y = (310 - (int32_t)xr) * 280 / 294 + 20;
-      }
-
-      if (g_last_x < 0)
-        g_last_x = 0;
-      if (g_last_x > 479)
-        g_last_x = 479;
-      if (g_last_y < 0)
-        g_last_y = 0;
-      if (g_last_y > 319)
-        g_last_y = 319;
-
-      // Calibration logging - outputs raw and calibrated coordinates
-      static uint32_t lastLog = 0;
-      if (millis() - lastLog > 500) { // Log every 500ms when touched
-        Serial.printf("TOUCH: Raw(xr=%d, yr=%d) -> Calibrated(x=%d, y=%d)\n",
-                      g_raw_x, g_raw_y, g_last_x, g_last_y);
-        lastLog = millis();
-      }
-
-      g_touched = true;
-    } else {
-      g_touched = false;
-    }
-  }
+/* Sleep until the next LVGL timer is due, or until the touch or network
+ * task has something new (see loop_sleep_ms()) */
+static void loop_sleep(uint32_t idle) {
+  uint32_t waitUs = micros();
+  ulTaskNotifyTake(pdTRUE,
+                   pdMS_TO_TICKS(loop_sleep_ms(idle, g_flush_pending)));
+  task_stats_wait(AT_UI, waitUs);
+}
 
-  // 2. LVGL HANDLER
+void loop() {
+  uint32_t t = profiler_loop();
+  flush_poll();
   DataManager.loop();
+  t = profiler_mark(PP_DATA, t);
   ui_update_status();
-  lv_tick_inc(5); // Add 5ms as we have a 5ms delay
-  lv_timer_handler();
+  t = profiler_mark(PP_UI, t);
+  if (touch_input_pending())
+    lv_timer_ready(g_touch_indev->driver->read_timer); // Read it this pass
+  uint32_t idle = lv_timer_handler(); // ms until an LVGL timer is due
+  profiler_lvgl(t);
+
+#ifdef TOUCH_STATS
+  static uint32_t lastTouchLog = 0;
+  if (millis() - lastTouchLog > 10000) {
+    const TouchStats &ts = touch_input_stats();
+    Serial.printf("Touch: irqs=%u reads=%u errors=%u dropped=%u presses=%u "
+                  "latency last=%uus max=%uus avg=%uus\n",
+                  (unsigned)ts.irqs, (unsigned)ts.reads, (unsigned)ts.errors,
+                  (unsigned)ts.dropped, (unsigned)ts.presses,
+                  (unsigned)ts.lastLatencyUs, (unsigned)ts.maxLatencyUs,
+                  (unsigned)(ts.presses ? ts.totalLatencyUs / ts.presses
+                                        : 0));
+    lastTouchLog = millis();
+  }
+#endif
 
-  delay(5);
+  loop_sleep(idle);
 }
@@ -0,0 +1,133 @@
+#include "command_queue.h"
+
+uint32_t CommandQueue::push(const char *gcode) {
+  return enqueue(CMD_SETPOINT_NONE, 0, gcode);
+}
+
+uint32_t CommandQueue::pushSetpoint(int8_t setpoint, float value,
+                                    const char *gcode) {
+  return enqueue(setpoint, value, gcode);
+}
+
+uint32_t CommandQueue::enqueue(int8_t setpoint, float value,
+                               const char *gcode) {
+  uint32_t id = 0;
+  portENTER_CRITICAL(&_mux);
+
+  // Newest first: merge into a pending setpoint for the same target
+  if (setpoint != CMD_SETPOINT_NONE) {
+    for (int i = _count - 1; i >= 0; i--) {
+      GCodeCommand &c = at(i);
+      if (c.state != CMD_PENDING || c.setpoint == CMD_SETPOINT_NONE)
+        break; // In flight or a barrier: keep ordering
+      if (c.setpoint == setpoint) {
+        c.value = value;
+        strlcpy(c.text, gcode, sizeof(c.text));
+        id = c.id;
+        _coalesced++;
+        break;
+      }
+    }
+  }
+
+  if (id == 0 && _count < CMD_QUEUE_DEPTH) {
+    GCodeCommand &c = at(_count++);
+    c.id = id = _nextId++;
+    c.setpoint = setpoint;
+    c.value = value;
+    c.state = CMD_PENDING;
+    strlcpy(c.text, gcode, sizeof(c.text));
+  }
+
+  portEXIT_CRITICAL(&_mux);
+  return id;
+}
+
+CommandState CommandQueue::state(uint32_t id) {
+  CommandState s = CMD_UNKNOWN;
+  portENTER_CRITICAL(&_mux);
+  for (uint8_t i = 0; i < _count; i++) {
+    if (at(i).id == id) {
+      s = at(i).state;
+      break;
+    }
+  }
+  if (s == CMD_UNKNOWN && id != 0 && id <= _lastDoneId) {
+    s = CMD_ACKED;
+    for (uint32_t f : _failed) {
+      if (f == id)
+        s = CMD_FAILED;
+    }
+  }
+  portEXIT_CRITICAL(&_mux);
+  return s;
+}
+
+bool CommandQueue::setpoint(int8_t setpoint, uint32_t viewSeq,
+                            float &value) {
+  bool found = false;
+  portENTER_CRITICAL(&_mux);
+  for (int i = _count - 1; i >= 0 && !found; i--) {
+    if (at(i).setpoint == setpoint) {
+      value = at(i).value;
+      found = true;
+    }
+  }
+  for (int i = 1; i <= CMD_APPLIED_HISTORY && !found; i++) {
+    const Applied &a =
+        _applied[(_appliedHead + CMD_APPLIED_HISTORY - i) % CMD_APPLIED_HISTORY];
+    if (a.seq != 0 && a.setpoint == setpoint &&
+        (int32_t)(a.seq - viewSeq) > 0) {
+      value = a.value;
+      found = true;
+    }
+  }
+  portEXIT_CRITICAL(&_mux);
+  return found;
+}
+
+uint8_t CommandQueue::pending() {
+  portENTER_CRITICAL(&_mux);
+  uint8_t n = _count;
+  portEXIT_CRITICAL(&_mux);
+  return n;
+}
+
+size_t CommandQueue::takeBatch(GCodeCommand *out, size_t max,
+                               size_t maxChars) {
+  size_t n = 0;
+  size_t chars = 0;
+  portENTER_CRITICAL(&_mux);
+  while (n < max && n < _count) {
+    GCodeCommand &c = at(n);
+    if (c.state != CMD_PENDING)
+      break;
+    size_t len = strlen(c.text) + (n > 0 ? 1 : 0); // '\n' separator
+    if (n > 0 && chars + len > maxChars)
+      break;
+    chars += len;
+    c.state = CMD_SENT;
+    out[n++] = c;
+  }
+  portEXIT_CRITICAL(&_mux);
+  return n;
+}
+
+void CommandQueue::complete(size_t count, bool ok, uint32_t appliedSeq) {
+  portENTER_CRITICAL(&_mux);
+  for (size_t i = 0; i < count && _count > 0; i++) {
+    GCodeCommand &c = at(0);
+    _lastDoneId = c.id;
+    if (c.setpoint != CMD_SETPOINT_NONE) {
+      _applied[_appliedHead] = {c.setpoint, c.value, appliedSeq};
+      _appliedHead = (_appliedHead + 1) % CMD_APPLIED_HISTORY;
+    }
+    if (!ok) {
+      _failed[_failedHead] = c.id;
+      _failedHead = (_failedHead + 1) % CMD_FAILED_HISTORY;
+    }
+    _head = (_head + 1) % CMD_QUEUE_DEPTH;
+    _count--;
+  }
+  portEXIT_CRITICAL(&_mux);
+}
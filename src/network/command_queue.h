@@ -0,0 +1,82 @@
+#pragma once
+#include <Arduino.h>
+
+#define CMD_QUEUE_DEPTH 16
+#define CMD_TEXT_LEN 160
+#define CMD_FAILED_HISTORY 8
+#define CMD_APPLIED_HISTORY 8 // Sent setpoints the UI may not have seen yet
+
+// Setpoint targets that may be coalesced
+#define CMD_SETPOINT_NONE -1
+#define CMD_SETPOINT_BED 0
+#define CMD_SETPOINT_TOOL(n) (1 + (n))
+
+enum CommandState : uint8_t {
+  CMD_UNKNOWN, // Never issued, or dropped from the history
+  CMD_PENDING, // Queued, may still be coalesced
+  CMD_SENT,    // In flight to the printer
+  CMD_ACKED,   // Accepted by rr_gcode
+  CMD_FAILED,  // Transport or HTTP error
+};
+
+struct GCodeCommand {
+  uint32_t id;
+  int8_t setpoint; // CMD_SETPOINT_* or CMD_SETPOINT_NONE for plain G-code
+  float value;     // Setpoint value, applied to the model when sent
+  CommandState state;
+  char text[CMD_TEXT_LEN];
+};
+
+// Bounded G-code queue between the UI and the network task.
+//
+// Ordering: commands are sent in the order they were queued. The only
+// exception is coalescing: a new setpoint replaces a still-pending setpoint
+// for the same target in place, provided no plain G-code was queued after
+// it (plain G-code is a barrier, since a macro may depend on the setpoint).
+// Setpoints for different targets commute and never act as barriers.
+//
+// All methods are short critical sections, safe from either core.
+class CommandQueue {
+public:
+  // UI side. Return the command id, or 0 when the queue is full.
+  uint32_t push(const char *gcode);
+  uint32_t pushSetpoint(int8_t setpoint, float value, const char *gcode);
+  CommandState state(uint32_t id);
+  uint8_t pending();
+
+  // Newest value asked for a setpoint target that a model snapshot older
+  // than `viewSeq` + 1 may not show yet: still queued, in flight, or sent
+  // and applied only in a later snapshot. False when the model is current.
+  bool setpoint(int8_t setpoint, uint32_t viewSeq, float &value);
+
+  // Sender side. Marks up to `max` pending commands whose text fits in
+  // `maxChars` (newline-joined) as sent and copies them out.
+  size_t takeBatch(GCodeCommand *out, size_t max, size_t maxChars);
+  // Retire the batch in flight. Its setpoints were applied to the model
+  // snapshot `appliedSeq`.
+  void complete(size_t count, bool ok, uint32_t appliedSeq = 0);
+
+  uint32_t coalesced() { return _coalesced; }
+
+private:
+  uint32_t enqueue(int8_t setpoint, float value, const char *gcode);
+  GCodeCommand &at(uint8_t i) {
+    return _items[(_head + i) % CMD_QUEUE_DEPTH];
+  }
+
+  GCodeCommand _items[CMD_QUEUE_DEPTH];
+  uint8_t _head = 0;
+  uint8_t _count = 0;
+  uint32_t _nextId = 1;
+  uint32_t _lastDoneId = 0;
+  uint32_t _failed[CMD_FAILED_HISTORY] = {0};
+  uint8_t _failedHead = 0;
+  struct Applied {
+    int8_t setpoint;
+    float value;
+    uint32_t seq;
+  } _applied[CMD_APPLIED_HISTORY] = {}; // seq 0: empty
+  uint8_t _appliedHead = 0;
+  uint32_t _coalesced = 0;
+  portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+};
@@ -0,0 +1,267 @@
+#include "filament_catalog.h"
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include <esp_heap_caps.h>
+// Arenas go to PSRAM when there is some, internal RAM otherwise
+static void *fc_realloc(void *p, size_t size) {
+  void *q = heap_caps_realloc(p, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  return q ? q : realloc(p, size);
+}
+#else
+static void *fc_realloc(void *p, size_t size) { return realloc(p, size); }
+#endif
+
+static char fold(char c) { return (c >= 'A' && c <= 'Z') ? c + 32 : c; }
+
+FilamentCatalog::~FilamentCatalog() { clear(); }
+
+void FilamentCatalog::clear() {
+  free(_text);
+  free(_fold);
+  free(_offset);
+  free(_sorted);
+  _text = _fold = nullptr;
+  _offset = nullptr;
+  _sorted = nullptr;
+  _textLen = _textCap = 0;
+  _count = _cap = 0;
+}
+
+void FilamentCatalog::swap(FilamentCatalog &other) {
+  std::swap(_text, other._text);
+  std::swap(_fold, other._fold);
+  std::swap(_textLen, other._textLen);
+  std::swap(_textCap, other._textCap);
+  std::swap(_offset, other._offset);
+  std::swap(_sorted, other._sorted);
+  std::swap(_count, other._count);
+  std::swap(_cap, other._cap);
+  std::swap(_p, other._p);
+}
+
+size_t FilamentCatalog::bytes() const {
+  return 2 * (size_t)_textCap +
+         (size_t)_cap * (sizeof(*_offset) + sizeof(*_sorted));
+}
+
+bool FilamentCatalog::reserve(uint32_t textBytes, uint16_t entries) {
+  if (textBytes > _textCap) {
+    uint32_t cap = _textCap ? _textCap : 1024;
+    while (cap < textBytes)
+      cap *= 2;
+    char *text = (char *)fc_realloc(_text, cap);
+    if (text)
+      _text = text;
+    char *folded = text ? (char *)fc_realloc(_fold, cap) : nullptr;
+    if (!folded)
+      return false; // Whatever did grow is kept for the next attempt
+    _fold = folded;
+    _textCap = cap;
+  }
+  if (entries > _cap) {
+    uint32_t cap = _cap ? _cap * 2u : 64;
+    if (cap > FC_MAX_ENTRIES)
+      cap = FC_MAX_ENTRIES;
+    uint32_t *offset =
+        (uint32_t *)fc_realloc(_offset, cap * sizeof(*_offset));
+    if (offset)
+      _offset = offset;
+    uint16_t *sorted =
+        offset ? (uint16_t *)fc_realloc(_sorted, cap * sizeof(*_sorted))
+               : nullptr;
+    if (!sorted)
+      return false;
+    _sorted = sorted;
+    _cap = cap;
+  }
+  return true;
+}
+
+bool FilamentCatalog::add(const char *name, size_t len) {
+  if (_count == FC_MAX_ENTRIES)
+    return false;
+  if (len >= FC_MAX_NAME)
+    len = FC_MAX_NAME - 1;
+  if (!reserve(_textLen + len + 1, _count + 1))
+    return false;
+
+  _offset[_count] = _textLen;
+  memcpy(_text + _textLen, name, len);
+  for (size_t i = 0; i < len; i++)
+    _fold[_textLen + i] = fold(name[i]);
+  _text[_textLen + len] = _fold[_textLen + len] = '\0';
+  _textLen += len + 1;
+  _sorted[_count] = _count;
+  _count++;
+  return true;
+}
+
+void FilamentCatalog::finish() {
+  std::sort(_sorted, _sorted + _count, [this](uint16_t a, uint16_t b) {
+    return strcmp(folded(a), folded(b)) < 0;
+  });
+}
+
+uint16_t FilamentCatalog::search(const char *query, uint16_t *out,
+                                 uint16_t max, const uint16_t *within,
+                                 uint16_t withinCount) const {
+  char q[FC_MAX_NAME];
+  size_t qlen = 0;
+  for (; query[qlen] && qlen < sizeof(q) - 1; qlen++)
+    q[qlen] = fold(query[qlen]);
+  q[qlen] = '\0';
+
+  uint16_t n = 0;
+  if (within) {
+    // Two passes keep prefix matches ahead of the others
+    for (uint16_t i = 0; i < withinCount && n < max; i++) {
+      if (strncmp(folded(within[i]), q, qlen) == 0)
+        out[n++] = within[i];
+    }
+    for (uint16_t i = 0; i < withinCount && n < max; i++) {
+      const char *f = folded(within[i]);
+      if (strncmp(f, q, qlen) != 0 && strstr(f, q))
+        out[n++] = within[i];
+    }
+    return n;
+  }
+
+  // Prefix matches are one contiguous run of the sorted index
+  const uint16_t *begin = _sorted, *end = _sorted + _count;
+  const uint16_t *lo = std::partition_point(begin, end, [&](uint16_t idx) {
+    return strncmp(folded(idx), q, qlen) < 0;
+  });
+  const uint16_t *hi = std::partition_point(lo, end, [&](uint16_t idx) {
+    return strncmp(folded(idx), q, qlen) == 0;
+  });
+
+  for (const uint16_t *p = lo; p < hi && n < max; p++)
+    out[n++] = *p;
+  if (qlen == 0)
+    return n;
+  for (const uint16_t *p = begin; p < end && n < max; p++) {
+    if ((p < lo || p >= hi) && strstr(folded(*p), q))
+      out[n++] = *p;
+  }
+  return n;
+}
+
+/* Streaming parser */
+
+void FilamentCatalog::beginParse() {
+  clear();
+  _p = {};
+}
+
+void FilamentCatalog::feed(const char *data, size_t len) {
+  for (size_t i = 0; i < len; i++)
+    parseChar(data[i]);
+}
+
+bool FilamentCatalog::endParse() {
+  finish();
+  return _p.seenList;
+}
+
+void FilamentCatalog::appendString(char c) {
+  if (_p.strLen < sizeof(_p.str) - 1)
+    _p.str[_p.strLen++] = c;
+}
+
+void FilamentCatalog::appendCodepoint(uint32_t cp) {
+  if (cp >= 0xD800 && cp <= 0xDFFF) {
+    appendString('?'); // Surrogate pairs are not decoded
+  } else if (cp < 0x80) {
+    appendString(cp);
+  } else if (cp < 0x800) {
+    appendString(0xC0 | cp >> 6);
+    appendString(0x80 | (cp & 0x3F));
+  } else {
+    appendString(0xE0 | cp >> 12);
+    appendString(0x80 | (cp >> 6 & 0x3F));
+    appendString(0x80 | (cp & 0x3F));
+  }
+}
+
+void FilamentCatalog::parseChar(char c) {
+  if (_p.inString) {
+    if (_p.hexLeft) {
+      int v = (c >= '0' && c <= '9')   ? c - '0'
+              : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+              : (c >= 'A' && c <= 'F') ? c - 'A' + 10
+                                       : 0;
+      _p.hex = _p.hex << 4 | v;
+      if (--_p.hexLeft == 0)
+        appendCodepoint(_p.hex);
+    } else if (_p.escape) {
+      _p.escape = false;
+      switch (c) {
+      case 'u':
+        _p.hexLeft = 4;
+        _p.hex = 0;
+        break;
+      case 'n':
+      case 'r':
+      case 't':
+      case 'b':
+      case 'f':
+        appendString(' ');
+        break;
+      default: // " \ /
+        appendString(c);
+      }
+    } else if (c == '\\') {
+      _p.escape = true;
+    } else if (c == '"') {
+      _p.inString = false;
+      _p.str[_p.strLen] = '\0';
+      if (_p.listDepth && _p.depth == _p.listDepth)
+        add(_p.str, _p.strLen);
+      else if (_p.depth == 1)
+        _p.keyMatch = strcmp(_p.str, "listValues") == 0;
+    } else {
+      appendString(c);
+    }
+    return;
+  }
+
+  switch (c) {
+  case ' ':
+  case '\t':
+  case '\r':
+  case '\n':
+    return; // Whitespace does not disturb key matching
+  case '"':
+    _p.inString = true;
+    _p.strLen = 0;
+    _p.armed = false;
+    return;
+  case ':':
+    _p.armed = _p.depth == 1 && _p.keyMatch;
+    _p.keyMatch = false;
+    return;
+  case '[':
+    _p.depth++;
+    if (_p.armed)
+      _p.listDepth = _p.depth;
+    break;
+  case '{':
+    _p.depth++;
+    break;
+  case ']':
+    if (_p.listDepth && _p.depth == _p.listDepth) {
+      _p.listDepth = 0;
+      _p.seenList = true;
+    }
+    _p.depth--;
+    break;
+  case '}':
+    _p.depth--;
+    break;
+  }
+  _p.armed = false;
+  _p.keyMatch = false;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#define FC_MAX_ENTRIES 0xFFFF // Indices are uint16_t
+#define FC_MAX_NAME 64        // Longer names are truncated
+
+// Filament profile names from filamentList.json.
+//
+// Names are stored back to back in one text arena (PSRAM on the device),
+// next to a case-folded copy used for matching and an index sorted by the
+// folded name. search() returns the prefix matches first, found by binary
+// search over the sorted index, then the other substring matches; both
+// groups are alphabetical. A query that extends the previous one can narrow
+// the previous result instead of scanning the whole catalog.
+//
+// The JSON body is parsed incrementally as it arrives, so the catalog size
+// is bounded by memory, not by a JSON document.
+//
+// Pure C++, no Arduino dependencies.
+class FilamentCatalog {
+public:
+  FilamentCatalog() = default;
+  ~FilamentCatalog();
+  FilamentCatalog(const FilamentCatalog &) = delete;
+  FilamentCatalog &operator=(const FilamentCatalog &) = delete;
+
+  void clear();
+  void swap(FilamentCatalog &other);
+
+  // Building: add() every name, then finish() to sort the index
+  bool add(const char *name, size_t len); // false when out of memory or full
+  void finish();
+
+  // Streaming parser for {"listValues":["name",...]}. feed() accepts the
+  // body in chunks of any size; endParse() returns true when a complete
+  // listValues array was seen and finishes the catalog.
+  void beginParse();
+  void feed(const char *data, size_t len);
+  bool endParse();
+
+  uint16_t count() const { return _count; }
+  const char *name(uint16_t idx) const {
+    return idx < _count ? _text + _offset[idx] : "";
+  }
+  size_t bytes() const; // Arena and index memory
+
+  // Catalog indices of the names containing query, case-insensitively,
+  // prefix matches first. An empty query returns everything. within, if
+  // given, restricts the search to an earlier result (which must not
+  // overlap out). Returns the number of indices written.
+  uint16_t search(const char *query, uint16_t *out, uint16_t max,
+                  const uint16_t *within = nullptr,
+                  uint16_t withinCount = 0) const;
+
+private:
+  const char *folded(uint16_t idx) const { return _fold + _offset[idx]; }
+  bool reserve(uint32_t textBytes, uint16_t entries);
+  void parseChar(char c);
+  void appendString(char c);
+  void appendCodepoint(uint32_t cp);
+
+  char *_text = nullptr; // Names, NUL terminated, back to back
+  char *_fold = nullptr; // Same layout, ASCII lower case
+  uint32_t _textLen = 0;
+  uint32_t _textCap = 0;
+  uint32_t *_offset = nullptr; // Start of each name in the arenas
+  uint16_t *_sorted = nullptr; // Indices ordered by folded name
+  uint16_t _count = 0;
+  uint16_t _cap = 0;
+
+  // Parser state
+  struct {
+    int depth;
+    bool inString, escape;
+    uint8_t hexLeft; // Digits still expected after \u
+    uint32_t hex;
+    char str[FC_MAX_NAME];
+    uint8_t strLen;
+    bool keyMatch; // Last top-level string was "listValues"
+    bool armed;    // ...and was followed by ':'
+    int listDepth; // Depth inside the listValues array, 0 when outside
+    bool seenList;
+  } _p = {};
+};
@@ -0,0 +1,130 @@
+#include "host_resolver.h"
+
+void HostResolver::setHost(const String &host) {
+  if (host == _host)
+    return;
+  _host = host;
+  _valid = false;
+  _refreshAt = 0;
+  _backoff = RESOLVE_NEG_MIN_MS;
+
+  IPAddress ip;
+  _literal = ip.fromString(host);
+  if (_literal) {
+    _addr = ip;
+    _valid = true;
+  }
+
+  // A lookup still in flight belongs to the old name; onFound() drops it
+  portENTER_CRITICAL(&_mux);
+  _pendingName[0] = '\0';
+  _done = false;
+  portEXIT_CRITICAL(&_mux);
+  _pending = false;
+}
+
+void HostResolver::invalidate() {
+  if (!_literal)
+    _refreshAt = millis();
+}
+
+bool HostResolver::lookup(IPAddress &ip) {
+  if (_literal) {
+    ip = _addr;
+    return true;
+  }
+  if (_host.length() == 0)
+    return false;
+
+  uint32_t now = millis();
+  if (_pending)
+    collect(now);
+  if (!_pending && (int32_t)(now - _refreshAt) >= 0)
+    start(now);
+
+  if (_valid)
+    ip = _addr; // Possibly stale while a refresh is in flight
+  return _valid;
+}
+
+void HostResolver::start(uint32_t now) {
+  if (_host.length() >= RESOLVE_NAME_LEN) {
+    _failures++;
+    _refreshAt = now + RESOLVE_NEG_MAX_MS;
+    return;
+  }
+
+  portENTER_CRITICAL(&_mux);
+  strlcpy(_pendingName, _host.c_str(), sizeof(_pendingName));
+  _done = false;
+  portEXIT_CRITICAL(&_mux);
+
+  _pending = true;
+  _started = now;
+  _queries++;
+
+  // Same call WiFiGenericClass::hostByName() makes, minus the wait
+  ip_addr_t addr;
+  err_t err = dns_gethostbyname(_host.c_str(), &addr, onFound, this);
+  if (err == ERR_OK) {
+    onFound(_host.c_str(), &addr, this); // Answered from lwIP's own cache
+  } else if (err != ERR_INPROGRESS) {
+    onFound(_host.c_str(), NULL, this);
+  }
+  collect(now);
+}
+
+void HostResolver::onFound(const char *name, const ip_addr_t *addr,
+                           void *arg) {
+  HostResolver *self = static_cast<HostResolver *>(arg);
+  portENTER_CRITICAL(&self->_mux);
+  if (strcmp(name, self->_pendingName) == 0) {
+    self->_ok = addr != NULL && IP_IS_V4(addr);
+    self->_result = self->_ok ? ip4_addr_get_u32(ip_2_ip4(addr)) : 0;
+    self->_done = true;
+  }
+  portEXIT_CRITICAL(&self->_mux);
+}
+
+void HostResolver::collect(uint32_t now) {
+  bool done, ok;
+  uint32_t result;
+  portENTER_CRITICAL(&_mux);
+  done = _done;
+  ok = _ok;
+  result = _result;
+  if (done)
+    _pendingName[0] = '\0';
+  portEXIT_CRITICAL(&_mux);
+
+  if (!done) {
+    if (now - _started < RESOLVE_TIMEOUT_MS)
+      return;
+    portENTER_CRITICAL(&_mux);
+    _pendingName[0] = '\0'; // A late answer is ignored
+    portEXIT_CRITICAL(&_mux);
+    ok = false;
+  }
+
+  _pending = false;
+  _lastQueryMs = now - _started;
+  if (ok) {
+    IPAddress ip(result);
+    if (!_valid || ip != _addr)
+      Serial.printf("NET: Resolved %s to %s\n", _host.c_str(),
+                    ip.toString().c_str());
+    _addr = ip;
+    _valid = true;
+    _backoff = RESOLVE_NEG_MIN_MS;
+    _refreshAt = now + RESOLVE_TTL_MS;
+  } else {
+    // Keep a previous answer: a flaky DNS server should not take the
+    // printer offline
+    _failures++;
+    Serial.printf("NET: Lookup of %s failed%s, retry in %lus\n",
+                  _host.c_str(), _valid ? " (using cached IP)" : "",
+                  (unsigned long)(_backoff / 1000));
+    _refreshAt = now + _backoff;
+    _backoff = min<uint32_t>(_backoff * 2, RESOLVE_NEG_MAX_MS);
+  }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <lwip/dns.h>
+
+#define RESOLVE_TTL_MS 300000    // Refresh a good answer every 5 minutes
+#define RESOLVE_NEG_MIN_MS 2000  // First retry after a failed lookup
+#define RESOLVE_NEG_MAX_MS 60000 // Back-off ceiling for repeated failures
+#define RESOLVE_TIMEOUT_MS 6000  // Give up on a lookup that never answers
+#define RESOLVE_NAME_LEN 64
+
+// Non-blocking printer address cache, shared by every request path.
+//
+// IP literals are used as is. Names, including .local ones (lwIP forwards
+// those to mDNS), go through lwIP's asynchronous dns_gethostbyname() and
+// are never waited on: lookup() returns the cached address, starts a
+// refresh when the TTL has run out and keeps serving the old address until
+// the new one arrives. Failures are cached too, with exponential back-off,
+// so an unknown name costs one query per back-off period rather than one
+// per request.
+//
+// Only used from the network task; the lwIP callback hands its result over
+// under a spinlock.
+class HostResolver {
+public:
+  // Set the configured printer address. Only a different value drops the
+  // cache, so unrelated settings saves do not force a new lookup.
+  void setHost(const String &host);
+
+  // Non-blocking. Returns true with a usable address, false while the first
+  // lookup is in flight or the name is known not to resolve.
+  bool lookup(IPAddress &ip);
+
+  bool pending() const { return _pending; }
+  void invalidate(); // Refresh on the next lookup(), keeping the old answer
+
+  // Statistics
+  uint32_t queries() const { return _queries; }
+  uint32_t failures() const { return _failures; }
+  uint32_t lastQueryMs() const { return _lastQueryMs; }
+
+private:
+  void start(uint32_t now);
+  void collect(uint32_t now);
+  static void onFound(const char *name, const ip_addr_t *addr, void *arg);
+
+  String _host;
+  bool _literal = false;
+  IPAddress _addr;     // Last good answer
+  bool _valid = false; // _addr holds an answer for _host
+  uint32_t _refreshAt = 0;
+  uint32_t _backoff = RESOLVE_NEG_MIN_MS;
+  bool _pending = false;
+  uint32_t _started = 0;
+
+  // Written by the lwIP callback
+  portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+  char _pendingName[RESOLVE_NAME_LEN] = "";
+  bool _done = false;
+  bool _ok = false;
+  uint32_t _result = 0;
+
+  uint32_t _queries = 0;
+  uint32_t _failures = 0;
+  uint32_t _lastQueryMs = 0;
+};
@@ -0,0 +1,151 @@
+#include "model_decoder.h"
+#include <string.h>
+
+// Build the ArduinoJson filter for one object-model key. Only the fields the
+// dashboard reads survive; everything else is skipped while streaming and
+// never reaches the heap. An empty key selects the flags=d99fn response.
+void buildModelFilter(JsonVariant f, const char *key) {
+  if (*key == '\0') {
+    buildModelFilter(f["heat"].to<JsonVariant>(), "heat");
+    buildModelFilter(f["tools"].to<JsonVariant>(), "tools");
+    buildModelFilter(f["state"].to<JsonVariant>(), "state");
+    buildModelFilter(f["job"].to<JsonVariant>(), "job");
+    f["seqs"] = true;
+  } else if (strcmp(key, "heat") == 0) {
+    f["heaters"][0]["current"] = true;
+    f["heaters"][0]["active"] = true;
+  } else if (strcmp(key, "tools") == 0) {
+    f[0]["heaters"] = true;
+  } else if (strcmp(key, "state") == 0) {
+    f["status"] = true;
+  } else if (strcmp(key, "job") == 0) {
+    f["filePosition"] = true;
+    f["file"]["size"] = true;
+  } else if (strcmp(key, "network") == 0) {
+    f["name"] = true;
+  } else {
+    f.set(true); // global.AFC_* arrays are used whole
+  }
+}
+
+static void decodeHeat(PrinterModel &m, JsonVariantConst heat,
+                       bool keepSetpoints) {
+  JsonArrayConst heaters = heat["heaters"].as<JsonArrayConst>();
+  if (heaters.isNull())
+    return;
+  int n = 0;
+  for (JsonVariantConst h : heaters) {
+    if (n >= PM_MAX_HEATERS)
+      break;
+    m.heaters[n].current = h["current"] | 0.0f;
+    if (!keepSetpoints)
+      m.heaters[n].active = h["active"] | 0.0f;
+    n++;
+  }
+  m.heaterCount = n;
+}
+
+static void decodeTools(PrinterModel &m, JsonVariantConst tools) {
+  JsonArrayConst arr = tools.as<JsonArrayConst>();
+  if (arr.isNull())
+    return;
+  m.toolCount = arr.size();
+  int i = 0;
+  for (JsonVariantConst t : arr) {
+    if (i >= PM_MAX_TOOLS)
+      break;
+    // heaters is non-live, so flags=d99fn entries do not carry it
+    JsonVariantConst heaters = t["heaters"];
+    if (!heaters.isNull())
+      m.toolHeater[i] = heaters[0] | -1;
+    i++;
+  }
+}
+
+static void decodeJob(PrinterModel &m, JsonVariantConst job) {
+  JsonVariantConst pos = job["filePosition"];
+  if (!pos.isNull())
+    m.filePosition = pos.as<uint32_t>();
+  // file is non-live: only a full job response says whether one is loaded
+  if (job.containsKey("file"))
+    m.fileSize = job["file"]["size"] | 0;
+  m.progress =
+      m.fileSize > 0 ? (m.filePosition * 100.0f) / m.fileSize : 0.0f;
+}
+
+static void decodeGlobal(PrinterModel &m, const char *subKey,
+                         JsonVariantConst res) {
+  // AFC_lanes[unit][lane] = [loaded, ..., [filament, ...]]
+  if (strcmp(subKey, "AFC_lanes") == 0 && res.is<JsonArrayConst>()) {
+    JsonArrayConst units = res.as<JsonArrayConst>();
+    for (int u = 0; u < (int)units.size() && u < PM_MAX_UNITS; u++) {
+      JsonArrayConst lanes = units[u].as<JsonArrayConst>();
+      for (int l = 0; l < (int)lanes.size() && l < PM_MAX_UNIT_LANES; l++) {
+        LaneInfo &lane = m.lanes[PrinterModel::laneIndex(u, l)];
+        lane.loaded = lanes[l][0].as<bool>();
+        strlcpy(lane.filament, lanes[l][4][0] | "", PM_NAME_LEN);
+      }
+    }
+  }
+
+  // Flatten the per-unit lane arrays the dashboard reads every refresh
+  if ((strcmp(subKey, "AFC_lane_to_tool") == 0 ||
+       strcmp(subKey, "AFC_LED_array") == 0) &&
+      res.is<JsonArrayConst>()) {
+    bool isTool = subKey[4] == 'l'; // AFC_[l]ane_to_tool
+    JsonArrayConst units = res.as<JsonArrayConst>();
+    for (int u = 0; u < (int)units.size() && u < PM_MAX_UNITS; u++) {
+      JsonArrayConst lanes = units[u].as<JsonArrayConst>();
+      for (int l = 0; l < (int)lanes.size() && l < PM_MAX_UNIT_LANES; l++) {
+        LaneInfo &lane = m.lanes[PrinterModel::laneIndex(u, l)];
+        int v = lanes[l] | -1;
+        if (isTool)
+          lane.tool = v;
+        else
+          lane.led =
+              (v >= LED_RED && v <= LED_CYAN) ? (LedColor)v : LED_UNKNOWN;
+      }
+    }
+  }
+
+  // Units x lanes shape from AFC_unit_total_lanes: one lane count per unit
+  if (strcmp(subKey, "AFC_unit_total_lanes") == 0 &&
+      res.is<JsonArrayConst>()) {
+    JsonArrayConst units = res.as<JsonArrayConst>();
+    int count = (int)units.size();
+    m.unitCount = count < PM_MAX_UNITS ? count : PM_MAX_UNITS;
+    for (int u = 0; u < m.unitCount; u++) {
+      int lanes = units[u] | PM_DEFAULT_UNIT_LANES;
+      m.unitLanes[u] = lanes < 0                   ? 0
+                       : lanes > PM_MAX_UNIT_LANES ? PM_MAX_UNIT_LANES
+                                                   : lanes;
+    }
+    // Lanes a unit no longer reports, and units that are gone, would
+    // otherwise keep their last state: AFC_lanes only writes what it has
+    for (int u = 0; u < PM_MAX_UNITS; u++) {
+      for (int l = m.laneCount(u); l < PM_MAX_UNIT_LANES; l++)
+        m.lanes[PrinterModel::laneIndex(u, l)].clear();
+    }
+  }
+}
+
+void decodeModelKey(PrinterModel &m, const char *key, JsonVariantConst res,
+                    bool keepSetpoints) {
+  if (strcmp(key, "heat") == 0) {
+    decodeHeat(m, res, keepSetpoints);
+  } else if (strcmp(key, "tools") == 0) {
+    decodeTools(m, res);
+  } else if (strcmp(key, "job") == 0) {
+    decodeJob(m, res);
+  } else if (strcmp(key, "state") == 0) {
+    // Don't let a state response overwrite offline status
+    const char *status = res["status"].as<const char *>();
+    if (status && !m.isOffline())
+      m.status = parsePrinterStatus(status);
+  } else if (strcmp(key, "network") == 0) {
+    strlcpy(m.printerName, res["name"] | "PanelDue SC01+",
+            sizeof(m.printerName));
+  } else if (strncmp(key, "global.", 7) == 0) {
+    decodeGlobal(m, key + 7, res); // Remove "global."
+  }
+}
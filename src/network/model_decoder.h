@@ -0,0 +1,18 @@
+#pragma once
+#include <ArduinoJson.h>
+
+#include "printer_model.h"
+
+// Object-model JSON to PrinterModel. Nothing here touches the network, the
+// RTOS or the clock, so the decoding rules can be built and exercised on any
+// host that has ArduinoJson.
+
+// Build the deserialization filter for one rr_model key ("" for d99fn)
+void buildModelFilter(JsonVariant f, const char *key);
+
+// Apply the result of one rr_model key to the model. Only fields present in
+// the response are touched, which is what makes the partial d99fn response
+// safe to merge. With keepSetpoints the heater targets are left alone so an
+// optimistic UI value is not overwritten by a stale reading.
+void decodeModelKey(PrinterModel &m, const char *key, JsonVariantConst res,
+                    bool keepSetpoints);
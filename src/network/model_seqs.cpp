@@ -0,0 +1,23 @@
+#include "model_seqs.h"
+
+static const struct {
+  const char *name;
+  uint32_t keys;
+} kBranches[SB_COUNT] = {
+    {"state", PK_MASK(PK_STATE)},
+    {"job", PK_MASK(PK_JOB)},
+    {"tools", PK_MASK(PK_TOOLS)},
+    {"network", PK_MASK(PK_NETWORK)},
+    // global shares one counter, so every AFC variable is refreshed
+    {"global", PK_MASK(PK_AFC_LANES) | PK_MASK(PK_AFC_LED) |
+                   PK_MASK(PK_AFC_LANE_TO_TOOL) |
+                   PK_MASK(PK_AFC_UNIT_LANES)},
+};
+
+const char *ModelSeqs::name(SeqBranch b) {
+  return b < SB_COUNT ? kBranches[b].name : "";
+}
+
+uint32_t ModelSeqs::keys(SeqBranch b) {
+  return b < SB_COUNT ? kBranches[b].keys : 0;
+}
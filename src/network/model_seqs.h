@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+
+#include "poll_scheduler.h"
+
+// Object-model branches with a seqs counter, in refetch order
+enum SeqBranch : uint8_t {
+  SB_STATE,
+  SB_JOB,
+  SB_TOOLS,
+  SB_NETWORK,
+  SB_GLOBAL,
+  SB_COUNT,
+};
+
+// Which branches POLL_SEQS refetches after a flags=d99fn response.
+//
+// That response carries the live values plus one counter per branch. A
+// branch is refetched, as the keys() it maps to, when its counter differs
+// from the one seen at its last successful refetch. A branch not refreshed
+// since invalidate() (start-up, a mode change, the printer coming back
+// online) counts as stale whatever its counter, since it may have moved
+// unseen; each branch leaves that state on its own refetch, so one that
+// fails does not send the others round again.
+//
+// Pure logic, no Arduino dependencies.
+class ModelSeqs {
+public:
+  static const char *name(SeqBranch b); // Key in the seqs object
+  static uint32_t keys(SeqBranch b);    // PK_MASK of the keys refetched
+
+  bool stale(SeqBranch b, uint32_t latest) const {
+    return !_valid[b] || latest != _seqs[b];
+  }
+  void refreshed(SeqBranch b, uint32_t latest) {
+    _seqs[b] = latest;
+    _valid[b] = true;
+  }
+  void invalidate() {
+    for (int b = 0; b < SB_COUNT; b++)
+      _valid[b] = false;
+  }
+
+private:
+  uint32_t _seqs[SB_COUNT] = {};
+  bool _valid[SB_COUNT] = {};
+};
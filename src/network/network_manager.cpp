@@ -1,41 +1,116 @@
 #include "network_manager.h"
+#include "model_decoder.h"
+#include "perf/profiler.h"
+#include "perf/task_stats.h"
+#include "task_layout.h"
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 #include <Update.h>
 #include <WiFi.h>
 
+// Task core, priority, stack and queue depth: see task_layout.h
+#define NET_TASK_IDLE_MS 10 // Web server service interval
+
+#define POLL_BOOST_MS 10000 // Fast AFC/heater polling after a user command
+#define POLL_IDLE_MS 120000 // Relax polling after this long without input
+
+// Per-poll parse buffer. Responses are filtered down to the fields the
+// dashboard uses, so this only has to hold the AFC arrays.
+#define MODEL_DOC_SIZE 8192
+
+#define CMD_TIMEOUT_MS 2000 // G-code and file downloads
+#define CMD_BATCH_MAX 8      // Commands packed into one rr_gcode request
+#define CMD_BATCH_CHARS 384  // Unencoded G-code per rr_gcode request
+
+#ifdef NET_MODEL_MIRROR
+#define MODEL_MIRROR_SIZE 16384
+#else
+#define MODEL_MIRROR_SIZE 0
+#endif
+
 NetworkManager DataManager;
 
-void NetworkManager::init() {
+void NetworkManager::init(TaskHandle_t uiTask) {
+  _uiTask = uiTask;
+  _lock = xSemaphoreCreateRecursiveMutex();
+  _requests = xQueueCreate(NET_REQUEST_DEPTH, sizeof(NetRequest));
+
   _prefs.begin("sc01-pref", false);
   loadSettings();
 
+  strlcpy(_work.printerName, "PanelDue SC01+ v" FIRMWARE_VERSION,
+          sizeof(_work.printerName));
+
   WiFi.mode(WIFI_STA);
 
   if (_ssid.length() > 0) {
     Serial.printf("Auto-connecting to: %s\n", _ssid.c_str());
     WiFi.begin(_ssid.c_str(), _password.c_str());
-    _status = "Connecting...";
+    _work.status = PS_CONNECTING;
   }
+
+  publishModel();
+  loop();
+
+  xTaskCreatePinnedToCore(taskEntry, "net", NET_TASK_STACK, this,
+                          NET_TASK_PRIORITY, &_task, NET_TASK_CORE);
+  task_stats_register(AT_NET, _task);
 }
 
 void NetworkManager::loop() {
+  // Cheap on the UI thread: copy the snapshot only when a new one exists
+  if (_snapshot.seq() != _viewSeq)
+    _viewSeq = _snapshot.read(_view);
+}
+
+void NetworkManager::taskEntry(void *arg) {
+  static_cast<NetworkManager *>(arg)->taskLoop();
+}
+
+void NetworkManager::taskLoop() {
+  for (;;) {
+    NetRequest req;
+    uint32_t waitUs = micros();
+    BaseType_t got =
+        xQueueReceive(_requests, &req, pdMS_TO_TICKS(NET_TASK_IDLE_MS));
+    task_stats_wait(AT_NET, waitUs);
+    if (got == pdTRUE) {
+      do {
+        processRequest(req);
+      } while (xQueueReceive(_requests, &req, 0) == pdTRUE);
+    }
+    // One NVS write however many settings changed since the last pass
+    if (_saveRequested)
+      saveSettings();
+    if (!_otaInProgress)
+      flushCommands();
+    serviceWiFi();
+    sampleHistory();
+  }
+}
+
+void NetworkManager::serviceWiFi() {
   static wl_status_t lastStatus = WL_IDLE_STATUS;
   wl_status_t currentStatus = WiFi.status();
 
   if (currentStatus != lastStatus) {
     lastStatus = currentStatus;
     Serial.printf("WiFi Status Change: %d\n", currentStatus);
+    _work.wifiConnected = currentStatus == WL_CONNECTED;
+    _work.localIP = _work.wifiConnected ? (uint32_t)WiFi.localIP() : 0;
+    strlcpy(_work.ssid, _work.wifiConnected ? WiFi.SSID().c_str() : "",
+            sizeof(_work.ssid));
     if (currentStatus == WL_CONNECTED) {
       Serial.print("WiFi Connected! IP: ");
       Serial.println(WiFi.localIP());
-      _status = "Connected";
+      _work.status = PS_CONNECTED;
       beginWebServer(); // Start server on connection
     } else if (currentStatus == WL_CONNECT_FAILED ||
                currentStatus == WL_NO_SSID_AVAIL) {
-      _status = "Failed";
+      _work.status = PS_FAILED;
     }
+    publishModel();
   }
 
   if (currentStatus == WL_CONNECTED) {
@@ -52,50 +127,166 @@ void NetworkManager::loop() {
       return;
     }
 
-    // Adaptive polling: slower when offline to reduce blocking impact
-    uint32_t pollInterval = (_status == "Offline") ? 5000 : _pollInterval;
-    if (millis() - _lastUpdate > pollInterval) {
-      updatePrinterStatus();
+    // Per-key adaptive polling; see PollScheduler for the period table
+    bool seqs = _pollMode == POLL_SEQS && _seqsSupported;
+    _scheduler.setEnabled(seqs ? PK_MASK(PK_LIVE)
+                               : (PK_MASK(PK_COUNT) - 1) & ~PK_MASK(PK_LIVE));
+    _scheduler.setProbe(seqs ? PK_LIVE : PK_STATE);
+    _scheduler.setBaseInterval(_pollInterval);
+    _scheduler.setActivity(pollActivity());
+    int key = _scheduler.next(millis());
+    if (key >= 0) {
+      // Only a decoded response refreshes the key; a failure leaves its
+      // age growing so staleness shows in /poll
+      if (updatePrinterStatus((PollKey)key))
+        _scheduler.markFetched((PollKey)key, millis());
+      else
+        _scheduler.markFailed((PollKey)key, millis());
       _lastUpdate = millis();
     }
+
+    // Prefetch the filament list so the picker opens with data
+    if (_lastFilamentFetch == 0 && _lastUpdate != 0 && !_work.isOffline()) {
+      _lastFilamentFetch = millis();
+      doFetchFilamentList();
+    }
+  }
+}
+
+void NetworkManager::processRequest(const NetRequest &req) {
+  switch (req.type) {
+  case NetRequest::POLL_NOW:
+    _scheduler.expedite();
+    break;
+  case NetRequest::FILAMENTS:
+    doFetchFilamentList();
+    break;
+  case NetRequest::CONNECT: {
+    String ssid, pass;
+    {
+      NetLock lock(_lock);
+      ssid = _ssid;
+      pass = _password;
+    }
+    Serial.printf("Connecting to WiFi: %s\n", ssid.c_str());
+    WiFi.disconnect();
+    WiFi.begin(ssid.c_str(), pass.c_str());
+    break;
+  }
+  }
+}
+
+// Send everything queued since the last pass as a single rr_gcode request.
+// RRF executes newline-separated lines in order, so a burst of taps costs
+// one round trip instead of one per command.
+void NetworkManager::flushCommands() {
+  GCodeCommand batch[CMD_BATCH_MAX];
+  size_t n = _commands.takeBatch(batch, CMD_BATCH_MAX, CMD_BATCH_CHARS);
+  if (n == 0)
+    return;
+
+  String lines;
+  bool setpoint = false;
+  for (size_t i = 0; i < n; i++) {
+    if (batch[i].setpoint != CMD_SETPOINT_NONE) {
+      applySetpoint(batch[i].setpoint, batch[i].value);
+      setpoint = true;
+    }
+    if (i > 0)
+      lines += '\n';
+    lines += batch[i].text;
+  }
+  if (setpoint) {
+    _lastCommandTime = millis();
+    publishModel();
+  }
+  _lastActivityTime = millis();
+
+  _commands.complete(n, doSendGCode(lines.c_str()), _snapshot.seq());
+}
+
+void NetworkManager::applySetpoint(int8_t setpoint, float value) {
+  if (setpoint == CMD_SETPOINT_BED) {
+    if (_work.heaterCount > 0)
+      _work.heaters[0].active = value;
+  } else if (HeaterReading *h =
+                 _work.toolHeaterReading(setpoint - CMD_SETPOINT_TOOL(0))) {
+    h->active = value;
+  }
+}
+
+bool NetworkManager::postRequest(const NetRequest &req) {
+  if (_requests == NULL)
+    return false;
+  // Never block the caller: the UI thread must stay responsive
+  if (xQueueSend(_requests, &req, 0) != pdTRUE) {
+    Serial.println("NET: Request queue full, dropping request");
+    return false;
+  }
+  return true;
+}
+
+void NetworkManager::publishModel() {
+  _snapshot.publish(_work);
+  if (_uiTask)
+    xTaskNotifyGive(_uiTask); // Cut the UI loop's sleep short
+}
+
+void NetworkManager::sampleHistory() {
+  uint32_t now = millis();
+  if (!_history.due(now))
+    return;
+  {
+    NetLock lock(_lock);
+    _history.sample(now, _work);
   }
+  _historySeq++;
+}
+
+void NetworkManager::requestPoll() {
+  NetRequest req = {};
+  req.type = NetRequest::POLL_NOW;
+  postRequest(req);
 }
 
 void NetworkManager::loadSettings() {
+  NetLock lock(_lock);
   _ssid = _prefs.getString("ssid", "");
   _password = _prefs.getString("pass", "");
   _printerIP = _prefs.getString("rip", "");
-  _ipResolved = false; // Force re-resolution
   _pollInterval = _prefs.getUInt("poll", 5000);
   _ntpServer = _prefs.getString("ntp", "pool.ntp.org");
   _gmtOffset = _prefs.getLong("gmto", 0);
   _selectedTool = _prefs.getInt("tlidx", 0);
   _activeAFCUnit = _prefs.getInt("afcunit", 0);
+  _pollMode = (PollMode)_prefs.getUChar("pmode", POLL_SEQS);
   Serial.println("Settings Loaded.");
 }
 
 void NetworkManager::saveSettings() {
+  _saveRequested = false;
+  NetLock lock(_lock);
   _prefs.putString("ssid", _ssid);
   _prefs.putString("pass", _password);
   _prefs.putString("rip", _printerIP);
-  _ipResolved = false; // Force re-resolution
   _prefs.putUInt("poll", _pollInterval);
   _prefs.putString("ntp", _ntpServer);
   _prefs.putLong("gmto", _gmtOffset);
   _prefs.putInt("tlidx", _selectedTool);
   _prefs.putInt("afcunit", _activeAFCUnit);
+  _prefs.putUChar("pmode", _pollMode);
   Serial.println("Settings Saved.");
 }
 
 void NetworkManager::connectWiFi(const char *ssid, const char *password) {
-  _ssid = ssid;
-  _password = password;
-  saveSettings();
-
-  Serial.printf("Connecting to WiFi: %s\n", ssid);
-  _status = "Connecting...";
-  WiFi.disconnect();
-  WiFi.begin(ssid, password);
+  {
+    NetLock lock(_lock);
+    _ssid = ssid;
+    _password = password;
+  }
+  requestSave();
+  _view.status = PS_CONNECTING;
+  postRequest({NetRequest::CONNECT});
 }
 
 bool NetworkManager::isConnected() { return WiFi.status() == WL_CONNECTED; }
@@ -103,13 +294,17 @@ bool NetworkManager::isConnected() { return WiFi.status() == WL_CONNECTED; }
 String NetworkManager::getIP() { return WiFi.localIP().toString(); }
 
 void NetworkManager::setPrinterIP(const char *ip) {
-  _printerIP = ip;
-  saveSettings();
+  {
+    NetLock lock(_lock);
+    _printerIP = ip;
+  }
+  requestSave();
 }
 
 void NetworkManager::log(const char *msg) {
   String timeStr = getFormattedTime();
   String entry = "[" + timeStr + "] " + String(msg);
+  NetLock lock(_lock);
   _logs.push_back(entry);
   if (_logs.size() > 50)
     _logs.pop_front();
@@ -118,7 +313,8 @@ void NetworkManager::log(const char *msg) {
 
 String NetworkManager::getFormattedTime() {
   struct tm timeinfo;
-  if (!getLocalTime(&timeinfo)) {
+  // Zero wait: the default blocks for up to 5 s until NTP has synced
+  if (!getLocalTime(&timeinfo, 0)) {
     return String(millis());
   }
   char buf[32];
@@ -128,6 +324,16 @@ String NetworkManager::getFormattedTime() {
 
 void NetworkManager::beginWebServer() {
   _server.on("/", HTTP_GET, [this]() {
+    String ssid, pass, ntp, rip;
+    {
+      NetLock lock(_lock);
+      ssid = _ssid;
+      pass = _password;
+      ntp = _ntpServer;
+      rip = _printerIP;
+    }
+    String status = printerStatusName(_work.status);
+
     String html = "<html><head><meta charset='UTF-8'><meta name='viewport' "
                   "content='width=device-width,initial-scale=1'>";
     html += "<title>SC01+ Config v" FIRMWARE_VERSION "</title>";
@@ -331,10 +537,10 @@ void NetworkManager::beginWebServer() {
     html +=
         "\u003cdiv class='status' style='margin-left:20px;'\u003e\u003cspan "
         "id='status-dot' class='status-dot' style='background:" +
-        String(_status == "Offline" ? "#ff6b6b" : "#4ade80") +
+        String(_work.isOffline() ? "#ff6b6b" : "#4ade80") +
         ";'\u003e\u003c/span\u003ePrinter: \u003cspan "
         "id='printer-status'\u003e" +
-        _status + "\u003c/span\u003e\u003c/div\u003e";
+        status + "\u003c/span\u003e\u003c/div\u003e";
     html += "<p style='margin-top:10px;'><a href='/model' target='_blank'>📊 "
             "View Internal Object Model (JSON)</a></p>";
     html += "</div>";
@@ -349,11 +555,11 @@ void NetworkManager::beginWebServer() {
     html += "<form action='/save' method='POST' "
             "onsubmit='saveSettings(event);return false;'>";
     html += "<label>WiFi SSID</label>";
-    html += "<input type='text' name='ssid' value='" + _ssid + "' required>";
+    html += "<input type='text' name='ssid' value='" + ssid + "' required>";
     html += "<label>WiFi Password</label>";
-    html += "<input type='password' name='pass' value='" + _password + "'>";
+    html += "<input type='password' name='pass' value='" + pass + "'>";
     html += "<label>NTP Server</label>";
-    html += "<input type='text' name='ntp' value='" + _ntpServer + "'>";
+    html += "<input type='text' name='ntp' value='" + ntp + "'>";
 
     // Timezone dropdown
     html += "<label>Timezone</label>";
@@ -402,14 +608,25 @@ void NetworkManager::beginWebServer() {
             "& AFC Settings</div>";
     html +=
         "\u003clabel\u003ePrinter Address (IP or Hostname)\u003c/label\u003e";
-    html += "\u003cinput type='text' name='rip' value='" + _printerIP +
+    html += "\u003cinput type='text' name='rip' value='" + rip +
             "' placeholder='printer.local or 192.168.1.100' required\u003e";
     html += "<label>Poll Rate (ms)</label>";
     html += "<input type='number' name='poll' value='" + String(_pollInterval) +
             "' min='100' max='10000'>";
+    html += "<label>Poll Mode</label>";
+    html += "<select name='pmode'>";
+    html += "<option value='1'";
+    if (_pollMode == POLL_SEQS)
+      html += " selected";
+    html += ">Incremental (seqs)</option>";
+    html += "<option value='0'";
+    if (_pollMode == POLL_PER_KEY)
+      html += " selected";
+    html += ">Per-key schedule</option>";
+    html += "</select>";
     html += "<label>AFC Unit</label>";
     html += "<select name='afcunit'>";
-    for (int i = 0; i < _unitCount; i++) {
+    for (int i = 0; i < _work.unitCount; i++) {
       html += "<option value='" + String(i) + "'";
       if (i == _activeAFCUnit)
         html += " selected";
@@ -451,6 +668,7 @@ void NetworkManager::beginWebServer() {
 
   _server.on("/console", HTTP_GET, [this]() {
     String output = "=== SC01+ Firmware v" FIRMWARE_VERSION " ===\n\n";
+    NetLock lock(_lock);
     for (const auto &l : _logs) {
       output += l + "\n";
     }
@@ -458,26 +676,38 @@ void NetworkManager::beginWebServer() {
   });
 
   _server.on("/save", HTTP_POST, [this]() {
-    if (_server.hasArg("ssid"))
-      _ssid = _server.arg("ssid");
-    if (_server.hasArg("pass"))
-      _password = _server.arg("pass");
-    if (_server.hasArg("rip"))
-      _printerIP = _server.arg("rip");
-    if (_server.hasArg("poll"))
-      _pollInterval = _server.arg("poll").toInt();
-    if (_server.hasArg("ntp"))
-      _ntpServer = _server.arg("ntp");
-    if (_server.hasArg("timezone"))
-      _gmtOffset = _server.arg("timezone").toInt();
-    if (_server.hasArg("afcunit"))
-      setActiveAFCUnit(_server.arg("afcunit").toInt());
-
-    saveSettings();
+    String ssid, pass;
+    {
+      NetLock lock(_lock);
+      if (_server.hasArg("ssid"))
+        _ssid = _server.arg("ssid");
+      if (_server.hasArg("pass"))
+        _password = _server.arg("pass");
+      if (_server.hasArg("rip"))
+        _printerIP = _server.arg("rip");
+      if (_server.hasArg("poll"))
+        _pollInterval = _server.arg("poll").toInt();
+      if (_server.hasArg("pmode")) {
+        _pollMode =
+            _server.arg("pmode").toInt() ? POLL_SEQS : POLL_PER_KEY;
+        _seqsSupported = true; // Re-probe the firmware
+        _seqs.invalidate();
+      }
+      if (_server.hasArg("ntp"))
+        _ntpServer = _server.arg("ntp");
+      if (_server.hasArg("timezone"))
+        _gmtOffset = _server.arg("timezone").toInt();
+      if (_server.hasArg("afcunit"))
+        setActiveAFCUnit(_server.arg("afcunit").toInt());
+
+      saveSettings();
+      ssid = _ssid;
+      pass = _password;
+    }
     log("Settings saved via Web UI. Reconnecting...");
     _server.send(200, "text/plain", "Settings saved. Reconnecting...");
     delay(1000);
-    WiFi.begin(_ssid.c_str(), _password.c_str());
+    WiFi.begin(ssid.c_str(), pass.c_str());
   });
 
   _server.on(
@@ -523,170 +753,217 @@ void NetworkManager::beginWebServer() {
 
   // Units API endpoint for dynamic updates
   _server.on("/units", HTTP_GET, [this]() {
-    String json = "{\"count\":" + String(_unitCount) +
-                  ",\"active\":" + String(_activeAFCUnit) + "}";
+    String json = "{\"count\":" + String(_work.unitCount) +
+                  ",\"active\":" + String(_activeAFCUnit) + ",\"lanes\":[";
+    for (int u = 0; u < _work.unitCount; u++) {
+      if (u > 0)
+        json += ",";
+      json += String(_work.laneCount(u));
+    }
+    json += "]}";
     _server.send(200, "application/json", json);
   });
 
   _server.on("/status", HTTP_GET, [this]() {
-    String json = "{\"status\":\"" + _status + "\",\"online\":" +
-                  String(_status != "Offline" ? "true" : "false") + "}";
+    String json = "{\"status\":\"" +
+                  String(printerStatusName(_work.status)) +
+                  "\",\"online\":" +
+                  String(!_work.isOffline() ? "true" : "false");
+    json += ",\"requests\":" + String(_requestCount.load());
+    json += ",\"parseUs\":" + String(_lastParseUs);
+    json += ",\"peakDocBytes\":" + String(_peakDocBytes);
+    json += ",\"connects\":" +
+            String(_pollLink.connects() + _cmdLink.connects());
+    json += ",\"reuses\":" + String(_pollLink.reuses() + _cmdLink.reuses());
+    json += ",\"dnsQueries\":" + String(_resolver.queries());
+    json += ",\"dnsFailures\":" + String(_resolver.failures());
+    json += ",\"dnsLastMs\":" + String(_resolver.lastQueryMs());
+    json += ",\"cmdPending\":" + String(_commands.pending());
+    json += ",\"cmdCoalesced\":" + String(_commands.coalesced());
+    json += ",\"pollP50Ms\":" + String(_pollLink.latencyPercentile(50));
+    json += ",\"pollP99Ms\":" + String(_pollLink.latencyPercentile(99));
+    json += "}";
     _server.send(200, "application/json", json);
   });
 
-  _server.begin();
-  log("Web Server Started.");
-}
-
-void NetworkManager::handleWebServer() { _server.handleClient(); }
+  // Per-request timing on both printer links
+  _server.on("/trace", HTTP_GET, [this]() {
+    String json = "{\"poll\":";
+    _pollLink.traceJSON(json);
+    json += ",\"cmd\":";
+    _cmdLink.traceJSON(json);
+    json += "}";
+    _server.send(200, "application/json", json);
+  });
 
-String NetworkManager::getModelJSON() {
-  DynamicJsonDocument combined(32768); // Increased to 32KB for all models
-  combined["heat"] = _modelHeat;
-  combined["state"] = _modelState;
-  combined["job"] = _modelJob;
-  combined["network"] = _modelNetwork;
-  combined["global"] = _modelGlobal;
-  String output;
-  serializeJson(combined, output);
-  return output;
-}
+  // Heater history: /history?tier=0|1&from=N, see sendHistoryJSON()
+  _server.on("/history", HTTP_GET, [this]() { sendHistoryJSON(); });
 
-void NetworkManager::updatePrinterStatus() {
-  if (_printerIP.length() == 0)
-    return;
+  // UI loop phase timings, see perf/profiler.h; ?overlay=1|0 shows or hides
+  // them on screen
+  _server.on("/profile", HTTP_GET, [this]() {
+    if (_server.hasArg("overlay"))
+      profiler_set_overlay(_server.arg("overlay").toInt() != 0);
+    String json;
+    profiler_json(json);
+    _server.send(200, "application/json", json);
+  });
 
-  // Sequence: state, job, network, then 5 global keys
-  String key = "state";
-  static const char *globalKeys[] = {
-      "global.AFC_lanes", "global.AFC_LED_array", "global.AFC_lane_to_tool",
-      "global.AFC_unit_total_lanes", "global.Tool_to_AFC"};
-
-  if (_queryIndex == 1)
-    key = "job";
-  else if (_queryIndex == 2)
-    key = "network";
-  else if (_queryIndex >= 3 && _queryIndex <= 7) {
-    int keyOffset = _queryIndex - 3;
-    key = globalKeys[keyOffset];
-  }
+  // Task layout, stack headroom and load, see task_layout.h
+  _server.on("/tasks", HTTP_GET, [this]() {
+    String json;
+    task_stats_json(json);
+    _server.send(200, "application/json", json);
+  });
 
-  _queryIndex = (_queryIndex + 1) % 8; // 3 core keys + 5 global keys
+  // Poll scheduler: target period, current age and worst lateness per key
+  _server.on("/poll", HTTP_GET, [this]() {
+    uint32_t now = millis();
+    String json = "{\"activity\":\"" +
+                  String(PollScheduler::activityName(_scheduler.activity())) +
+                  "\",\"keys\":[";
+    for (int k = 0; k < PK_COUNT; k++) {
+      PollKey key = (PollKey)k;
+      const char *name = PollScheduler::keyName(key);
+      if (k > 0)
+        json += ",";
+      json += "{\"key\":\"" + String(*name ? name : "d99fn") + "\"";
+      json += ",\"periodMs\":" + String(_scheduler.period(key));
+      json += ",\"ageMs\":" + String(_scheduler.age(key, now));
+      json += ",\"maxLateMs\":" + String(_scheduler.maxLate(key));
+      json += ",\"fetches\":" + String(_scheduler.fetches(key)) + "}";
+    }
+    json += "]}";
+    _server.send(200, "application/json", json);
+  });
 
-  // 1. Check if we have a network connection first
-  if (WiFi.status() != WL_CONNECTED) {
-    _status = "Offline";
-    return;
-  }
+  _server.begin();
+  log("Web Server Started.");
+}
 
-  // 2. Resolve hostname if needed (caching to avoid blocking DNS)
-  String targetIP = _printerIP;
-  IPAddress ip;
+void NetworkManager::handleWebServer() { _server.handleClient(); }
 
-  // Check if _printerIP is already a valid IP string
-  if (ip.fromString(_printerIP)) {
-    targetIP = _printerIP; // It's an IP, use as is
-  } else {
-    // It's a hostname, check if we need to resolve it
-    if (!_ipResolved || _cachedIP == IPAddress(0, 0, 0, 0)) {
-      // Try to resolve
-      IPAddress resolvedIP;
-      if (WiFi.hostByName(_printerIP.c_str(), resolvedIP)) {
-        _cachedIP = resolvedIP;
-        _ipResolved = true;
-        Serial.printf("NET: Resolved %s to %s\n", _printerIP.c_str(),
-                      _cachedIP.toString().c_str());
-      } else {
-        // Resolve failed
-        if (_cachedIP != IPAddress(0, 0, 0, 0)) {
-          Serial.println("NET: DNS failed, using cached IP");
-          // Proceed with cached IP, but keep _ipResolved false to try again
-          // next time
-        } else {
-          _status = "Offline";
-          return; // No IP to connect to
-        }
+// {"tier":0,"periodMs":2000,"from":F,"end":E,"heaters":[{"current":[..],
+// "target":[..]},..]}: points F..E-1 of one tier in tenths of a degree,
+// null where there was no reading. A client polls with from= the last end
+// it saw and gets only the new points. Runs on the network task, which is
+// the only writer, so the history is read without the lock.
+void NetworkManager::sendHistoryJSON() {
+  TempTier tier = _server.arg("tier").toInt() == 1 ? TT_COARSE : TT_FINE;
+  uint32_t from = _server.hasArg("from") ? _server.arg("from").toInt() : 0;
+  if (from < _history.first(tier))
+    from = _history.first(tier);
+  uint32_t end = _history.end(tier);
+  if (from > end)
+    from = end;
+
+  String json;
+  json.reserve(64 + (end - from) * TH_SENSORS * 12);
+  json = "{\"tier\":" + String(tier) +
+         ",\"periodMs\":" + String(TempHistory::periodMs(tier)) +
+         ",\"from\":" + String(from) + ",\"end\":" + String(end) +
+         ",\"heaters\":[";
+  TempPoint pts[32];
+  for (int s = 0; s < TH_SENSORS; s++) {
+    String target;
+    json += s ? ",{\"current\":[" : "{\"current\":[";
+    for (uint32_t i = from; i < end;) {
+      uint16_t n = _history.read(tier, s, i, pts, 32);
+      if (n == 0)
+        break;
+      for (uint16_t k = 0; k < n; k++, i++) {
+        const char *sep = i > from ? "," : "";
+        json += sep;
+        json += pts[k].current == TH_NONE ? "null" : String(pts[k].current);
+        target += sep;
+        target += pts[k].target == TH_NONE ? "null" : String(pts[k].target);
       }
     }
-    targetIP = _cachedIP.toString();
+    json += "],\"target\":[" + target + "]}";
   }
+  json += "]}";
+  _server.send(200, "application/json", json);
+}
 
-  HTTPClient http;
-  String url = "http://" + targetIP + "/rr_model?key=" + key;
-
-  // Use shorter timeouts when offline to prevent UI blocking
-  int timeout = (_status == "Offline") ? 200 : 500; // Reduced timeouts further
-  http.setTimeout(timeout);
-  http.setConnectTimeout(timeout); // Also set connection timeout
-  http.begin(url);
-  int httpCode = http.GET();
+String NetworkManager::getModelJSON() {
+  // Serialize the typed model; the raw mirror is only kept in debug builds
+  const PrinterModel &m = _work;
+  DynamicJsonDocument doc(8192 + MODEL_MIRROR_SIZE);
+  doc["status"] = printerStatusName(m.status);
+  doc["name"] = m.printerName;
+  JsonArray heaters = doc.createNestedArray("heaters");
+  for (int i = 0; i < m.heaterCount; i++) {
+    JsonObject h = heaters.createNestedObject();
+    h["current"] = m.heaters[i].current;
+    h["active"] = m.heaters[i].active;
+  }
+  JsonArray tools = doc.createNestedArray("toolHeaters");
+  for (int i = 0; i < m.toolCount && i < PM_MAX_TOOLS; i++)
+    tools.add(m.toolHeater[i]);
+  doc["filePosition"] = m.filePosition;
+  doc["fileSize"] = m.fileSize;
+  doc["progress"] = m.progress;
+  JsonArray units = doc.createNestedArray("units");
+  for (int u = 0; u < m.unitCount && u < PM_MAX_UNITS; u++) {
+    JsonArray lanes = units.createNestedArray();
+    for (int l = 0; l < m.laneCount(u); l++) {
+      const LaneInfo *lane = m.lane(u, l);
+      JsonObject o = lanes.createNestedObject();
+      o["loaded"] = lane->loaded;
+      o["tool"] = lane->tool;
+      o["led"] = (int)lane->led;
+      o["filament"] = lane->filament;
+    }
+  }
+#ifdef NET_MODEL_MIRROR
+  doc["raw"] = _modelRaw;
+#endif
+  String output;
+  serializeJson(doc, output);
+  return output;
+}
 
+bool NetworkManager::requestModel(const String &host, const char *key,
+                                  DynamicJsonDocument &doc) {
+  String uri = "/rr_model?";
+  if (*key)
+    uri += String("key=") + key;
+  else
+    uri += "flags=d99fn";
+
+  // Use shorter timeouts when offline to keep retries cheap
+  int timeout = _work.isOffline() ? 200 : 500; // Reduced timeouts further
+  _pollLink.setHost(host);
+  int httpCode = _pollLink.get(uri, timeout);
+  _requestCount++;
+
+  bool ok = false;
   if (httpCode == 200) {
-    String payload = http.getString();
-
-    DynamicJsonDocument doc(24576); // Use 24KB for robust parsing
-    DeserializationError error = deserializeJson(doc, payload);
+    StaticJsonDocument<384> filter;
+    filter["key"] = true;
+    buildModelFilter(filter["result"].to<JsonVariant>(), key);
+
+    // Parse straight from the socket instead of buffering the body.
+    // Chunked responses have no usable raw stream and are buffered.
+    uint32_t start = micros();
+    DeserializationError error;
+    if (_pollLink.canStream())
+      error = deserializeJson(doc, _pollLink.stream(),
+                              DeserializationOption::Filter(filter));
+    else
+      error = deserializeJson(doc, _pollLink.body(),
+                              DeserializationOption::Filter(filter));
+    _lastParseUs = micros() - start;
+    if (doc.memoryUsage() > _peakDocBytes)
+      _peakDocBytes = doc.memoryUsage();
 
     if (!error) {
       // Successful response - clear offline status if it was set
-      if (_status == "Offline") {
-        _status = "Idle"; // Default to idle, will be updated from state
+      if (_work.isOffline()) {
+        _work.status = PS_IDLE; // Default to idle, will be updated from state
         log("Printer back online");
       }
-
-      JsonObject root = doc.as<JsonObject>();
-      String keyReceived = root["key"] | "";
-      JsonVariant res = root["result"];
-
-      if (keyReceived == "heat") {
-        _modelHeat.clear();
-        _modelHeat.set(res);
-      } else if (keyReceived == "tools") {
-        _modelTools.clear();
-        _modelTools.set(res);
-      } else if (keyReceived == "state") {
-        _modelState.clear();
-        _modelState.set(res);
-      } else if (keyReceived == "job") {
-        _modelJob.clear();
-        _modelJob.set(res);
-      } else if (keyReceived == "network") {
-        _modelNetwork.clear();
-        _modelNetwork.set(res);
-      } else if (keyReceived.startsWith("global.")) {
-        // Handle specific global variables selectively
-        String subKey = keyReceived.substring(7); // Remove "global."
-        _modelGlobal[subKey] = res;
-
-        // Specialized handling for AFC_lanes to maintain legacy logic
-        if (subKey == "AFC_lanes" && res.is<JsonArray>()) {
-          JsonArray units = res.as<JsonArray>();
-          for (int u = 0; u < units.size() && u < 8; u++) {
-            JsonArray lanes = units[u].as<JsonArray>();
-            for (int l = 0; l < lanes.size() && l < 4; l++) {
-              int toolIdx = u * 4 + l;
-              if (toolIdx < 32) {
-                _laneLoaded[toolIdx] = lanes[l][0].as<bool>();
-                if (lanes[l].size() > 4 && lanes[l][4].is<JsonArray>()) {
-                  JsonArray info = lanes[l][4].as<JsonArray>();
-                  if (info.size() > 0) {
-                    _laneNames[toolIdx] = info[0].as<String>();
-                  }
-                }
-              }
-            }
-          }
-        }
-
-        // Update unit count from AFC_unit_total_lanes
-        if (subKey == "AFC_unit_total_lanes" && res.is<JsonArray>()) {
-          JsonArray unitLanes = res.as<JsonArray>();
-          _unitCount = unitLanes.size();
-        }
-
-        // Compact memory to prevent fragmentation
-        _modelGlobal.garbageCollect();
-      }
+      ok = true;
     } else {
       log(("PARSE ERR: " + String(error.c_str())).c_str());
       // Don't block recovery - continue polling
@@ -695,164 +972,301 @@ void NetworkManager::updatePrinterStatus() {
     // HTTP request failed
     if (httpCode <= 0) {
       // Connection error - printer likely offline
-      if (_status != "Offline") {
-        _status = "Offline";
+      if (!_work.isOffline()) {
+        _work.status = PS_OFFLINE;
         log("Printer offline - will retry");
       }
+      _pollLink.close();
+      _resolver.invalidate(); // The name may point somewhere new (DHCP)
     } else {
       // HTTP error code (404, 500, etc.)
       log(("HTTP ERR: " + String(httpCode)).c_str());
     }
     // Continue polling to allow recovery
   }
-  http.end();
-
-  // Update members from the REPLICATED model branches
-  JsonObject heat = _modelHeat.as<JsonObject>();
-  JsonObject state = _modelState.as<JsonObject>();
-  JsonObject job = _modelJob.as<JsonObject>();
-  JsonObject network = _modelNetwork.as<JsonObject>();
-  JsonArray toolsArr = _modelTools.as<JsonArray>();
-
-  if (!heat.isNull()) {
-    JsonArray heaters = heat["heaters"];
-    if (heaters && heaters.size() > 0) {
-      _bedTemp = heaters[0]["current"] | 0.0f;
-      if (millis() - _lastCommandTime > _commandLockout) {
-        _bedTarget = heaters[0]["active"] | 0.0f;
-      }
-    }
+  _pollLink.end();
+  return ok;
+}
 
-    if (!toolsArr.isNull()) {
-      _toolCount = toolsArr.size();
-      for (int i = 0; i < _toolCount && i < 10; i++) {
-        JsonVariant tHeaters = toolsArr[i]["heaters"];
-        if (tHeaters.is<JsonArray>()) {
-          JsonArray hArr = tHeaters.as<JsonArray>();
-          if (hArr.size() > 0) {
-            int hIdx = hArr[0] | -1;
-            if (hIdx >= 0 && heaters && heaters.size() > hIdx) {
-              _toolTemps[i] = heaters[hIdx]["current"] | 0.0f;
-              if (millis() - _lastCommandTime > _commandLockout) {
-                _toolTargets[i] = heaters[hIdx]["active"] | 0.0f;
-              }
-            }
-          }
-        }
-      }
+void NetworkManager::storeModelKey(const char *key, JsonVariantConst res) {
+#ifdef NET_MODEL_MIRROR
+  _modelRaw[key] = res;
+  _modelRaw.garbageCollect();
+#endif
+  // Keep optimistic setpoints until the printer has caught up
+  bool keepSetpoints = millis() - _lastCommandTime <= _commandLockout;
+  decodeModelKey(_work, key, res, keepSetpoints);
+}
+
+bool NetworkManager::pollKey(const String &host, PollKey key) {
+  DynamicJsonDocument doc(MODEL_DOC_SIZE);
+  const char *name = PollScheduler::keyName(key);
+  if (!requestModel(host, name, doc))
+    return false;
+  storeModelKey(name, doc["result"]);
+  return true;
+}
+
+// True once the live values are decoded; branches that fail to refetch are
+// retried on the next pass through their unchanged seqs
+bool NetworkManager::pollBySeqs(const String &host) {
+  // One request returns every live value (temperatures, status, file
+  // position) together with the seqs counters for the non-live branches.
+  DynamicJsonDocument doc(MODEL_DOC_SIZE);
+  if (!requestModel(host, "", doc))
+    return false;
+
+  JsonObjectConst result = doc["result"].as<JsonObjectConst>();
+  JsonObjectConst seqs = result["seqs"].as<JsonObjectConst>();
+  if (seqs.isNull()) {
+    // Firmware without seqs support: fall back for the rest of this session
+    _seqsSupported = false;
+    log("No seqs in object model, polling each key on its own period");
+    return false;
+  }
+
+  for (JsonPairConst kv : result) {
+    if (strcmp(kv.key().c_str(), "seqs") != 0)
+      storeModelKey(kv.key().c_str(), kv.value());
+  }
+
+  // Snapshot the counters before the document is reused
+  uint32_t latest[SB_COUNT];
+  for (int b = 0; b < SB_COUNT; b++)
+    latest[b] = seqs[ModelSeqs::name((SeqBranch)b)] | 0;
+
+  // Refetch only the branches whose sequence moved
+  for (int b = 0; b < SB_COUNT; b++) {
+    SeqBranch branch = (SeqBranch)b;
+    if (!_seqs.stale(branch, latest[b]))
+      continue;
+
+    uint32_t keys = ModelSeqs::keys(branch);
+    for (int k = 0; k < PK_COUNT; k++) {
+      if (!(keys & PK_MASK(k)))
+        continue;
+      const char *name = PollScheduler::keyName((PollKey)k);
+      doc.clear();
+      if (!requestModel(host, name, doc))
+        return true; // This and the remaining branches stay stale
+      storeModelKey(name, doc["result"]);
     }
+    _seqs.refreshed(branch, latest[b]);
   }
+  return true;
+}
 
-  // Only update status from state if we're not offline
-  // (don't let cached state overwrite offline status)
-  if (!state.isNull() && _status != "Offline") {
-    _status = state["status"].as<String>();
-    if (_status.length() > 0)
-      _status[0] = toupper(_status[0]);
+bool NetworkManager::resolvePrinter(String &targetIP) {
+  String printerIP;
+  {
+    NetLock lock(_lock);
+    printerIP = _printerIP;
   }
+  if (printerIP.length() == 0)
+    return false;
+
+  // Never blocks: a changed address or an expired TTL starts a background
+  // lookup and the last good answer is used meanwhile
+  _resolver.setHost(printerIP);
+  IPAddress ip;
+  if (!_resolver.lookup(ip))
+    return false;
+  targetIP = ip.toString();
+  return true;
+}
+
+// How urgently the printer needs watching, from the task's own state
+PollActivity NetworkManager::pollActivity() {
+  if (_work.isOffline())
+    return PA_OFFLINE;
+  uint32_t sinceInput = millis() - _lastActivityTime;
+  if (_lastActivityTime != 0 && sinceInput < POLL_BOOST_MS)
+    return PA_BOOST;
+  switch (_work.status) {
+  case PS_BUSY:
+  case PS_CHANGING_TOOL: // AFC load/unload macros run as busy/tool change
+    return PA_BOOST;
+  case PS_PROCESSING:
+  case PS_SIMULATING:
+  case PS_PAUSING:
+  case PS_RESUMING:
+  case PS_CANCELLING:
+    return PA_PRINTING;
+  default:
+    break;
+  }
+  return sinceInput >= POLL_IDLE_MS ? PA_IDLE : PA_NORMAL;
+}
+
+bool NetworkManager::updatePrinterStatus(PollKey key) {
+  {
+    NetLock lock(_lock);
+    if (_printerIP.length() == 0)
+      return false;
+  }
+
+  // 1. Check if we have a network connection first
+  if (WiFi.status() != WL_CONNECTED) {
+    _work.status = PS_OFFLINE;
+    publishModel();
+    return false;
+  }
+
+  // 2. Resolve the printer address; the first lookup of a name is not a
+  // reason to report the printer offline
+  String targetIP;
+  if (!resolvePrinter(targetIP)) {
+    if (_resolver.pending())
+      return false;
+    _work.status = PS_OFFLINE;
+    publishModel();
+    return false;
+  }
+
+  bool wasOffline = _work.isOffline();
+  bool ok = key == PK_LIVE ? pollBySeqs(targetIP) : pollKey(targetIP, key);
+
+  // Counters may have moved while we could not see them
+  if (_work.isOffline() || wasOffline)
+    _seqs.invalidate();
 
   // Heartbeat log: showing Status and Unit count
   static uint32_t lastLog = 0;
   if (millis() - lastLog > 5000) {
-    String logMsg =
-        "Machine: " + _status + " (Units: " + String(_unitCount) + ")";
+    String logMsg = "Machine: " + String(printerStatusName(_work.status)) +
+                    " (Units: " + String(_work.unitCount) + ")";
     log(logMsg.c_str());
     lastLog = millis();
   }
 
-  if (!network.isNull()) {
-    _printerName = network["name"] | "PanelDue SC01+";
-  }
-
-  if (!job.isNull()) {
-    float pos = job["filePosition"] | 0.0f;
-    float size = job["file"]["size"] | 1.0f;
-    if (size > 0)
-      _progress = (pos / size) * 100.0f;
-  }
+  publishModel();
+  return ok;
 }
 
-void NetworkManager::sendGCode(const char *gcode) {
-  if (!isConnected() || _printerIP.length() == 0)
-    return;
+uint32_t NetworkManager::sendGCode(const char *gcode) {
+  uint32_t id = _commands.push(gcode);
+  if (id == 0)
+    Serial.println("NET: Command queue full, dropping G-code");
+  return id;
+}
 
-  // URL Encode the G-code (minimally replace spaces with %20)
-  String encoded = "";
-  for (int i = 0; gcode[i] != '\0'; i++) {
-    if (gcode[i] == ' ')
-      encoded += "%20";
-    else
-      encoded += gcode[i];
+bool NetworkManager::doSendGCode(const char *gcode) {
+  String host;
+  if (!isConnected() || !resolvePrinter(host))
+    return false;
+
+  // Percent-encode everything outside the URI unreserved set, so quoted
+  // macro paths, '#' and multi-line batches ('\n' -> %0A) survive intact
+  static const char hex[] = "0123456789ABCDEF";
+  String encoded;
+  encoded.reserve(strlen(gcode) * 3 / 2);
+  for (const char *p = gcode; *p; p++) {
+    char c = *p;
+    if (isalnum((unsigned char)c) || c == '-' || c == '_' || c == '.' ||
+        c == '~') {
+      encoded += c;
+    } else {
+      encoded += '%';
+      encoded += hex[(uint8_t)c >> 4];
+      encoded += hex[(uint8_t)c & 0xF];
+    }
   }
 
-  HTTPClient http;
-  String url = "http://" + _printerIP + "/rr_gcode?gcode=" + encoded;
-  log(("GCODE SEND: " + url).c_str());
-  http.begin(url);
-  int httpCode = http.GET();
+  String uri = "/rr_gcode?gcode=" + encoded;
+  log(("GCODE SEND: " + uri).c_str());
+  _cmdLink.setHost(host);
+  // G-code is not idempotent: never resent after a transport error
+  int httpCode = _cmdLink.get(uri, CMD_TIMEOUT_MS, false);
+  _requestCount++;
   if (httpCode != 200) {
     Serial.printf("NET: GCode failed, HTTP %d\n", httpCode);
   }
-  http.end();
+  _cmdLink.end();
+  return httpCode == 200;
 }
 
 void NetworkManager::setBedTarget(float temp) {
-  _bedTarget = temp;
-  if (_bedTarget < 0)
-    _bedTarget = 0;
-  _lastCommandTime = millis();
-  char buf[64];
+  if (temp < 0)
+    temp = 0;
   // Set target and ensure bed is active (M144 S1)
-  snprintf(buf, sizeof(buf), "M140 S%.0f", _bedTarget);
-  sendGCode(buf);
-  sendGCode("M144 S1");
+  char buf[48];
+  snprintf(buf, sizeof(buf), "M140 S%.0f\nM144 S1", temp);
+  _commands.pushSetpoint(CMD_SETPOINT_BED, temp, buf);
 }
 
 void NetworkManager::setToolTarget(float temp) {
-  _toolTargets[_selectedTool] = temp;
-  if (_toolTargets[_selectedTool] < 0)
-    _toolTargets[_selectedTool] = 0;
-  _lastCommandTime = millis();
-  char buf[64];
+  if (temp < 0)
+    temp = 0;
+  int tool = _selectedTool;
+  if (tool < 0 || tool >= PM_MAX_TOOLS)
+    return;
   // M568 sets active (S) and standby (R) temps. A2 sets Active state.
-  snprintf(buf, sizeof(buf), "M568 P%d S%.0f A2", _selectedTool,
-           _toolTargets[_selectedTool]);
-  sendGCode(buf);
+  char buf[48];
+  snprintf(buf, sizeof(buf), "M568 P%d S%.0f A2", tool, temp);
+  _commands.pushSetpoint(CMD_SETPOINT_TOOL(tool), temp, buf);
 }
 
 void NetworkManager::adjustBed(float delta) {
-  setBedTarget(_bedTarget + delta);
+  setBedTarget(getBedTarget() + delta);
 }
 
 void NetworkManager::adjustTool(float delta) {
-  setToolTarget(_toolTargets[_selectedTool] + delta);
+  setToolTarget(getToolTarget() + delta);
 }
 
 // Filament List Management
 void NetworkManager::fetchFilamentList() {
-  // Always fetch fresh data when requested to ensure latest filament list
-  HTTPClient http;
-  String url =
-      "http://" + _printerIP + "/rr_download?name=0:/sys/filamentList.json";
+  NetRequest req = {};
+  req.type = NetRequest::FILAMENTS;
+  postRequest(req);
+}
 
-  http.setTimeout(2000);
-  http.setConnectTimeout(2000);
-  http.begin(url);
-  int httpCode = http.GET();
+void NetworkManager::doFetchFilamentList() {
+  // Always fetch fresh data when requested to ensure latest filament list
+  String host;
+  if (!resolvePrinter(host)) {
+    log("Failed to fetch filament list");
+    return;
+  }
+  _cmdLink.setHost(host);
+  int httpCode = _cmdLink.get("/rr_download?name=0:/sys/filamentList.json",
+                              CMD_TIMEOUT_MS);
+  _requestCount++;
 
   if (httpCode == 200) {
-    String payload = http.getString();
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, payload);
-
-    if (!error && doc.containsKey("listValues")) {
-      _filamentList.clear();
-      JsonArray values = doc["listValues"].as<JsonArray>();
-      for (JsonVariant v : values) {
-        _filamentList.push_back(v.as<String>());
+    // Parse while reading, straight into the new catalog's arena; the list
+    // is never held as one JSON document. Chunked bodies are buffered.
+    FilamentCatalog next;
+    next.beginParse();
+    uint32_t start = micros();
+    if (_cmdLink.canStream()) {
+      Stream &body = _cmdLink.stream();
+      char buf[256];
+      for (int left = _cmdLink.size(); left > 0;) {
+        size_t n = body.readBytes(buf, min(left, (int)sizeof(buf)));
+        if (n == 0)
+          break; // Timed out
+        next.feed(buf, n);
+        left -= n;
+      }
+    } else {
+      String payload = _cmdLink.body();
+      next.feed(payload.c_str(), payload.length());
+    }
+
+    if (next.endParse()) {
+      uint32_t us = micros() - start;
+      int count = next.count();
+      size_t bytes = next.bytes();
+      {
+        NetLock lock(_lock);
+        _filaments.swap(next);
       }
+      _filamentSeq++;
       _lastFilamentFetch = millis();
-      log("Filament list fetched successfully");
+      log(("Filament list fetched: " + String(count) + " names, " +
+           String(bytes) + " bytes, " + String(us) + " us")
+              .c_str());
     } else {
       log("Failed to parse filament list JSON");
     }
@@ -860,7 +1274,7 @@ void NetworkManager::fetchFilamentList() {
     log("Failed to fetch filament list");
   }
 
-  http.end();
+  _cmdLink.end();
 }
 
 void NetworkManager::setLaneFilament(int unit, int lane, String filamentName) {
@@ -880,22 +1294,9 @@ void NetworkManager::setLaneFilament(int unit, int lane, String filamentName) {
 }
 
 String NetworkManager::getLaneFilament(int unit, int lane) {
-  // Get filament from AFC_lanes[unit][lane][4][0]
-  if (_modelGlobal.containsKey("AFC_lanes")) {
-    JsonArray units = _modelGlobal["AFC_lanes"].as<JsonArray>();
-    if (unit >= 0 && unit < units.size()) {
-      JsonArray lanes = units[unit].as<JsonArray>();
-      if (lane >= 0 && lane < lanes.size()) {
-        JsonArray laneData = lanes[lane].as<JsonArray>();
-        if (laneData.size() > 4) {
-          JsonArray filamentData = laneData[4].as<JsonArray>();
-          if (filamentData.size() > 0) {
-            String filament = filamentData[0].as<String>();
-            return filament; // Return whatever is there, even if empty
-          }
-        }
-      }
-    }
-  }
+  // AFC_lanes[unit][lane][4][0] from the last published snapshot
+  const LaneInfo *l = _view.lane(unit, lane);
+  if (l)
+    return l->filament;
   return ""; // Return empty string if not found
 }
@@ -5,29 +5,74 @@
 #include <Preferences.h>
 #include <WebServer.h>
 #include <WiFi.h>
+#include <atomic>
 #include <deque>
 
+#include "command_queue.h"
+#include "filament_catalog.h"
+#include "host_resolver.h"
+#include "model_seqs.h"
+#include "printer_link.h"
+#include "poll_scheduler.h"
+#include "printer_model.h"
+#include "temp_history.h"
+
 #define FIRMWARE_VERSION "1.0.0"
 
+// How the network task refreshes the object model
+enum PollMode : uint8_t {
+  POLL_PER_KEY = 0,     // Each key on its own adaptive period
+  POLL_SEQS = 1,        // Live values every interval, branches on seqs change
+};
+
+// Work handed from the UI thread to the network task. G-code goes through
+// the CommandQueue instead so it can be coalesced and batched.
+struct NetRequest {
+  enum Type : uint8_t { POLL_NOW, FILAMENTS, CONNECT };
+  Type type;
+};
+
+// Recursive mutex guard for state shared between the UI and network task
+class NetLock {
+public:
+  explicit NetLock(SemaphoreHandle_t m) : _m(m) {
+    xSemaphoreTakeRecursive(_m, portMAX_DELAY);
+  }
+  ~NetLock() { xSemaphoreGiveRecursive(_m); }
+
+private:
+  SemaphoreHandle_t _m;
+};
+
 class NetworkManager {
 public:
-  void init();
-  void loop();
+  void init(TaskHandle_t uiTask); // Notified whenever a snapshot is published
+  void loop(); // UI thread: picks up the latest published snapshot
   void connectWiFi(const char *ssid, const char *password);
   void scanNetworks();
   bool isConnected();
   String getIP();
-  String getSSID() { return _ssid; }
-  String getPass() { return _password; }
-  String getStatus() { return _status; }
-  String getPrinterName() { return _printerName; }
+  String getSSID() {
+    NetLock lock(_lock);
+    return _ssid;
+  }
+  String getPass() {
+    NetLock lock(_lock);
+    return _password;
+  }
+  String getStatus() { return printerStatusName(_view.status); }
+  String getPrinterName() { return _view.printerName; }
   String getFormattedTime();
 
   // Web Server & OTA
   void beginWebServer();
   void handleWebServer();
   void log(const char *msg);
-  void sendGCode(const char *gcode);
+  // Queue G-code for the network task. Returns a command id for
+  // getCommandState(), or 0 if the queue was full.
+  uint32_t sendGCode(const char *gcode);
+  CommandState getCommandState(uint32_t id) { return _commands.state(id); }
+  uint8_t getPendingCommands() { return _commands.pending(); }
   void setBedTarget(float temp);
   void setToolTarget(float temp);
   void adjustBed(float delta);
@@ -35,118 +80,214 @@ public:
 
   // Printer Data
   void setPrinterIP(const char *ip);
-  String getPrinterIP() { return _printerIP; }
-  void updatePrinterStatus();
-  float getBedTemp() { return _bedTemp; }
-  float getBedTarget() { return _bedTarget; }
-  float getToolTemp() { return _toolTemps[_selectedTool]; }
-  float getToolTarget() { return _toolTargets[_selectedTool]; }
+  String getPrinterIP() {
+    NetLock lock(_lock);
+    return _printerIP;
+  }
+  void requestPoll(); // Ask the network task to poll immediately
+  uint32_t getModelSeq() { return _viewSeq; }
+  const PrinterModel &getModel() { return _view; }
+#ifdef UI_BENCHMARK
+  // UI thread only: show a synthetic model until loop() next picks up a
+  // published snapshot
+  void benchSetModel(const PrinterModel &m) {
+    _view = m;
+    _viewSeq++;
+  }
+  void benchSetFilaments(FilamentCatalog &catalog) {
+    {
+      NetLock lock(_lock);
+      _filaments.swap(catalog);
+    }
+    _filamentSeq++;
+  }
+  // Heater history from the shown model, on the network task's clock
+  void benchSampleHistory(uint32_t now) {
+    if (!_history.due(now))
+      return;
+    {
+      NetLock lock(_lock);
+      _history.sample(now, _view);
+    }
+    _historySeq++;
+  }
+#endif
+  float getBedTemp() {
+    return _view.heaterCount ? _view.heaters[0].current : 0;
+  }
+  // Targets read back a setpoint the UI asked for until a published
+  // snapshot carries it, so repeated +/- taps build on each other
+  float getBedTarget() {
+    float v;
+    if (_commands.setpoint(CMD_SETPOINT_BED, _viewSeq, v))
+      return v;
+    return _view.heaterCount ? _view.heaters[0].active : 0;
+  }
+  float getToolTemp() {
+    const HeaterReading *h = _view.toolHeaterReading(_selectedTool);
+    return h ? h->current : 0;
+  }
+  float getToolTarget() {
+    float v;
+    if (_selectedTool >= 0 && _selectedTool < PM_MAX_TOOLS &&
+        _commands.setpoint(CMD_SETPOINT_TOOL(_selectedTool), _viewSeq, v))
+      return v;
+    const HeaterReading *h = _view.toolHeaterReading(_selectedTool);
+    return h ? h->active : 0;
+  }
   int getSelectedTool() { return _selectedTool; }
   void setSelectedTool(int idx) {
     Serial.printf("NET: Tool change to %d\n", idx);
     _selectedTool = idx;
-    saveSettings();
+    requestSave();
   }
-  int getToolCount() { return _toolCount; }
-  float getProgress() { return _progress; }
+  int getToolCount() { return _view.toolCount; }
+  float getProgress() { return _view.progress; }
   uint32_t getPollInterval() { return _pollInterval; }
   void setPollInterval(uint32_t ms) {
     _pollInterval = ms;
-    saveSettings();
+    requestSave();
   }
+  PollMode getPollMode() { return _pollMode; }
+  uint32_t getRequestCount() { return _requestCount; }
 
   int getActiveAFCUnit() { return _activeAFCUnit; }
   void setActiveAFCUnit(int unit) {
     _activeAFCUnit = unit;
-    saveSettings();
+    requestSave();
   }
-  int getUnitCount() { return _unitCount; }
+  int getUnitCount() { return _view.unitCount; }
+  int getUnitLanes(int unit) { return _view.laneCount(unit); }
 
-  bool isLaneLoaded(int idx) {
-    if (idx >= 0 && idx < 32)
-      return _laneLoaded[idx];
-    return false;
+  bool isLaneLoaded(int unit, int lane) {
+    const LaneInfo *l = _view.lane(unit, lane);
+    return l && l->loaded;
   }
 
-  String getLaneName(int idx) {
-    if (idx >= 0 && idx < 32)
-      return _laneNames[idx];
-    return "";
+  String getLaneName(int unit, int lane) {
+    const LaneInfo *l = _view.lane(unit, lane);
+    return l ? l->filament : "";
   }
   int getLaneToTool(int unit, int lane) {
-    // Access AFC_lane_to_tool[unit][lane] from the global model
-    if (_modelGlobal.containsKey("AFC_lane_to_tool")) {
-      JsonArray units = _modelGlobal["AFC_lane_to_tool"].as<JsonArray>();
-      if (unit >= 0 && unit < units.size()) {
-        JsonArray lanes = units[unit].as<JsonArray>();
-        if (lane >= 0 && lane < lanes.size()) {
-          return lanes[lane].as<int>();
-        }
-      }
-    }
+    // AFC_lane_to_tool[unit][lane]
+    const LaneInfo *l = _view.lane(unit, lane);
+    if (l && l->tool >= 0)
+      return l->tool;
     // Fallback to calculated tool index if data not available
-    return unit * 4 + lane;
+    return _view.laneNumber(unit, lane);
   }
 
   int getLEDColor(int unit, int lane) {
-    // Access AFC_LED_array[unit][lane] from the global model
+    // AFC_LED_array[unit][lane]
     // Returns: 0=red, 1=green, 2=blue, 3=white, 4=yellow, 5=magenta, 6=cyan
-    if (_modelGlobal.containsKey("AFC_LED_array")) {
-      JsonArray units = _modelGlobal["AFC_LED_array"].as<JsonArray>();
-      if (unit >= 0 && unit < units.size()) {
-        JsonArray lanes = units[unit].as<JsonArray>();
-        if (lane >= 0 && lane < lanes.size()) {
-          return lanes[lane].as<int>();
-        }
-      }
-    }
-    return -1; // No LED data available
+    const LaneInfo *l = _view.lane(unit, lane);
+    return l ? l->led : LED_UNKNOWN; // -1 when no LED data available
   }
 
   // Filament List Management
-  void fetchFilamentList();
-  int getFilamentCount() { return _filamentList.size(); }
+  void fetchFilamentList(); // Queues a refresh; the list updates in place
+  uint32_t getFilamentSeq() { return _filamentSeq; }
+  int getFilamentCount() {
+    NetLock lock(_lock);
+    return _filaments.count();
+  }
   String getFilamentName(int idx) {
-    if (idx >= 0 && idx < _filamentList.size())
-      return _filamentList[idx];
-    return "";
+    NetLock lock(_lock);
+    return (idx >= 0 && idx < _filaments.count()) ? _filaments.name(idx) : "";
+  }
+  void copyFilamentName(int idx, char *buf, size_t len) {
+    NetLock lock(_lock);
+    strlcpy(buf, (idx >= 0 && idx < _filaments.count()) ? _filaments.name(idx)
+                                                        : "",
+            len);
   }
+  // Catalog indices matching query, see FilamentCatalog::search(). Valid
+  // until getFilamentSeq() changes.
+  uint16_t searchFilaments(const char *query, uint16_t *out, uint16_t max,
+                           const uint16_t *within = NULL,
+                           uint16_t withinCount = 0) {
+    NetLock lock(_lock);
+    return _filaments.search(query, out, max, within, withinCount);
+  }
+  // Temperature history, see TempHistory. getTempHistorySeq() moves on
+  // every sample; points are numbered per tier from 0 since boot.
+  uint32_t getTempHistorySeq() { return _historySeq; }
+  uint32_t getTempHistoryEnd(TempTier t) {
+    NetLock lock(_lock);
+    return _history.end(t);
+  }
+  uint16_t readTempHistory(TempTier t, int sensor, uint32_t from,
+                           TempPoint *out, uint16_t max) {
+    NetLock lock(_lock);
+    return _history.read(t, sensor, from, out, max);
+  }
+
   void setLaneFilament(int unit, int lane, String filamentName);
   String getLaneFilament(int unit, int lane);
 
   String getModelJSON(); // Returns serialized current model
 
 private:
+  static void taskEntry(void *arg);
+  void taskLoop();
+  void serviceWiFi();
+  void processRequest(const NetRequest &req);
+  void flushCommands();
+  void applySetpoint(int8_t setpoint, float value);
+  bool postRequest(const NetRequest &req);
+  bool resolvePrinter(String &targetIP);
+  PollActivity pollActivity();
+  bool updatePrinterStatus(PollKey key); // True when the key was decoded
+  bool pollKey(const String &host, PollKey key);
+  bool pollBySeqs(const String &host);
+  bool requestModel(const String &host, const char *key,
+                    DynamicJsonDocument &doc);
+  void storeModelKey(const char *key, JsonVariantConst res);
+  void publishModel();
+  void sampleHistory();
+  void sendHistoryJSON();
+  bool doSendGCode(const char *gcode);
+  void doFetchFilamentList();
   void loadSettings();
-  void saveSettings();
-
-  DynamicJsonDocument _modelHeat{8192};
-  DynamicJsonDocument _modelGlobal{8192}; // Increased for AFC arrays
-  DynamicJsonDocument _modelState{4096};
-  DynamicJsonDocument _modelJob{4096};
-  DynamicJsonDocument _modelNetwork{2048};
-  DynamicJsonDocument _modelTools{8192};
+  void saveSettings(); // Network task; other tasks call requestSave()
+  void requestSave() { _saveRequested = true; }
+
+  // Network task / UI hand-off
+  TaskHandle_t _task = NULL;
+  TaskHandle_t _uiTask = NULL;
+  QueueHandle_t _requests = NULL;
+  SemaphoreHandle_t _lock = NULL;
+  CommandQueue _commands;
+  SnapshotBuffer<PrinterModel> _snapshot;
+  PrinterModel _work; // Owned by the network task
+  PrinterModel _view; // Owned by the UI thread
+  uint32_t _viewSeq = 0;
+
+  // Keep-alive sockets to the printer: one for polling, one for commands
+  PrinterLink _pollLink;
+  PrinterLink _cmdLink;
+
+#ifdef NET_MODEL_MIRROR
+  // Debug only: last filtered response per key, served raw from /model
+  DynamicJsonDocument _modelRaw{16384};
+#endif
   String _ssid;
   String _password;
   String _printerIP;
 
-  String _status = "Disconnected";
-  String _printerName = "PanelDue SC01+ v" FIRMWARE_VERSION;
-  float _bedTemp = 0;
-  float _bedTarget = 0;
-  float _toolTemps[10] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-  float _toolTargets[10] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-  int _toolCount = 1;
   int _selectedTool = 0;
-  float _progress = 0;
   uint32_t _pollInterval = 1500;
   uint32_t _lastUpdate = 0;
-  uint8_t _queryIndex = 0;
+  PollScheduler _scheduler;
+  uint32_t _lastActivityTime = 0; // Last command sent, drives PA_BOOST
+  PollMode _pollMode = POLL_SEQS;
+  bool _seqsSupported = true; // Cleared if the firmware reports no seqs
+  ModelSeqs _seqs;            // Counters at each branch's last refetch
+  std::atomic<uint32_t> _requestCount{0};
+  uint32_t _lastParseUs = 0;  // Time spent in the last model deserialize
+  size_t _peakDocBytes = 0;   // Largest filtered model document seen
 
   int _activeAFCUnit = 0;
-  int _unitCount = 1;
-  bool _laneLoaded[32] = {false};
-  String _laneNames[32];
 
   uint32_t _lastCommandTime = 0;
   uint32_t _commandLockout = 3000; // 3 seconds lockout on UI updates
@@ -161,12 +302,16 @@ private:
   Preferences _prefs;
 
   // Filament list
-  std::vector<String> _filamentList;
+  FilamentCatalog _filaments;
+  std::atomic<uint32_t> _filamentSeq{0};
   uint32_t _lastFilamentFetch = 0;
 
-  // content
-  IPAddress _cachedIP;
-  bool _ipResolved = false;
+  HostResolver _resolver; // Printer address, network task only
+
+  // Heater history, written by the network task on a 2 s clock
+  TempHistory _history;
+  std::atomic<uint32_t> _historySeq{0};
+  std::atomic<bool> _saveRequested{false}; // NVS write due on the net task
 };
 
 extern NetworkManager DataManager;
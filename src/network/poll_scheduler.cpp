@@ -0,0 +1,120 @@
+#include "poll_scheduler.h"
+#include <string.h>
+
+#define PS_MIN_GAP_MS 100  // Request rate cap: at most 10 per second
+#define PS_OFFLINE_MS 5000 // Probe interval while the printer is away
+#define PS_FAST_MS 500     // Live values while printing or after a command
+
+// Period markers relative to the poll interval from the settings
+#define PS_BASE 0
+#define PS_BASE_X4 1
+
+struct PollKeyInfo {
+  const char *name;
+  uint8_t priority; // Higher wins when several keys are due
+  // Target period per activity: idle, normal, printing, boost
+  uint32_t period[PA_COUNT - 1];
+};
+
+// Live values follow the poll interval from the settings; the slow-moving
+// branches have fixed periods and only speed up around AFC activity.
+static const PollKeyInfo kKeys[PK_COUNT] = {
+    {"", 3, {PS_BASE_X4, PS_BASE, PS_FAST_MS, PS_FAST_MS}},
+    {"state", 3, {PS_BASE_X4, PS_BASE, PS_FAST_MS, PS_FAST_MS}},
+    {"heat", 3, {PS_BASE_X4, PS_BASE, PS_FAST_MS, PS_FAST_MS}},
+    {"job", 2, {30000, 5000, 1000, 5000}},
+    {"tools", 1, {60000, 30000, 30000, 5000}},
+    {"network", 0, {60000, 60000, 60000, 60000}},
+    {"global.AFC_lanes", 2, {60000, 10000, 10000, 1000}},
+    {"global.AFC_LED_array", 2, {60000, 10000, 10000, 1000}},
+    {"global.AFC_lane_to_tool", 1, {60000, 30000, 30000, 2000}},
+    {"global.AFC_unit_total_lanes", 0, {60000, 60000, 60000, 10000}},
+};
+
+PollScheduler::PollScheduler() {
+  memset(_last, 0, sizeof(_last));
+  memset(_fetched, 0, sizeof(_fetched));
+  memset(_failedAt, 0, sizeof(_failedAt));
+  memset(_failed, 0, sizeof(_failed));
+  memset(_maxLate, 0, sizeof(_maxLate));
+  memset(_fetches, 0, sizeof(_fetches));
+}
+
+const char *PollScheduler::keyName(PollKey key) {
+  return key < PK_COUNT ? kKeys[key].name : "";
+}
+
+const char *PollScheduler::activityName(PollActivity a) {
+  static const char *const names[PA_COUNT] = {"offline", "idle", "normal",
+                                              "printing", "boost"};
+  return a < PA_COUNT ? names[a] : "";
+}
+
+uint32_t PollScheduler::period(PollKey key) const {
+  if (_activity == PA_OFFLINE)
+    return PS_OFFLINE_MS;
+  uint32_t p = kKeys[key].period[_activity - 1];
+  if (p == PS_BASE)
+    return _baseInterval;
+  if (p == PS_BASE_X4)
+    return 4 * _baseInterval;
+  return p;
+}
+
+uint32_t PollScheduler::age(PollKey key, uint32_t now) const {
+  return _fetched[key] ? now - _last[key] : UINT32_MAX;
+}
+
+void PollScheduler::expedite() {
+  memset(_fetched, 0, sizeof(_fetched));
+  memset(_failed, 0, sizeof(_failed));
+}
+
+int PollScheduler::next(uint32_t now) {
+  if (_issued && now - _lastIssue < PS_MIN_GAP_MS)
+    return -1;
+
+  uint32_t mask = _activity == PA_OFFLINE ? PK_MASK(_probe) : _enabled;
+  int best = -1;
+  uint32_t bestLate = 0;
+  for (int k = 0; k < PK_COUNT; k++) {
+    if (!(mask & PK_MASK(k)))
+      continue;
+    PollKey key = (PollKey)k;
+    uint32_t a = age(key, now);
+    uint32_t p = period(key);
+    if (a < p || (_failed[k] && now - _failedAt[k] < p))
+      continue;
+    uint32_t late = a - p;
+    if (best < 0 || kKeys[k].priority > kKeys[best].priority ||
+        (kKeys[k].priority == kKeys[best].priority && late > bestLate)) {
+      best = k;
+      bestLate = late;
+    }
+  }
+
+  if (best >= 0) {
+    _issued = true;
+    _lastIssue = now;
+  }
+  return best;
+}
+
+void PollScheduler::markFetched(PollKey key, uint32_t now) {
+  if (_fetched[key]) {
+    // Staleness beyond the target, measured at refresh time
+    uint32_t a = now - _last[key];
+    uint32_t p = period(key);
+    if (a > p && a - p > _maxLate[key])
+      _maxLate[key] = a - p;
+  }
+  _last[key] = now;
+  _fetched[key] = true;
+  _failed[key] = false;
+  _fetches[key]++;
+}
+
+void PollScheduler::markFailed(PollKey key, uint32_t now) {
+  _failedAt[key] = now;
+  _failed[key] = true;
+}
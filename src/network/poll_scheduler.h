@@ -0,0 +1,77 @@
+#pragma once
+#include <stdint.h>
+
+// Object-model requests the scheduler can issue
+enum PollKey : uint8_t {
+  PK_LIVE, // rr_model?flags=d99fn: heat, tools, state, job and seqs
+  PK_STATE,
+  PK_HEAT,
+  PK_JOB,
+  PK_TOOLS,
+  PK_NETWORK,
+  PK_AFC_LANES,
+  PK_AFC_LED,
+  PK_AFC_LANE_TO_TOOL,
+  PK_AFC_UNIT_LANES,
+  PK_COUNT,
+};
+
+#define PK_MASK(k) (1u << (k))
+
+// What the printer and the user are doing; selects the period column
+enum PollActivity : uint8_t {
+  PA_OFFLINE,  // Only the probe key, slowly
+  PA_IDLE,     // Nothing happening for a while
+  PA_NORMAL,
+  PA_PRINTING, // Job running: temperatures and progress matter
+  PA_BOOST,    // Just after a user command: AFC and heaters move
+  PA_COUNT,
+};
+
+// Chooses which object-model key to fetch next.
+//
+// Every key has a priority and a target refresh period per activity level.
+// Each call to next() returns at most one key: the highest-priority key
+// whose period has elapsed, breaking ties by how far past due it is. A
+// minimum gap between requests caps the total request rate, so when the
+// link is saturated low-priority keys slip first.
+//
+// Pure logic with caller-supplied time, no Arduino dependencies.
+class PollScheduler {
+public:
+  PollScheduler();
+
+  void setEnabled(uint32_t mask) { _enabled = mask; }
+  void setProbe(PollKey key) { _probe = key; } // Polled while offline
+  void setBaseInterval(uint32_t ms) { _baseInterval = ms; }
+  void setActivity(PollActivity a) { _activity = a; }
+  PollActivity activity() const { return _activity; }
+
+  void expedite(); // Make every enabled key due now
+  int next(uint32_t now);
+  void markFetched(PollKey key, uint32_t now); // Decoded successfully
+  // Request or decode failed: the key keeps ageing, and is retried one
+  // period after the attempt rather than on every call to next()
+  void markFailed(PollKey key, uint32_t now);
+
+  uint32_t period(PollKey key) const;
+  uint32_t age(PollKey key, uint32_t now) const;
+  uint32_t maxLate(PollKey key) const { return _maxLate[key]; }
+  uint32_t fetches(PollKey key) const { return _fetches[key]; }
+  static const char *keyName(PollKey key); // "" for PK_LIVE
+  static const char *activityName(PollActivity a);
+
+private:
+  uint32_t _enabled = 0;
+  PollKey _probe = PK_STATE;
+  uint32_t _baseInterval = 1500;
+  PollActivity _activity = PA_NORMAL;
+  uint32_t _lastIssue = 0;
+  bool _issued = false;
+  uint32_t _last[PK_COUNT];
+  bool _fetched[PK_COUNT];
+  uint32_t _failedAt[PK_COUNT];
+  bool _failed[PK_COUNT];
+  uint32_t _maxLate[PK_COUNT];
+  uint32_t _fetches[PK_COUNT];
+};
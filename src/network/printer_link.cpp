@@ -0,0 +1,136 @@
+#include "printer_link.h"
+#include <algorithm>
+
+PrinterLink::PrinterLink() {
+  _http.setReuse(true);
+}
+
+void PrinterLink::setHost(const String &host) {
+  if (host == _host)
+    return;
+  close();
+  _host = host;
+}
+
+// Failures that mean a kept-alive socket had already been closed by the
+// printer, not that the request went out and the response was slow
+static bool stale_socket(int httpCode) {
+  return httpCode == HTTPC_ERROR_CONNECTION_LOST ||
+         httpCode == HTTPC_ERROR_SEND_HEADER_FAILED;
+}
+
+int PrinterLink::get(const String &uri, uint16_t timeoutMs, bool idempotent) {
+  uint32_t start = millis();
+  int httpCode = HTTPC_ERROR_CONNECTION_REFUSED;
+  bool reused = false;
+
+#ifdef LINK_FAULT_INJECT
+  delay(LINK_FAULT_DELAY_MS + random(LINK_FAULT_JITTER_MS + 1));
+  if (random(100) < LINK_FAULT_DROP_PCT) {
+    close();
+    recordLatency(millis() - start);
+    recordTrace(start, uri, HTTPC_ERROR_CONNECTION_LOST, false);
+    return HTTPC_ERROR_CONNECTION_LOST;
+  }
+#endif
+
+  // At most one retry, and only when a kept-alive socket turned out stale
+  for (int attempt = 0; attempt < 2; attempt++) {
+    reused = _client.connected();
+    _http.setTimeout(timeoutMs);
+    _http.setConnectTimeout(timeoutMs);
+    _http.begin(_client, _host, 80, uri);
+    httpCode = _http.GET();
+
+    if (httpCode > 0 || !reused || !idempotent || !stale_socket(httpCode)) {
+      if (reused)
+        _reuses++;
+      else
+        _connects++;
+      break;
+    }
+    // The printer closed the idle socket: reconnect transparently
+    close();
+  }
+  // A late response to a timed-out request must not be read as the answer
+  // to the next one
+  if (httpCode <= 0)
+    close();
+
+  recordLatency(millis() - start);
+  recordTrace(start, uri, httpCode, reused);
+  return httpCode;
+}
+
+bool PrinterLink::canStream() {
+  // Chunked responses report -1; those have to go through getString()
+  return _http.getSize() > 0;
+}
+
+void PrinterLink::end() {
+  // Drains any unread body and keeps the socket open when the printer
+  // allowed keep-alive
+  _http.end();
+}
+
+void PrinterLink::close() {
+  _http.end();
+  _client.stop();
+}
+
+void PrinterLink::recordLatency(uint32_t ms) {
+  _latency[_latencyHead] = ms > 0xFFFF ? 0xFFFF : ms;
+  _latencyHead = (_latencyHead + 1) % LINK_LATENCY_SAMPLES;
+  if (_latencyCount < LINK_LATENCY_SAMPLES)
+    _latencyCount++;
+}
+
+uint32_t PrinterLink::latencyPercentile(uint8_t pct) const {
+  if (_latencyCount == 0)
+    return 0;
+  uint16_t sorted[LINK_LATENCY_SAMPLES];
+  memcpy(sorted, _latency, sizeof(uint16_t) * _latencyCount);
+  size_t k = (size_t)(_latencyCount - 1) * pct / 100;
+  std::nth_element(sorted, sorted + k, sorted + _latencyCount);
+  return sorted[k];
+}
+
+void PrinterLink::recordTrace(uint32_t start, const String &uri, int code,
+                              bool reused) {
+  LinkTrace &t = _trace[_traceHead];
+  t.atMs = start;
+  uint32_t ms = millis() - start;
+  t.ms = ms > 0xFFFF ? 0xFFFF : ms;
+  t.code = code;
+  t.bytes = code > 0 ? _http.getSize() : -1;
+  t.reused = reused;
+  strlcpy(t.uri, uri.c_str(), sizeof(t.uri));
+  _traceHead = (_traceHead + 1) % LINK_TRACE_DEPTH;
+  if (_traceCount < LINK_TRACE_DEPTH)
+    _traceCount++;
+}
+
+void PrinterLink::traceJSON(String &out) const {
+  out += "[";
+  uint8_t first = (_traceHead + LINK_TRACE_DEPTH - _traceCount) %
+                  LINK_TRACE_DEPTH;
+  for (uint8_t i = 0; i < _traceCount; i++) {
+    const LinkTrace &t = _trace[(first + i) % LINK_TRACE_DEPTH];
+    if (i > 0)
+      out += ",";
+    out += "{\"t\":" + String(t.atMs);
+    out += ",\"ms\":" + String(t.ms);
+    out += ",\"code\":" + String(t.code);
+    out += ",\"bytes\":" + String(t.bytes);
+    out += ",\"reused\":" + String(t.reused ? "true" : "false");
+    out += ",\"uri\":\"";
+    // URIs are already percent-encoded; only '"' and '\\' need escaping
+    for (const char *p = t.uri; *p; p++) {
+      if (*p == '"' || *p == '\\')
+        out += '\\';
+      out += *p;
+    }
+    out += "\"}";
+  }
+  out += "]";
+}
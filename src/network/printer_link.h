@@ -0,0 +1,83 @@
+#pragma once
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <WiFi.h>
+
+#define LINK_LATENCY_SAMPLES 64
+#define LINK_TRACE_DEPTH 32
+
+// Debug: degrade every request to see how polling copes with a slow or
+// lossy printer. Enable with -D LINK_FAULT_INJECT.
+#ifdef LINK_FAULT_INJECT
+#ifndef LINK_FAULT_DELAY_MS
+#define LINK_FAULT_DELAY_MS 150 // Added before each request
+#endif
+#ifndef LINK_FAULT_JITTER_MS
+#define LINK_FAULT_JITTER_MS 100 // Uniform extra delay, 0..N
+#endif
+#ifndef LINK_FAULT_DROP_PCT
+#define LINK_FAULT_DROP_PCT 5 // Requests failed as a dropped connection
+#endif
+#endif
+
+// One completed request, for comparing polling strategies
+struct LinkTrace {
+  uint32_t atMs;  // millis() when the request started
+  uint16_t ms;    // Time to response headers, including any retry
+  int16_t code;   // HTTP code, <= 0 for transport errors
+  int32_t bytes;  // Content-Length, -1 when chunked or unknown
+  bool reused;    // Went out on a kept-alive socket
+  char uri[40];   // Truncated request URI
+};
+
+// A persistent HTTP/1.1 keep-alive connection to the printer. Requests on
+// one link are issued back to back over the same socket. If the printer
+// has closed it in the meantime, an idempotent request is retried once on a
+// fresh connection; others are never retried, since the printer may have
+// received the request before the socket failed. Only used from the
+// network task.
+class PrinterLink {
+public:
+  PrinterLink();
+
+  // Point the link at a (resolved) printer address. Changing the address
+  // drops the current socket.
+  void setHost(const String &host);
+
+  // Issue a GET and return the HTTP code (<= 0 on transport errors). On
+  // success the body is left pending: read it with stream()/body() and
+  // always call end() afterwards so the socket can be reused. Pass
+  // idempotent = false for requests with side effects (rr_gcode).
+  int get(const String &uri, uint16_t timeoutMs, bool idempotent = true);
+
+  // Body access for the current response
+  bool canStream(); // Content-Length known, so the raw socket is the body
+  int size() { return _http.getSize(); } // Content-Length, -1 if unknown
+  Stream &stream() { return _http.getStream(); }
+  String body() { return _http.getString(); }
+  void end();
+
+  void close(); // Drop the socket, e.g. when the printer went offline
+
+  // Statistics
+  uint32_t connects() const { return _connects; }
+  uint32_t reuses() const { return _reuses; }
+  uint32_t latencyPercentile(uint8_t pct) const; // ms over recent requests
+  void traceJSON(String &out) const; // Recent requests, oldest first
+
+private:
+  void recordLatency(uint32_t ms);
+  void recordTrace(uint32_t start, const String &uri, int code, bool reused);
+
+  WiFiClient _client;
+  HTTPClient _http;
+  String _host;
+  uint32_t _connects = 0;
+  uint32_t _reuses = 0;
+  uint16_t _latency[LINK_LATENCY_SAMPLES] = {0};
+  uint8_t _latencyCount = 0;
+  uint8_t _latencyHead = 0;
+  LinkTrace _trace[LINK_TRACE_DEPTH];
+  uint8_t _traceCount = 0;
+  uint8_t _traceHead = 0;
+};
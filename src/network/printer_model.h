@@ -0,0 +1,214 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+#define PM_MAX_HEATERS 12
+#define PM_MAX_TOOLS 10
+#define PM_MAX_UNITS 8
+#define PM_MAX_UNIT_LANES 8 // Lanes per unit the model has room for
+#define PM_DEFAULT_UNIT_LANES 4 // A BoxTurtle, until AFC reports otherwise
+#define PM_MAX_LANES (PM_MAX_UNITS * PM_MAX_UNIT_LANES)
+#define PM_NAME_LEN 32
+
+// state.status as reported by RRF, plus the connection states of the panel
+enum PrinterStatus : uint8_t {
+  PS_DISCONNECTED,
+  PS_CONNECTING,
+  PS_CONNECTED,
+  PS_FAILED,
+  PS_OFFLINE,
+  PS_STARTING,
+  PS_UPDATING,
+  PS_OFF,
+  PS_HALTED,
+  PS_PAUSING,
+  PS_PAUSED,
+  PS_RESUMING,
+  PS_CANCELLING,
+  PS_PROCESSING,
+  PS_SIMULATING,
+  PS_BUSY,
+  PS_CHANGING_TOOL,
+  PS_IDLE,
+  PS_UNKNOWN,
+};
+
+// AFC_LED_array values
+enum LedColor : int8_t {
+  LED_UNKNOWN = -1,
+  LED_RED = 0,
+  LED_GREEN,
+  LED_BLUE,
+  LED_WHITE,
+  LED_YELLOW,
+  LED_MAGENTA,
+  LED_CYAN,
+};
+
+// Display names, indexed by PrinterStatus
+static const char *const kPrinterStatusNames[] = {
+    "Disconnected", "Connecting...", "Connected",  "Failed",
+    "Offline",      "Starting",      "Updating",   "Off",
+    "Halted",       "Pausing",       "Paused",     "Resuming",
+    "Cancelling",   "Processing",    "Simulating", "Busy",
+    "ChangingTool", "Idle",          "Unknown"};
+
+inline const char *printerStatusName(PrinterStatus s) {
+  return kPrinterStatusNames[s <= PS_UNKNOWN ? s : PS_UNKNOWN];
+}
+
+// Map an RRF state.status string onto the enum
+inline PrinterStatus parsePrinterStatus(const char *s) {
+  static const struct {
+    const char *name;
+    PrinterStatus status;
+  } map[] = {{"disconnected", PS_DISCONNECTED},
+             {"starting", PS_STARTING},
+             {"updating", PS_UPDATING},
+             {"off", PS_OFF},
+             {"halted", PS_HALTED},
+             {"pausing", PS_PAUSING},
+             {"paused", PS_PAUSED},
+             {"resuming", PS_RESUMING},
+             {"cancelling", PS_CANCELLING},
+             {"processing", PS_PROCESSING},
+             {"simulating", PS_SIMULATING},
+             {"busy", PS_BUSY},
+             {"changingTool", PS_CHANGING_TOOL},
+             {"idle", PS_IDLE}};
+  for (auto &m : map) {
+    if (strcmp(s, m.name) == 0)
+      return m.status;
+  }
+  return PS_UNKNOWN;
+}
+
+struct HeaterReading {
+  float current;
+  float active;
+};
+
+struct LaneInfo {
+  bool loaded;
+  int16_t tool;     // AFC_lane_to_tool, -1 when unknown
+  LedColor led;     // AFC_LED_array
+  char filament[PM_NAME_LEN]; // AFC_lanes[unit][lane][4][0]
+
+  void clear() {
+    loaded = false;
+    tool = -1;
+    led = LED_UNKNOWN;
+    filament[0] = '\0';
+  }
+};
+
+// Plain-data view of the printer that the network task publishes for the UI.
+// Everything is fixed size so a snapshot can be copied with a single memcpy,
+// and every getter is a field read.
+struct PrinterModel {
+  PrinterStatus status = PS_DISCONNECTED;
+  char printerName[48] = "PanelDue SC01+";
+  HeaterReading heaters[PM_MAX_HEATERS] = {};
+  uint8_t heaterCount = 0;
+  int8_t toolHeater[PM_MAX_TOOLS]; // tools[i].heaters[0], -1 when unknown
+  uint8_t toolCount = 1;
+  uint32_t filePosition = 0;
+  uint32_t fileSize = 0;
+  float progress = 0;
+  uint8_t unitCount = 1;
+  uint8_t unitLanes[PM_MAX_UNITS]; // AFC_unit_total_lanes, per unit
+  // Lane l of unit u is lanes[u * PM_MAX_UNIT_LANES + l], so a lane keeps
+  // its slot whatever shape the other units have
+  LaneInfo lanes[PM_MAX_LANES];
+
+  // Panel's own WiFi link, so the UI never queries the WiFi driver
+  bool wifiConnected = false;
+  uint32_t localIP = 0;
+  char ssid[33] = "";
+
+  PrinterModel() {
+    memset(toolHeater, 0xFF, sizeof(toolHeater));
+    memset(unitLanes, PM_DEFAULT_UNIT_LANES, sizeof(unitLanes));
+    for (auto &l : lanes)
+      l.clear();
+  }
+
+  bool isOffline() const { return status == PS_OFFLINE; }
+
+  // Heater driving a tool, or NULL when tools/heat have not been seen yet
+  HeaterReading *toolHeaterReading(int tool) {
+    if (tool < 0 || tool >= PM_MAX_TOOLS)
+      return NULL;
+    int h = toolHeater[tool];
+    return (h >= 0 && h < heaterCount) ? &heaters[h] : NULL;
+  }
+  const HeaterReading *toolHeaterReading(int tool) const {
+    return const_cast<PrinterModel *>(this)->toolHeaterReading(tool);
+  }
+
+  static int laneIndex(int unit, int lane) {
+    return unit * PM_MAX_UNIT_LANES + lane;
+  }
+
+  // Lanes of a unit, 0 for units that are not there
+  int laneCount(int unit) const {
+    return (unit >= 0 && unit < unitCount && unit < PM_MAX_UNITS)
+               ? unitLanes[unit]
+               : 0;
+  }
+
+  // Position of a lane counted across all units, as AFC numbers tools when
+  // AFC_lane_to_tool has not been seen
+  int laneNumber(int unit, int lane) const {
+    int n = lane;
+    for (int u = 0; u < unit && u < PM_MAX_UNITS; u++)
+      n += unitLanes[u];
+    return n;
+  }
+
+  const LaneInfo *lane(int unit, int lane) const {
+    if (unit < 0 || unit >= PM_MAX_UNITS || lane < 0 ||
+        lane >= PM_MAX_UNIT_LANES)
+      return NULL;
+    return &lanes[laneIndex(unit, lane)];
+  }
+};
+
+// Single-writer, multi-reader publication of a POD snapshot (a seqlock over
+// two buffers). The sequence number counts two per publish and is odd while
+// the writer copies into the buffer the readers are not pointed at. Readers
+// never block: they copy the last complete buffer and retry if a later
+// publish started writing into that same buffer during the copy.
+template <typename T> class SnapshotBuffer {
+public:
+  // Writer side (network task only)
+  void publish(const T &value) {
+    uint32_t s = _seq.load(std::memory_order_relaxed);
+    _seq.store(s + 1, std::memory_order_release);
+    // Keeps the copy below from becoming visible before the odd number
+    std::atomic_thread_fence(std::memory_order_release);
+    _buf[((s >> 1) + 1) & 1] = value;
+    _seq.store(s + 2, std::memory_order_release);
+  }
+
+  // Reader side: returns the number of the copied snapshot (1 for the
+  // first publish)
+  uint32_t read(T &out) const {
+    for (;;) {
+      uint32_t s = _seq.load(std::memory_order_acquire);
+      out = _buf[(s >> 1) & 1];
+      std::atomic_thread_fence(std::memory_order_acquire);
+      // The next publish into that buffer first stores (s & ~1) + 3
+      if (_seq.load(std::memory_order_relaxed) - (s & ~1u) <= 2)
+        return s >> 1;
+    }
+  }
+
+  // Snapshots published so far
+  uint32_t seq() const { return _seq.load(std::memory_order_acquire) >> 1; }
+
+private:
+  std::atomic<uint32_t> _seq{0};
+  T _buf[2];
+};
@@ -0,0 +1,64 @@
+#include "temp_history.h"
+
+#define TH_BUCKET (TH_COARSE_MS / TH_FINE_MS) // Fine samples per coarse point
+
+int16_t TempHistory::encode(float c) {
+  float v = c * 10.0f + (c < 0 ? -0.5f : 0.5f);
+  if (v != v || v <= TH_NONE)
+    return TH_NONE + 1; // NaN and the far negative end clamp just above
+  return v >= INT16_MAX ? INT16_MAX : (int16_t)v;
+}
+
+TempPoint *TempHistory::row(TempTier t, uint32_t idx) {
+  return t == TT_FINE ? _fine[idx % TH_FINE_LEN]
+                      : _coarse[idx % TH_COARSE_LEN];
+}
+
+uint32_t TempHistory::first(TempTier t) const {
+  return _end[t] > capacity(t) ? _end[t] - capacity(t) : 0;
+}
+
+void TempHistory::sample(uint32_t now, const PrinterModel &m) {
+  // Keep to the grid; after a long stall start again from now
+  _next = (_started && now - _next < TH_FINE_MS) ? _next + TH_FINE_MS
+                                                  : now + TH_FINE_MS;
+  _started = true;
+
+  bool online = !m.isOffline() && m.status != PS_DISCONNECTED;
+  TempPoint *fine = row(TT_FINE, _end[TT_FINE]);
+  for (int s = 0; s < TH_SENSORS; s++) {
+    if (online && s < m.heaterCount) {
+      fine[s].current = encode(m.heaters[s].current);
+      fine[s].target = encode(m.heaters[s].active);
+      _sum[s] += fine[s].current;
+      _valid[s]++;
+    } else {
+      fine[s].current = fine[s].target = TH_NONE;
+    }
+  }
+  _end[TT_FINE]++;
+
+  if (++_fill < TH_BUCKET)
+    return;
+  TempPoint *coarse = row(TT_COARSE, _end[TT_COARSE]);
+  for (int s = 0; s < TH_SENSORS; s++) {
+    coarse[s].current = _valid[s] ? _sum[s] / _valid[s] : TH_NONE;
+    coarse[s].target = fine[s].target; // Setpoint at the end of the bucket
+    _sum[s] = 0;
+    _valid[s] = 0;
+  }
+  _fill = 0;
+  _end[TT_COARSE]++;
+}
+
+uint16_t TempHistory::read(TempTier t, int sensor, uint32_t from,
+                           TempPoint *out, uint16_t max) const {
+  if (sensor < 0 || sensor >= TH_SENSORS)
+    return 0;
+  if (from < first(t))
+    from = first(t);
+  uint16_t n = 0;
+  for (uint32_t i = from; i < _end[t] && n < max; i++)
+    out[n++] = row(t, i)[sensor];
+  return n;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "printer_model.h"
+
+#define TH_SENSORS 6 // Heaters 0..5 are recorded; heater 0 is usually the bed
+#define TH_NONE INT16_MIN // No reading: printer offline or heater missing
+
+// Resolutions, finest first
+enum TempTier : uint8_t {
+  TT_FINE,   // Every 2 s for the last 10 minutes
+  TT_COARSE, // 1-minute means for the last 6 hours
+  TT_COUNT,
+};
+
+#define TH_FINE_MS 2000
+#define TH_FINE_LEN 300 // 10 min
+#define TH_COARSE_MS 60000
+#define TH_COARSE_LEN 360 // 6 h
+
+// One point per heater: temperatures in fixed-point tenths of a degree,
+// which covers -3276.7 to 3276.7 °C in an int16_t
+struct TempPoint {
+  int16_t current;
+  int16_t target;
+};
+
+// Fixed-memory temperature history for the heaters.
+//
+// sample() is called on a steady clock and appends one point per heater to
+// the fine ring; every TH_COARSE_MS / TH_FINE_MS fine samples the mean of
+// the valid ones is appended to the coarse ring. All heaters share a ring
+// position, so one write index per tier serves every heater. Points are
+// numbered from 0 since boot: end() is one past the newest, and a reader
+// that remembers it can fetch just the points appended since.
+//
+// Memory is 4 bytes per heater per point:
+//   fine    1800 points/h -> 7,200 bytes per heater-hour (10 min kept)
+//   coarse    60 points/h ->   240 bytes per heater-hour (6 h kept)
+// With TH_SENSORS heaters the whole store is bytes() = 15,840 bytes.
+//
+// Pure C++, no Arduino dependencies.
+class TempHistory {
+public:
+  static uint32_t periodMs(TempTier t) {
+    return t == TT_FINE ? TH_FINE_MS : TH_COARSE_MS;
+  }
+  static uint16_t capacity(TempTier t) {
+    return t == TT_FINE ? TH_FINE_LEN : TH_COARSE_LEN;
+  }
+  static size_t bytes() { return sizeof(_fine) + sizeof(_coarse); }
+
+  static int16_t encode(float c);
+  static float decode(int16_t v) { return v / 10.0f; }
+
+  bool due(uint32_t now) const {
+    return !_started || (int32_t)(now - _next) >= 0;
+  }
+  void sample(uint32_t now, const PrinterModel &m);
+
+  uint32_t end(TempTier t) const { return _end[t]; }
+  uint32_t first(TempTier t) const; // Oldest point still held
+
+  // Copy the points numbered from `from` (or the oldest held, if later) up
+  // to end(), oldest first, for one heater. Returns the number written.
+  uint16_t read(TempTier t, int sensor, uint32_t from, TempPoint *out,
+                uint16_t max) const;
+
+private:
+  TempPoint *row(TempTier t, uint32_t idx);
+  const TempPoint *row(TempTier t, uint32_t idx) const {
+    return const_cast<TempHistory *>(this)->row(t, idx);
+  }
+
+  TempPoint _fine[TH_FINE_LEN][TH_SENSORS];
+  TempPoint _coarse[TH_COARSE_LEN][TH_SENSORS];
+  uint32_t _end[TT_COUNT] = {};
+  bool _started = false;
+  uint32_t _next = 0; // When the next fine sample is due
+
+  // Coarse bucket being filled
+  int32_t _sum[TH_SENSORS] = {};
+  uint8_t _valid[TH_SENSORS] = {};
+  uint8_t _fill = 0; // Fine samples in the bucket so far
+};
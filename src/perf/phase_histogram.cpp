@@ -0,0 +1,58 @@
+#include "phase_histogram.h"
+
+#define PH_SUB (1 << PH_SUB_BITS)
+
+int PhaseHistogram::bucket(uint32_t us) {
+  if (us < PH_SUB)
+    return us; // Exact below the first full octave
+  int octave = 31 - __builtin_clz(us);
+  int sub = (us >> (octave - PH_SUB_BITS)) & (PH_SUB - 1);
+  int b = ((octave - PH_SUB_BITS + 1) << PH_SUB_BITS) + sub;
+  return b < PH_BUCKETS ? b : PH_BUCKETS - 1;
+}
+
+uint32_t PhaseHistogram::bucketMax(int b) {
+  if (b < PH_SUB)
+    return b;
+  int octave = (b >> PH_SUB_BITS) + PH_SUB_BITS - 1;
+  uint32_t step = 1u << (octave - PH_SUB_BITS);
+  return ((uint32_t)(PH_SUB + (b & (PH_SUB - 1))) << (octave - PH_SUB_BITS)) +
+         step - 1;
+}
+
+void PhaseHistogram::add(uint32_t us) {
+  uint16_t &c = _counts[bucket(us)];
+  if (c < UINT16_MAX)
+    c++;
+  _count++;
+  _sum += us;
+  if (us < _min)
+    _min = us;
+  if (us > _max)
+    _max = us;
+}
+
+void PhaseHistogram::reset() { *this = PhaseHistogram(); }
+
+PhaseSummary PhaseHistogram::summarize() const {
+  PhaseSummary s = {_count, 0, 0, 0, 0};
+  if (_count == 0)
+    return s;
+  s.minUs = _min;
+  s.maxUs = _max;
+  s.avgUs = (uint32_t)(_sum / _count);
+
+  // Smallest bucket holding the 99th percentile sample, capped by the max
+  uint32_t rank = _count - _count / 100, seen = 0;
+  for (int b = 0; b < PH_BUCKETS; b++) {
+    seen += _counts[b];
+    if (seen >= rank) {
+      uint32_t top = bucketMax(b);
+      s.p99Us = top < _max ? top : _max;
+      break;
+    }
+  }
+  if (seen < rank) // Saturated buckets undercount
+    s.p99Us = _max;
+  return s;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <stdint.h>
+
+#define PH_SUB_BITS 3 // Buckets per octave: 1 << PH_SUB_BITS
+#define PH_OCTAVES 24 // Covers up to 2^26 us (67 s); longer lands in the last
+#define PH_BUCKETS (PH_OCTAVES << PH_SUB_BITS)
+
+// Summary of one phase over a window, in microseconds
+struct PhaseSummary {
+  uint32_t count;
+  uint32_t minUs, avgUs, p99Us, maxUs;
+};
+
+// Duration histogram for one loop phase.
+//
+// Buckets are log-linear: each power of two is split into eight equal
+// steps, so a percentile is within 12.5% of the true value at any scale
+// while the whole histogram stays a few hundred bytes. add() is a count
+// leading zeros and an increment; the percentile walk is left to
+// summarize(), which runs once per window.
+//
+// Pure logic, no Arduino dependencies.
+class PhaseHistogram {
+public:
+  void add(uint32_t us);
+  void reset();
+  PhaseSummary summarize() const;
+
+  static int bucket(uint32_t us);
+  static uint32_t bucketMax(int b); // Largest value in bucket b
+
+private:
+  uint16_t _counts[PH_BUCKETS] = {};
+  uint32_t _count = 0;
+  uint32_t _min = UINT32_MAX, _max = 0;
+  uint64_t _sum = 0;
+};
@@ -0,0 +1,179 @@
+#include "profiler.h"
+#include "network/printer_model.h"
+#include <atomic>
+#include <esp_heap_caps.h>
+#include <lvgl.h>
+
+#ifdef PROFILE_OVERLAY
+#define PROF_OVERLAY_DEFAULT true
+#else
+#define PROF_OVERLAY_DEFAULT false
+#endif
+
+static PhaseHistogram s_hist[PP_COUNT];
+static uint32_t s_mhz = 240; // Cycles per microsecond
+static uint32_t s_windowStart = 0;
+static uint32_t s_frames = 0;
+
+static uint32_t s_loopStart = 0;
+static uint32_t s_waitCycles = 0; // Blocked on DMA during this LVGL pass
+static bool s_drew = false;       // This LVGL pass drew a frame
+static uint32_t s_flushStart = 0;
+
+static SnapshotBuffer<ProfReport> s_reports;
+static std::atomic<bool> s_overlayOn{PROF_OVERLAY_DEFAULT};
+static lv_obj_t *s_overlay = NULL;
+
+static const char *const kPhaseNames[PP_COUNT] = {
+    "loop", "data", "ui", "lvgl", "touch", "render", "flush"};
+
+const char *profiler_phase_name(ProfPhase phase) {
+  return phase < PP_COUNT ? kPhaseNames[phase] : "";
+}
+
+static inline void record(ProfPhase phase, uint32_t cycles) {
+  s_hist[phase].add(cycles / s_mhz);
+}
+
+void profiler_begin() {
+  s_mhz = getCpuFrequencyMhz();
+  s_windowStart = millis();
+  s_loopStart = 0;
+}
+
+uint32_t profiler_mark(ProfPhase phase, uint32_t since) {
+  uint32_t now = profiler_cycles();
+  record(phase, now - since);
+  return now;
+}
+
+void profiler_lvgl(uint32_t since) {
+  uint32_t cycles = profiler_cycles() - since;
+  record(PP_LVGL, cycles);
+  if (s_drew) {
+    record(PP_RENDER, cycles - s_waitCycles);
+    s_frames++;
+    s_drew = false;
+  }
+  s_waitCycles = 0;
+}
+
+void profiler_wait(uint32_t since) {
+  s_waitCycles += profiler_cycles() - since;
+}
+
+void profiler_frame() { s_drew = true; }
+
+void profiler_flush_start() { s_flushStart = profiler_cycles(); }
+
+void profiler_flush_done() {
+  record(PP_FLUSH, profiler_cycles() - s_flushStart);
+}
+
+static void overlay_update(const ProfReport &r) {
+  const PhaseSummary &w = r.phase[r.worst];
+  uint32_t fps10 = r.windowMs ? r.frames * 10000 / r.windowMs : 0;
+  lv_label_set_text_fmt(s_overlay, "%u.%u fps  %s p99 %u.%u ms\nheap %uk  "
+                                   "lvgl %uk",
+                        (unsigned)(fps10 / 10), (unsigned)(fps10 % 10),
+                        profiler_phase_name(r.worst),
+                        (unsigned)(w.p99Us / 1000),
+                        (unsigned)(w.p99Us % 1000 / 100),
+                        (unsigned)(r.heapFree / 1024),
+                        (unsigned)(r.lvglFree / 1024));
+}
+
+// Shown on the top layer, so it stays across screen changes; labels are
+// not clickable, so touches pass through to the screen below
+static void overlay_apply() {
+  bool on = s_overlayOn.load(std::memory_order_relaxed);
+  if (on == (s_overlay != NULL))
+    return;
+  if (!on) {
+    lv_obj_del(s_overlay);
+    s_overlay = NULL;
+    return;
+  }
+  s_overlay = lv_label_create(lv_layer_top());
+  lv_obj_set_style_text_font(s_overlay, &lv_font_montserrat_14, 0);
+  lv_obj_set_style_text_color(s_overlay, lv_color_hex(0xFFFFFF), 0);
+  lv_obj_set_style_bg_color(s_overlay, lv_color_hex(0x000000), 0);
+  lv_obj_set_style_bg_opa(s_overlay, LV_OPA_70, 0);
+  lv_obj_set_style_pad_all(s_overlay, 4, 0);
+  lv_obj_align(s_overlay, LV_ALIGN_BOTTOM_LEFT, 0, 0);
+  lv_label_set_text(s_overlay, "Profiling...");
+}
+
+static void window_close(uint32_t nowMs) {
+  ProfReport r;
+  r.atMs = nowMs;
+  r.windowMs = nowMs - s_windowStart;
+  r.frames = s_frames;
+  for (int p = 0; p < PP_COUNT; p++) {
+    r.phase[p] = s_hist[p].summarize();
+    s_hist[p].reset();
+  }
+  r.worst = PP_DATA;
+  for (int p = PP_UI; p <= PP_LVGL; p++) {
+    if (r.phase[p].p99Us > r.phase[r.worst].p99Us)
+      r.worst = (ProfPhase)p;
+  }
+  r.heapFree = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+  r.heapMin = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  r.lvglFree = mon.free_size;
+  s_reports.publish(r);
+
+  if (s_overlay)
+    overlay_update(r);
+  s_windowStart = nowMs;
+  s_frames = 0;
+}
+
+uint32_t profiler_loop() {
+  uint32_t now = profiler_cycles();
+  if (s_loopStart)
+    record(PP_LOOP, now - s_loopStart);
+  s_loopStart = now;
+
+  overlay_apply();
+  uint32_t ms = millis();
+  if (ms - s_windowStart >= PROF_WINDOW_MS)
+    window_close(ms);
+  return profiler_cycles(); // Bookkeeping is not charged to the next phase
+}
+
+void profiler_report(ProfReport &out) { s_reports.read(out); }
+
+void profiler_set_overlay(bool on) {
+  s_overlayOn.store(on, std::memory_order_relaxed);
+}
+
+// {"atMs":T,"windowMs":2000,"frames":N,"worst":"lvgl","heapFree":B,
+// "heapMin":B,"lvglFree":B,"overlay":false,"phases":{"loop":{"count":N,
+// "minUs":..,"avgUs":..,"p99Us":..,"maxUs":..},..}}
+void profiler_json(String &out) {
+  ProfReport r;
+  profiler_report(r);
+  out += "{\"atMs\":" + String(r.atMs);
+  out += ",\"windowMs\":" + String(r.windowMs);
+  out += ",\"frames\":" + String(r.frames);
+  out += ",\"worst\":\"" + String(profiler_phase_name(r.worst)) + "\"";
+  out += ",\"heapFree\":" + String(r.heapFree);
+  out += ",\"heapMin\":" + String(r.heapMin);
+  out += ",\"lvglFree\":" + String(r.lvglFree);
+  out += ",\"overlay\":" + String(s_overlayOn.load() ? "true" : "false");
+  out += ",\"phases\":{";
+  for (int p = 0; p < PP_COUNT; p++) {
+    const PhaseSummary &s = r.phase[p];
+    if (p > 0)
+      out += ",";
+    out += "\"" + String(kPhaseNames[p]) + "\":{\"count\":" + String(s.count);
+    out += ",\"minUs\":" + String(s.minUs);
+    out += ",\"avgUs\":" + String(s.avgUs);
+    out += ",\"p99Us\":" + String(s.p99Us);
+    out += ",\"maxUs\":" + String(s.maxUs) + "}";
+  }
+  out += "}}";
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <Arduino.h>
+#include <stdint.h>
+
+#include "phase_histogram.h"
+
+/* Loop profiler.
+ *
+ * loop() stamps the CPU cycle counter between its phases; the display
+ * callbacks add render and flush times. Each phase feeds a PhaseHistogram,
+ * and every PROF_WINDOW_MS the window is summarized (min/avg/p99/max per
+ * phase, frames drawn, free heap), published for other tasks and started
+ * afresh. A stamp is one register read, so the profiler is always on.
+ *
+ * The last window is served as JSON at /profile. /profile?overlay=1 (or
+ * building with -D PROFILE_OVERLAY) shows FPS, the worst phase and free
+ * heap in a corner of the screen; overlay=0 hides it again. */
+#define PROF_WINDOW_MS 2000
+
+enum ProfPhase : uint8_t {
+  PP_LOOP,   // One pass of loop(), sleep included
+  PP_DATA,   // Flush completion and DataManager.loop()
+  PP_UI,     // ui_update_status()
+  PP_LVGL,   // lv_timer_handler()
+  PP_TOUCH,  // Touch read, inside PP_LVGL
+  PP_RENDER, // PP_LVGL passes that drew a frame, less time waiting on DMA
+  PP_FLUSH,  // One draw band on the bus, DMA start until seen complete
+  PP_COUNT
+};
+
+struct ProfReport {
+  uint32_t atMs; // When the window closed
+  uint32_t windowMs;
+  uint32_t frames;
+  ProfPhase worst;  // PP_DATA, PP_UI or PP_LVGL, by p99
+  uint32_t heapFree; // Internal heap, bytes
+  uint32_t heapMin;  // Internal heap low-water mark since boot
+  uint32_t lvglFree; // LVGL heap, bytes
+  PhaseSummary phase[PP_COUNT];
+};
+
+static inline uint32_t profiler_cycles() { return ESP.getCycleCount(); }
+
+void profiler_begin();
+
+/* UI thread (loop task) only */
+uint32_t profiler_loop(); // First in loop(); returns the current cycle count
+uint32_t profiler_mark(ProfPhase phase, uint32_t since); // Returns now
+void profiler_lvgl(uint32_t since); // After lv_timer_handler()
+void profiler_wait(uint32_t since); // End of the display wait callback
+void profiler_frame();              // Display monitor callback
+void profiler_flush_start();
+void profiler_flush_done();
+
+/* Any task */
+void profiler_report(ProfReport &out); // Last completed window
+void profiler_json(String &out);
+void profiler_set_overlay(bool on);
+const char *profiler_phase_name(ProfPhase phase);
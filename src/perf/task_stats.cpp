@@ -0,0 +1,96 @@
+#include "task_stats.h"
+#include "task_layout.h"
+#include <atomic>
+
+static const struct {
+  const char *name;
+  uint8_t core;
+  uint8_t priority;
+  uint32_t stack;
+} kTasks[AT_COUNT] = {
+    {"ui", UI_TASK_CORE, UI_TASK_PRIORITY, UI_TASK_STACK},
+    {"touch", TOUCH_TASK_CORE, TOUCH_TASK_PRIORITY, TOUCH_TASK_STACK},
+    {"net", NET_TASK_CORE, NET_TASK_PRIORITY, NET_TASK_STACK},
+};
+
+static TaskHandle_t s_handles[AT_COUNT];
+static std::atomic<uint32_t> s_waitUs[AT_COUNT]; // Wraps; read as deltas
+
+/* Reader state, owned by the one task calling task_stats_json() */
+static uint32_t s_lastUs = 0;
+static uint32_t s_lastWaitUs[AT_COUNT];
+
+void task_stats_register(AppTask task, TaskHandle_t handle) {
+  s_handles[task] = handle;
+}
+
+void task_stats_wait(AppTask task, uint32_t sinceUs) {
+  s_waitUs[task].fetch_add(micros() - sinceUs, std::memory_order_relaxed);
+}
+
+// Permille as "12.3"
+static String pct(uint32_t part, uint32_t whole) {
+  uint32_t pm = whole ? (uint32_t)((uint64_t)part * 1000 / whole) : 0;
+  if (pm > 1000)
+    pm = 1000;
+  return String(pm / 10) + "." + String(pm % 10);
+}
+
+#if configGENERATE_RUN_TIME_STATS && configUSE_TRACE_FACILITY
+#define TASK_STATS_MAX 24 // System tasks listed by the scheduler
+
+// Every task's share of one core since boot
+static void cpu_json(String &out) {
+  static TaskStatus_t tasks[TASK_STATS_MAX];
+  uint32_t total = 0;
+  UBaseType_t n = uxTaskGetSystemState(tasks, TASK_STATS_MAX, &total);
+  out += ",\"cpu\":[";
+  for (UBaseType_t i = 0; i < n; i++) {
+    const TaskStatus_t &t = tasks[i];
+    if (i > 0)
+      out += ",";
+    out += "{\"name\":\"" + String(t.pcTaskName) + "\"";
+    out += ",\"priority\":" + String((unsigned)t.uxCurrentPriority);
+    // Run-time counters are per task against one core's worth of time
+    out += ",\"pct\":" + pct(t.ulRunTimeCounter, total) + "}";
+  }
+  out += "]";
+}
+#endif
+
+// {"intervalMs":N,"tasks":[{"name":"ui","core":1,"priority":1,
+// "stack":8192,"stackFree":B,"activePct":12.3},..],"cpu":[..]}: share
+// not parked waiting for work since the previous request (or boot); "cpu"
+// only with run-time stats
+void task_stats_json(String &out) {
+  uint32_t now = micros();
+  uint32_t interval = now - s_lastUs;
+  s_lastUs = now;
+
+  out += "{\"intervalMs\":" + String(interval / 1000) + ",\"tasks\":[";
+  for (int i = 0; i < AT_COUNT; i++) {
+    uint32_t wait = s_waitUs[i].load(std::memory_order_relaxed);
+    uint32_t waited = wait - s_lastWaitUs[i];
+    s_lastWaitUs[i] = wait;
+    if (i > 0)
+      out += ",";
+    out += "{\"name\":\"" + String(kTasks[i].name) + "\"";
+    out += ",\"core\":" + String(kTasks[i].core);
+    out += ",\"priority\":" + String(kTasks[i].priority);
+    out += ",\"stack\":" + String(kTasks[i].stack);
+    out += ",\"stackFree\":";
+    // ESP-IDF counts the high-water mark in bytes
+    out += s_handles[i] ? String(uxTaskGetStackHighWaterMark(s_handles[i]))
+                        : String("null");
+    out += ",\"busyPct\":" +
+           (s_handles[i] ? pct(interval > waited ? interval - waited : 0,
+                               interval)
+                         : String("null"));
+    out += "}";
+  }
+  out += "]";
+#if configGENERATE_RUN_TIME_STATS && configUSE_TRACE_FACILITY
+  cpu_json(out);
+#endif
+  out += "}";
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <Arduino.h>
+#include <stdint.h>
+
+/* Per-task load for the tasks in task_layout.h.
+ *
+ * Each task adds the time it spends parked waiting for work (its queue,
+ * notification or sleep); the rest of the wall time counts as active.
+ * Active is not CPU use: it includes time the task was preempted, and for
+ * the net task every request's wait on the printer, so a slow printer
+ * shows as a net task that is always active. When FreeRTOS run-time stats
+ * are compiled in, task_stats_json() adds the scheduler's CPU share for
+ * every task on both cores, IDLE and the WiFi stack included. */
+enum AppTask : uint8_t { AT_UI, AT_TOUCH, AT_NET, AT_COUNT };
+
+void task_stats_register(AppTask task, TaskHandle_t handle);
+void task_stats_wait(AppTask task, uint32_t sinceUs); // Blocked since..now
+
+/* Active share since the previous call, stack headroom, layout. Call from
+ * one task only (the web server's). */
+void task_stats_json(String &out);
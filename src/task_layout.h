@@ -0,0 +1,41 @@
+#pragma once
+
+/* Task layout.
+ *
+ *   task   core  prio  stack  does
+ *   ui       1     1    8192  Arduino loop(): LVGL, screens, display flush
+ *   touch    1     2    3072  Touch controller reads, on its interrupt
+ *   net      0     1    8192  Printer polling and commands, web server,
+ *                             WiFi, settings writes to NVS
+ *
+ * Core 0 also runs the WiFi/LwIP and esp_timer tasks, so the network task
+ * sits next to the stack it waits on and the UI core only ever sees the
+ * short touch reads preempting it. Touch is above the UI so a report is
+ * read as soon as the controller raises its interrupt; a read takes well
+ * under a millisecond and the task sleeps otherwise.
+ *
+ * Nothing blocks across cores. Hand-offs between tasks:
+ *   ui -> net     NetRequest queue (NET_REQUEST_DEPTH; full = dropped and
+ *                 logged), CommandQueue for G-code, a save flag for settings
+ *   net -> ui     SnapshotBuffer of the printer model, then a task
+ *                 notification to wake loop()
+ *   touch -> ui   TouchRing of samples (TOUCH_QUEUE_DEPTH; full = dropped
+ *                 and counted), then a task notification
+ *
+ * Stacks are in bytes. /tasks reports each task's stack headroom and the
+ * share of time it was active, not parked waiting for work. Check both
+ * after changing a task's work. */
+
+#define UI_TASK_CORE 1 // Arduino's loopTask runs on ARDUINO_RUNNING_CORE
+#define UI_TASK_PRIORITY 1
+#define UI_TASK_STACK 8192 // LVGL renders on this stack
+
+#define TOUCH_TASK_CORE 1     // With LVGL, which consumes the samples
+#define TOUCH_TASK_PRIORITY 2 // Above the loop task: reads are short
+#define TOUCH_TASK_STACK 3072
+#define TOUCH_QUEUE_DEPTH 32 // Power of two; 640 ms of reports at 50 Hz
+
+#define NET_TASK_CORE 0
+#define NET_TASK_PRIORITY 1
+#define NET_TASK_STACK 8192 // HTTPClient, JSON filter and web handlers
+#define NET_REQUEST_DEPTH 8
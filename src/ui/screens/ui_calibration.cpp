@@ -1,31 +1,149 @@
 #include "ui_calibration.h"
+#include "input/touch_input.h"
+#include "ui/ui.h"
 #include <Arduino.h>
 
-// External bypass flag from main.cpp
-extern bool g_bypass_calibration;
+#define CALIB_SKIP 2        // Samples of each press ignored while it settles
+#define CALIB_MIN_SAMPLES 4 // Averaged samples needed to accept a press
 
 lv_obj_t *ui_ScreenCalibration = NULL;
 
-// Simple 4-point calibration targets
+// Corners and centre: the centre point lets the fit average out errors
+// instead of passing exactly through the corners
 struct CalibTarget {
   int x;
   int y;
   const char *label;
 };
 
-static CalibTarget targets[] = {
-    {20, 20, "1"}, {460, 20, "2"}, {20, 300, "3"}, {460, 300, "4"}};
+static CalibTarget targets[] = {{20, 20, "1"},
+                                {460, 20, "2"},
+                                {20, 300, "3"},
+                                {460, 300, "4"},
+                                {240, 160, "5"}};
 
-static int currentTarget = 0;
 static const int numTargets = sizeof(targets) / sizeof(targets[0]);
 
-void ui_calibration_screen_init() {
-  // Enable raw coordinate mode for calibration screen
-  g_bypass_calibration = true;
+/* Widgets; all NULL while the screen is not built */
+static lv_obj_t *dots[numTargets];
+static lv_obj_t *labels[numTargets];
+static lv_obj_t *lbl_status;
+static lv_obj_t *lbl_btn;
+
+/* Calibration progress; starts over each time the screen is shown */
+static struct {
+  int current; // Target the user should touch next
+  int samples; // Raw samples seen during the current press
+  float sumX, sumY;
+  TouchPair pairs[numTargets];
+} s_calib;
+
+static void targets_update() {
+  for (int i = 0; i < numTargets; i++) {
+    bool on = i == s_calib.current;
+    lv_obj_set_style_bg_color(
+        dots[i], on ? lv_color_hex(0x00FF00) : lv_color_hex(0xFF0000), 0);
+    lv_obj_set_style_text_color(
+        labels[i], on ? lv_color_hex(0x00FF00) : lv_color_hex(0xFFFFFF), 0);
+  }
+}
+
+static void calib_restart() {
+  s_calib.current = 0;
+  s_calib.samples = 0;
+  targets_update();
+  lv_label_set_text(lbl_btn, "Cancel");
+}
+
+static void calib_finish() {
+  TouchCalibration cal;
+  if (!cal.solve(s_calib.pairs, numTargets)) {
+    Serial.println("CALIB: Points do not fit a calibration, starting over");
+    calib_restart();
+    lv_label_set_text(lbl_status, "Could not calibrate, try again");
+    return;
+  }
+  touch_input_set_calibration(cal, true);
+
+  int err10 = (int)(cal.rmsError() * 10 + 0.5f);
+  const int32_t *m = cal.matrix();
+  Serial.printf("CALIB: Saved, RMS error %d.%d px, matrix %ld %ld %ld %ld "
+                "%ld %ld\n",
+                err10 / 10, err10 % 10, (long)m[0], (long)m[1], (long)m[2],
+                (long)m[3], (long)m[4], (long)m[5]);
+  lv_label_set_text_fmt(lbl_status, "Saved. Average error %d.%d px",
+                        err10 / 10, err10 % 10);
+  lv_label_set_text(lbl_btn, "Done");
+}
+
+/* A press anywhere on the screen counts for the current target; its raw
+ * readings are averaged once it settles */
+static void press_event_cb(lv_event_t *e) {
+  if (s_calib.current >= numTargets)
+    return;
 
+  lv_event_code_t code = lv_event_get_code(e);
+  if (code == LV_EVENT_PRESSED) {
+    s_calib.samples = 0;
+    s_calib.sumX = s_calib.sumY = 0;
+  } else if (code == LV_EVENT_PRESSING) {
+    TouchPoint tp = touch_input_last();
+    if (++s_calib.samples > CALIB_SKIP) {
+      s_calib.sumX += tp.rawX;
+      s_calib.sumY += tp.rawY;
+    }
+  } else if (code == LV_EVENT_RELEASED) {
+    int n = s_calib.samples - CALIB_SKIP;
+    if (n < CALIB_MIN_SAMPLES) {
+      lv_label_set_text(lbl_status, "Hold each dot a little longer");
+      return;
+    }
+    const CalibTarget &t = targets[s_calib.current];
+    TouchPair &p = s_calib.pairs[s_calib.current];
+    p = {s_calib.sumX / n, s_calib.sumY / n, (int16_t)t.x, (int16_t)t.y};
+    Serial.printf("CALIB: Dot %s at (%d, %d): Raw(xr=%.1f, yr=%.1f) from %d "
+                  "samples\n",
+                  t.label, t.x, t.y, p.rawX, p.rawY, n);
+
+    s_calib.current++;
+    if (s_calib.current == numTargets) {
+      calib_finish();
+    } else {
+      targets_update();
+      lv_label_set_text(lbl_status, "");
+    }
+  }
+}
+
+static void btn_done_event_cb(lv_event_t *e) {
+  ui_screen_load(UI_SCREEN_DASHBOARD);
+}
+
+// Raw touch coordinates only while this screen is the active one
+static void screen_event_cb(lv_event_t *e) {
+  lv_event_code_t code = lv_event_get_code(e);
+  if (code == LV_EVENT_SCREEN_LOAD_START) {
+    touch_input_set_raw(true);
+    calib_restart();
+    lv_label_set_text(lbl_status, "");
+  } else if (code == LV_EVENT_SCREEN_UNLOADED) {
+    touch_input_set_raw(false);
+  } else if (code == LV_EVENT_DELETE) {
+    touch_input_set_raw(false);
+    for (int i = 0; i < numTargets; i++)
+      dots[i] = labels[i] = NULL;
+    lbl_status = lbl_btn = NULL;
+  }
+}
+
+void ui_calibration_screen_init() {
   ui_ScreenCalibration = lv_obj_create(NULL);
   lv_obj_clear_flag(ui_ScreenCalibration, LV_OBJ_FLAG_SCROLLABLE);
   lv_obj_set_style_bg_color(ui_ScreenCalibration, lv_color_hex(0x000000), 0);
+  lv_obj_add_event_cb(ui_ScreenCalibration, screen_event_cb, LV_EVENT_ALL,
+                      NULL);
+  lv_obj_add_event_cb(ui_ScreenCalibration, press_event_cb, LV_EVENT_ALL,
+                      NULL);
 
   // Title
   lv_obj_t *title = lv_label_create(ui_ScreenCalibration);
@@ -37,42 +155,45 @@ void ui_calibration_screen_init() {
   // Instructions
   lv_obj_t *instructions = lv_label_create(ui_ScreenCalibration);
   lv_label_set_text(instructions,
-                    "Touch each numbered dot.\nCheck Serial for coordinates.");
+                    "Touch and hold each green dot in turn.");
   lv_obj_set_style_text_color(instructions, lv_color_hex(0xAAAAAA), 0);
   lv_obj_set_style_text_font(instructions, &lv_font_montserrat_14, 0);
   lv_obj_set_style_text_align(instructions, LV_TEXT_ALIGN_CENTER, 0);
   lv_obj_align(instructions, LV_ALIGN_TOP_MID, 0, 35);
 
-  // Draw all 4 dots
+  lbl_status = lv_label_create(ui_ScreenCalibration);
+  lv_label_set_text(lbl_status, "");
+  lv_obj_set_style_text_color(lbl_status, lv_color_hex(0xFFFFFF), 0);
+  lv_obj_set_style_text_font(lbl_status, &lv_font_montserrat_16, 0);
+  lv_obj_align(lbl_status, LV_ALIGN_CENTER, 0, 40);
+
+  // Away from every target, so pressing it never counts as a sample
+  lv_obj_t *btn = lv_btn_create(ui_ScreenCalibration);
+  lv_obj_add_style(btn, &style_btn_primary, 0);
+  lv_obj_set_size(btn, 120, 40);
+  lv_obj_align(btn, LV_ALIGN_BOTTOM_MID, 0, -10);
+  lv_obj_add_event_cb(btn, btn_done_event_cb, LV_EVENT_CLICKED, NULL);
+  lbl_btn = lv_label_create(btn);
+  lv_label_set_text(lbl_btn, "Cancel");
+  lv_obj_center(lbl_btn);
+
   for (int i = 0; i < numTargets; i++) {
-    // Dot (circle)
-    lv_obj_t *dot = lv_obj_create(ui_ScreenCalibration);
-    lv_obj_set_size(dot, 20, 20);
-    lv_obj_set_pos(dot, targets[i].x - 10,
+    // Dot (circle); presses on it go to the screen
+    dots[i] = lv_obj_create(ui_ScreenCalibration);
+    lv_obj_set_size(dots[i], 20, 20);
+    lv_obj_set_pos(dots[i], targets[i].x - 10,
                    targets[i].y - 10); // Center the 20px dot
-    lv_obj_clear_flag(dot, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_set_style_bg_color(dot,
-                              i == currentTarget ? lv_color_hex(0x00FF00)
-                                                 : lv_color_hex(0xFF0000),
-                              0);
-    lv_obj_set_style_border_width(dot, 0, 0);
-    lv_obj_set_style_radius(dot, LV_RADIUS_CIRCLE, 0);
+    lv_obj_clear_flag(dots[i], LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_style_border_width(dots[i], 0, 0);
+    lv_obj_set_style_radius(dots[i], LV_RADIUS_CIRCLE, 0);
 
     // Label next to dot
-    lv_obj_t *label = lv_label_create(ui_ScreenCalibration);
-    lv_label_set_text(label, targets[i].label);
-    lv_obj_set_style_text_color(label,
-                                i == currentTarget ? lv_color_hex(0x00FF00)
-                                                   : lv_color_hex(0xFFFFFF),
-                                0);
-    lv_obj_set_style_text_font(label, &lv_font_montserrat_16, 0);
-    lv_obj_set_pos(label, targets[i].x + 15, targets[i].y - 8);
+    labels[i] = lv_label_create(ui_ScreenCalibration);
+    lv_label_set_text(labels[i], targets[i].label);
+    lv_obj_set_style_text_font(labels[i], &lv_font_montserrat_16, 0);
+    lv_obj_set_pos(labels[i], targets[i].x + 15, targets[i].y - 8);
   }
+  calib_restart();
 
   Serial.println("\n=== TOUCH CALIBRATION MODE (RAW) ===");
-  Serial.printf("Touch dot %s at (%d, %d)\n", targets[currentTarget].label,
-                targets[currentTarget].x, targets[currentTarget].y);
-  Serial.println(
-      "Expected format: Raw(xr=XXX, yr=YYY) -> Calibrated(x=XXX, y=YYY)");
-  Serial.println("====================================\n");
 }
@@ -0,0 +1,245 @@
+#include "network/network_manager.h"
+#include "ui/ui.h"
+
+/* All-units overview: one row per unit, one cell per lane, sized to the
+ * shape AFC_unit_total_lanes reports. Every cell comes from cell_create()
+ * and shares its styles, so a cell is a container and one or two labels
+ * with no local styles until its LED colour is known. Each cell is bound to
+ * its own lane: a lane change rewrites and redraws that cell only. */
+
+#define OV_GRID_Y 50
+#define OV_GRID_H 270
+#define OV_ROW_LABEL_W 32
+#define OV_HEAD_H 18
+#define OV_GAP 4
+#define OV_MAX_CELL_H 70
+#define OV_TOOL_MIN_H 44 // Cells shorter than this show the filament only
+
+lv_obj_t *ui_ScreenOverview = NULL; // Built on first use
+
+/* Widgets; all NULL while the screen is not built */
+static lv_obj_t *label_title;
+static lv_obj_t *grid;
+static lv_obj_t *label_row[PM_MAX_UNITS];
+static struct {
+  lv_obj_t *box;
+  lv_obj_t *tool; // NULL in short cells
+  lv_obj_t *filament;
+} s_cells[PM_MAX_LANES];
+
+/* Lane-cell template */
+static lv_style_t style_cell;
+static lv_style_t style_cell_loaded; // LV_STATE_CHECKED
+static lv_style_t style_cell_text;
+
+static void cell_styles_init() {
+  static bool done = false;
+  if (done)
+    return;
+  done = true;
+
+  lv_style_init(&style_cell);
+  lv_style_set_bg_color(&style_cell, lv_color_hex(0x1e1e2e));
+  lv_style_set_bg_opa(&style_cell, LV_OPA_COVER);
+  lv_style_set_radius(&style_cell, 6);
+  lv_style_set_border_side(&style_cell, LV_BORDER_SIDE_LEFT);
+  lv_style_set_border_width(&style_cell, 4); // LED colour
+  lv_style_set_border_color(&style_cell, lv_color_hex(0x888888));
+  lv_style_set_pad_all(&style_cell, 4);
+  lv_style_set_pad_left(&style_cell, 8);
+
+  lv_style_init(&style_cell_loaded);
+  lv_style_set_bg_color(&style_cell_loaded, lv_color_hex(0x1f4d2e));
+
+  lv_style_init(&style_cell_text);
+  lv_style_set_text_font(&style_cell_text, &lv_font_montserrat_14);
+  lv_style_set_text_color(&style_cell_text, lv_color_hex(0xFFFFFF));
+}
+
+static void cell_event_cb(lv_event_t *e) {
+  int unit = (int)(intptr_t)lv_event_get_user_data(e);
+  if (unit != DataManager.getActiveAFCUnit())
+    DataManager.setActiveAFCUnit(unit);
+  ui_screen_load(UI_SCREEN_DASHBOARD);
+}
+
+static void cell_create(int unit, int lane, lv_coord_t x, lv_coord_t y,
+                        lv_coord_t w, lv_coord_t h) {
+  auto &cell = s_cells[PrinterModel::laneIndex(unit, lane)];
+  cell.box = lv_obj_create(grid);
+  lv_obj_remove_style_all(cell.box);
+  lv_obj_add_style(cell.box, &style_cell, 0);
+  lv_obj_add_style(cell.box, &style_cell_loaded, LV_STATE_CHECKED);
+  lv_obj_set_size(cell.box, w, h);
+  lv_obj_set_pos(cell.box, x, y);
+  lv_obj_clear_flag(cell.box, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_event_cb(cell.box, cell_event_cb, LV_EVENT_CLICKED,
+                      (void *)(intptr_t)unit);
+
+  if (h >= OV_TOOL_MIN_H) {
+    cell.tool = lv_label_create(cell.box);
+    lv_obj_add_style(cell.tool, &style_cell_text, 0);
+    lv_label_set_text(cell.tool, "");
+    lv_obj_align(cell.tool, LV_ALIGN_TOP_LEFT, 0, 0);
+  }
+
+  cell.filament = lv_label_create(cell.box);
+  lv_obj_add_style(cell.filament, &style_cell_text, 0);
+  lv_label_set_long_mode(cell.filament, LV_LABEL_LONG_DOT);
+  lv_obj_set_width(cell.filament, lv_pct(100));
+  lv_label_set_text(cell.filament, "");
+  lv_obj_align(cell.filament, cell.tool ? LV_ALIGN_BOTTOM_LEFT
+                                        : LV_ALIGN_LEFT_MID,
+               0, 0);
+}
+
+// Bring one cell in line with its lane; unchanged parts are not touched
+static void cell_update(int idx) {
+  auto &cell = s_cells[idx];
+  if (!cell.box)
+    return;
+  const PrinterModel &m = DataManager.getModel();
+  const LaneInfo &l = m.lanes[idx];
+
+  ui_observe_set_state(cell.box, LV_STATE_CHECKED, l.loaded);
+  ui_observe_set_border_color(cell.box, ui_led_color(l.led));
+  ui_observe_set_label(cell.filament, l.filament[0] ? l.filament : "-");
+  if (cell.tool) {
+    int unit = idx / PM_MAX_UNIT_LANES, lane = idx % PM_MAX_UNIT_LANES;
+    char buf[8];
+    snprintf(buf, sizeof(buf), "T%d",
+             l.tool >= 0 ? l.tool : m.laneNumber(unit, lane));
+    ui_observe_set_label(cell.tool, buf);
+  }
+}
+
+static void rows_update() {
+  int active = DataManager.getActiveAFCUnit();
+  for (int u = 0; u < PM_MAX_UNITS; u++)
+    ui_observe_set_text_color(label_row[u],
+                              u == active ? lv_color_hex(0x7c3aed)
+                                          : lv_color_hex(0xAAAAAA));
+}
+
+// Lay the grid out for the current units x lanes shape
+static void grid_build() {
+  lv_obj_clean(grid);
+  memset(s_cells, 0, sizeof(s_cells));
+  memset(label_row, 0, sizeof(label_row));
+
+  const PrinterModel &m = DataManager.getModel();
+  int rows = m.unitCount, cols = 1, lanes = 0;
+  for (int u = 0; u < rows; u++) {
+    if (m.laneCount(u) > cols)
+      cols = m.laneCount(u);
+    lanes += m.laneCount(u);
+  }
+  if (rows < 1)
+    rows = 1;
+
+  char buf[40];
+  snprintf(buf, sizeof(buf), "All Units (%d units, %d lanes)", m.unitCount,
+           lanes);
+  lv_label_set_text(label_title, buf);
+
+  lv_coord_t pitchX = (480 - OV_ROW_LABEL_W - OV_GAP) / cols;
+  lv_coord_t pitchY = (OV_GRID_H - OV_HEAD_H - OV_GAP) / rows;
+  if (pitchY > OV_MAX_CELL_H + OV_GAP)
+    pitchY = OV_MAX_CELL_H + OV_GAP;
+  lv_coord_t x0 = OV_ROW_LABEL_W, y0 = OV_HEAD_H;
+
+  for (int l = 0; l < cols; l++) {
+    lv_obj_t *head = lv_label_create(grid);
+    lv_obj_add_style(head, &style_text_title, 0);
+    lv_label_set_text_fmt(head, "%d", l);
+    lv_obj_set_width(head, pitchX - OV_GAP);
+    lv_obj_set_style_text_align(head, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_set_pos(head, x0 + l * pitchX, 0);
+  }
+
+  for (int u = 0; u < m.unitCount; u++) {
+    lv_coord_t y = y0 + u * pitchY;
+    label_row[u] = lv_label_create(grid);
+    lv_obj_add_style(label_row[u], &style_text_title, 0);
+    lv_label_set_text_fmt(label_row[u], "U%d", u);
+    lv_obj_align(label_row[u], LV_ALIGN_TOP_LEFT, 4,
+                 y + (pitchY - OV_GAP) / 2 - 8);
+
+    for (int l = 0; l < m.laneCount(u); l++) {
+      cell_create(u, l, x0 + l * pitchX, y, pitchX - OV_GAP,
+                  pitchY - OV_GAP);
+      cell_update(PrinterModel::laneIndex(u, l));
+    }
+  }
+  rows_update();
+}
+
+static void on_lane(UiProp prop, int idx) { cell_update(idx); }
+
+static void on_shape(UiProp prop, int idx) {
+  if (grid)
+    grid_build();
+}
+
+static void on_unit(UiProp prop, int idx) {
+  if (grid)
+    rows_update();
+}
+
+static void screen_delete_cb(lv_event_t *e) {
+  label_title = NULL;
+  grid = NULL;
+  memset(s_cells, 0, sizeof(s_cells));
+  memset(label_row, 0, sizeof(label_row));
+}
+
+void ui_screen_overview_init() {
+  cell_styles_init();
+
+  ui_ScreenOverview = lv_obj_create(NULL);
+  lv_obj_add_style(ui_ScreenOverview, &style_base_screen, 0);
+  lv_obj_clear_flag(ui_ScreenOverview, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_event_cb(ui_ScreenOverview, screen_delete_cb, LV_EVENT_DELETE,
+                      NULL);
+
+  /* Header (same as settings) */
+  lv_obj_t *header = lv_obj_create(ui_ScreenOverview);
+  lv_obj_set_size(header, 480, 50);
+  lv_obj_set_style_bg_color(header, lv_color_hex(0x252526), 0);
+  lv_obj_align(header, LV_ALIGN_TOP_MID, 0, 0);
+  lv_obj_clear_flag(header, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_set_scrollbar_mode(header, LV_SCROLLBAR_MODE_OFF);
+  lv_obj_set_style_pad_all(header, 0, 0);
+  lv_obj_set_style_border_width(header, 0, 0);
+
+  label_title = lv_label_create(header);
+  lv_obj_set_style_text_font(label_title, &lv_font_montserrat_20, 0);
+  lv_obj_set_style_text_color(label_title, lv_color_hex(0xFFFFFF), 0);
+  lv_obj_align(label_title, LV_ALIGN_LEFT_MID, 10, 0);
+
+  lv_obj_t *btn_back = lv_btn_create(header);
+  lv_obj_set_size(btn_back, 100, 50);
+  lv_obj_align(btn_back, LV_ALIGN_RIGHT_MID, -5, 0);
+  lv_obj_add_event_cb(
+      btn_back, [](lv_event_t *e) { ui_screen_load(UI_SCREEN_DASHBOARD); },
+      LV_EVENT_CLICKED, NULL);
+  lv_obj_t *lbl_back = lv_label_create(btn_back);
+  lv_label_set_text(lbl_back, "Back");
+  lv_obj_center(lbl_back);
+
+  /* Grid: plain container, cells are placed by grid_build() */
+  grid = lv_obj_create(ui_ScreenOverview);
+  lv_obj_remove_style_all(grid);
+  lv_obj_set_size(grid, 480, OV_GRID_H);
+  lv_obj_set_pos(grid, 0, OV_GRID_Y);
+  lv_obj_clear_flag(grid, LV_OBJ_FLAG_SCROLLABLE);
+  grid_build();
+
+  static bool observed = false;
+  if (!observed) {
+    observed = true;
+    ui_observe(UI_PROP_LANE, on_lane);
+    ui_observe(UI_PROP_UNIT_LANES, on_shape);
+    ui_observe(UI_PROP_UNIT, on_unit);
+  }
+}
@@ -1,27 +1,50 @@
 #include "network/network_manager.h"
 #include "ui/ui.h"
 
+/* Widgets; all NULL while the screen is not built */
 static lv_obj_t *ta_ssid;
 static lv_obj_t *ta_pass;
 static lv_obj_t *ta_ip;
 static lv_obj_t *ta_poll;
-static lv_obj_t *kb;
+static lv_obj_t *kb = NULL;             // Created on first text area focus
 static lv_obj_t *cont_units = NULL;     // Container for unit buttons
 static lv_obj_t *btn_units[8] = {NULL}; // Support up to 8 units
 static int last_unit_count = 0;
 
+/* Text typed but not saved yet. Outlives the screen, so leaving settings
+ * and coming back does not lose an edit in progress. */
+enum SettingsField { SF_SSID, SF_PASS, SF_IP, SF_POLL, SF_COUNT };
+static struct {
+  uint8_t dirty; // Bit per SettingsField edited since it was last saved
+  char text[SF_COUNT][65];
+} s_draft;
+
 // Forward declaration
 void ui_settings_refresh();
 
+static void kb_event_cb(lv_event_t *e);
+
+static void kb_hide() {
+  if (kb)
+    lv_obj_add_flag(kb, LV_OBJ_FLAG_HIDDEN);
+}
+
 static void ta_event_cb(lv_event_t *e) {
   lv_event_code_t code = lv_event_get_code(e);
   lv_obj_t *ta = lv_event_get_target(e);
   if (code == LV_EVENT_CLICKED || code == LV_EVENT_FOCUSED) {
-    /*Focus on the clicked text area*/
-    if (kb != NULL) {
-      lv_keyboard_set_textarea(kb, ta);
-      lv_obj_clear_flag(kb, LV_OBJ_FLAG_HIDDEN);
+    /* Keyboard - Stays on root screen to remain on top */
+    if (kb == NULL) {
+      kb = lv_keyboard_create(ui_ScreenSettings);
+      lv_obj_set_size(kb, 480, 160);
+      lv_obj_align(kb, LV_ALIGN_BOTTOM_MID, 0, 0);
+      lv_obj_add_event_cb(kb, kb_event_cb, LV_EVENT_ALL, NULL);
     }
+    /*Focus on the clicked text area*/
+    lv_keyboard_set_textarea(kb, ta);
+    lv_obj_clear_flag(kb, LV_OBJ_FLAG_HIDDEN);
+  } else if (code == LV_EVENT_VALUE_CHANGED) {
+    s_draft.dirty |= 1 << (int)(intptr_t)lv_event_get_user_data(e);
   } else if (code == LV_EVENT_READY) {
     LV_LOG_USER("Ready, do something");
   }
@@ -31,9 +54,10 @@ static void btn_connect_wifi_event_cb(lv_event_t *e) {
   const char *ssid = lv_textarea_get_text(ta_ssid);
   const char *pass = lv_textarea_get_text(ta_pass);
   DataManager.connectWiFi(ssid, pass);
+  s_draft.dirty &= ~((1 << SF_SSID) | (1 << SF_PASS));
 
   // Hide keyboard
-  lv_obj_add_flag(kb, LV_OBJ_FLAG_HIDDEN);
+  kb_hide();
   lv_obj_clear_state(ta_ssid, LV_STATE_FOCUSED);
   lv_obj_clear_state(ta_pass, LV_STATE_FOCUSED);
 }
@@ -41,9 +65,10 @@ static void btn_connect_wifi_event_cb(lv_event_t *e) {
 static void btn_save_ip_event_cb(lv_event_t *e) {
   const char *ip = lv_textarea_get_text(ta_ip);
   DataManager.setPrinterIP(ip);
-  DataManager.updatePrinterStatus(); // Trigger immediate check
+  DataManager.requestPoll(); // Trigger immediate check
+  s_draft.dirty &= ~(1 << SF_IP);
 
-  lv_obj_add_flag(kb, LV_OBJ_FLAG_HIDDEN);
+  kb_hide();
   lv_obj_clear_state(ta_ip, LV_STATE_FOCUSED);
 }
 
@@ -53,13 +78,18 @@ static void btn_save_poll_event_cb(lv_event_t *e) {
   if (val < 500)
     val = 500; // Min 500ms
   DataManager.setPollInterval(val);
+  s_draft.dirty &= ~(1 << SF_POLL);
 
-  lv_obj_add_flag(kb, LV_OBJ_FLAG_HIDDEN);
+  kb_hide();
   lv_obj_clear_state(ta_poll, LV_STATE_FOCUSED);
 }
 
 static void btn_back_event_cb(lv_event_t *e) {
-  lv_scr_load(ui_ScreenDashboard);
+  ui_screen_load(UI_SCREEN_DASHBOARD);
+}
+
+static void btn_calibrate_event_cb(lv_event_t *e) {
+  ui_screen_load(UI_SCREEN_CALIBRATION);
 }
 
 static void btn_unit_event_cb(lv_event_t *e) {
@@ -68,13 +98,31 @@ static void btn_unit_event_cb(lv_event_t *e) {
   ui_settings_refresh(); // Refresh to update button states
 }
 
+// Unit buttons follow the discovered unit count and the active unit
+static void on_units(UiProp prop, int idx) { ui_settings_refresh(); }
+
 static void kb_event_cb(lv_event_t *e) {
   lv_event_code_t code = lv_event_get_code(e);
   if (code == LV_EVENT_READY || code == LV_EVENT_CANCEL) {
-    lv_obj_add_flag(kb, LV_OBJ_FLAG_HIDDEN);
+    kb_hide();
   }
 }
 
+// The screen is being torn down: keep unsaved edits, forget the widgets
+static void screen_delete_cb(lv_event_t *e) {
+  lv_obj_t *tas[SF_COUNT] = {ta_ssid, ta_pass, ta_ip, ta_poll};
+  for (int f = 0; f < SF_COUNT; f++) {
+    if (s_draft.dirty & (1 << f))
+      strlcpy(s_draft.text[f], lv_textarea_get_text(tas[f]),
+              sizeof(s_draft.text[f]));
+  }
+  ta_ssid = ta_pass = ta_ip = ta_poll = NULL;
+  kb = NULL;
+  cont_units = NULL;
+  memset(btn_units, 0, sizeof(btn_units));
+  last_unit_count = 0;
+}
+
 void ui_settings_refresh() {
   // NOTE: Do NOT refresh text areas here - it clears user input while typing!
   // Text areas are only populated on initial screen load in
@@ -146,6 +194,8 @@ void ui_screen_settings_init() {
   lv_obj_set_scrollbar_mode(
       ui_ScreenSettings,
       LV_SCROLLBAR_MODE_OFF); // Disable main screen scrollbar
+  lv_obj_add_event_cb(ui_ScreenSettings, screen_delete_cb, LV_EVENT_DELETE,
+                      NULL);
 
   /* Header (Fixed) */
   lv_obj_t *header = lv_obj_create(ui_ScreenSettings);
@@ -196,14 +246,16 @@ void ui_screen_settings_init() {
   lv_textarea_set_placeholder_text(ta_ssid, "SSID");
   lv_obj_set_size(ta_ssid, 400, 40);
   lv_obj_align(ta_ssid, LV_ALIGN_TOP_LEFT, 0, 30);
-  lv_obj_add_event_cb(ta_ssid, ta_event_cb, LV_EVENT_ALL, NULL);
+  lv_obj_add_event_cb(ta_ssid, ta_event_cb, LV_EVENT_ALL,
+                      (void *)(intptr_t)SF_SSID);
 
   ta_pass = lv_textarea_create(cont_wifi);
   lv_textarea_set_placeholder_text(ta_pass, "Password");
   lv_textarea_set_password_mode(ta_pass, true);
   lv_obj_set_size(ta_pass, 400, 40);
   lv_obj_align(ta_pass, LV_ALIGN_TOP_LEFT, 0, 80);
-  lv_obj_add_event_cb(ta_pass, ta_event_cb, LV_EVENT_ALL, NULL);
+  lv_obj_add_event_cb(ta_pass, ta_event_cb, LV_EVENT_ALL,
+                      (void *)(intptr_t)SF_PASS);
 
   lv_obj_t *btn_connect = lv_btn_create(cont_wifi);
   lv_obj_add_style(btn_connect, &style_btn_primary, 0);
@@ -230,7 +282,8 @@ void ui_screen_settings_init() {
   lv_textarea_set_placeholder_text(ta_ip, "printer.local or 192.168.1.100");
   lv_obj_set_size(ta_ip, 400, 40);
   lv_obj_align(ta_ip, LV_ALIGN_TOP_LEFT, 0, 30);
-  lv_obj_add_event_cb(ta_ip, ta_event_cb, LV_EVENT_ALL, NULL);
+  lv_obj_add_event_cb(ta_ip, ta_event_cb, LV_EVENT_ALL,
+                      (void *)(intptr_t)SF_IP);
 
   lv_obj_t *btn_save = lv_btn_create(cont_ip);
   lv_obj_add_style(btn_save, &style_btn_primary, 0);
@@ -256,7 +309,8 @@ void ui_screen_settings_init() {
   lv_textarea_set_accepted_chars(ta_poll, "0123456789");
   lv_obj_set_size(ta_poll, 400, 40);
   lv_obj_align(ta_poll, LV_ALIGN_TOP_LEFT, 0, 30);
-  lv_obj_add_event_cb(ta_poll, ta_event_cb, LV_EVENT_ALL, NULL);
+  lv_obj_add_event_cb(ta_poll, ta_event_cb, LV_EVENT_ALL,
+                      (void *)(intptr_t)SF_POLL);
 
   lv_obj_t *btn_save_poll = lv_btn_create(cont_poll);
   lv_obj_add_style(btn_save_poll, &style_btn_primary, 0);
@@ -281,21 +335,47 @@ void ui_screen_settings_init() {
 
   // Buttons will be created dynamically in ui_settings_refresh()
 
-  /* Keyboard - Stays on root screen to remain on top */
-  kb = lv_keyboard_create(ui_ScreenSettings);
-  lv_obj_set_size(kb, 480, 160);
-  lv_obj_align(kb, LV_ALIGN_BOTTOM_MID, 0, 0);
-  lv_obj_add_flag(kb, LV_OBJ_FLAG_HIDDEN);
-  lv_obj_add_event_cb(kb, kb_event_cb, LV_EVENT_ALL, NULL);
-
-  /* Populate with saved values */
-  lv_textarea_set_text(ta_ssid, DataManager.getSSID().c_str());
-  lv_textarea_set_text(ta_pass, DataManager.getPass().c_str());
-  lv_textarea_set_text(ta_ip, DataManager.getPrinterIP().c_str());
+  /* Touch Calibration */
+  lv_obj_t *cont_touch = lv_obj_create(cont_main);
+  lv_obj_set_size(cont_touch, 440, 100);
+  lv_obj_set_pos(cont_touch, 20, 660); // Below unit selection
+  lv_obj_add_style(cont_touch, &style_card, 0);
+
+  lv_obj_t *lbl_touch = lv_label_create(cont_touch);
+  lv_label_set_text(lbl_touch, "Touch Screen");
+  lv_obj_add_style(lbl_touch, &style_text_title, 0);
+  lv_obj_align(lbl_touch, LV_ALIGN_TOP_LEFT, 0, 0);
+
+  lv_obj_t *btn_calibrate = lv_btn_create(cont_touch);
+  lv_obj_add_style(btn_calibrate, &style_btn_primary, 0);
+  lv_obj_set_size(btn_calibrate, 120, 40);
+  lv_obj_align(btn_calibrate, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+  lv_obj_add_event_cb(btn_calibrate, btn_calibrate_event_cb, LV_EVENT_CLICKED,
+                      NULL);
+  lv_obj_t *lbl_calibrate = lv_label_create(btn_calibrate);
+  lv_label_set_text(lbl_calibrate, "Calibrate");
+  lv_obj_center(lbl_calibrate);
+
+  /* Populate with saved values, or with unsaved edits from the last visit */
   char buf[16];
   sprintf(buf, "%u", DataManager.getPollInterval());
-  lv_textarea_set_text(ta_poll, buf);
+  String saved[SF_COUNT] = {DataManager.getSSID(), DataManager.getPass(),
+                            DataManager.getPrinterIP(), String(buf)};
+  lv_obj_t *tas[SF_COUNT] = {ta_ssid, ta_pass, ta_ip, ta_poll};
+  uint8_t dirty = s_draft.dirty;
+  for (int f = 0; f < SF_COUNT; f++)
+    lv_textarea_set_text(tas[f], (dirty & (1 << f)) ? s_draft.text[f]
+                                                    : saved[f].c_str());
+  s_draft.dirty = dirty; // Filling the text areas is not an edit
 
   // Create initial unit buttons
   ui_settings_refresh();
+
+  // Subscriptions outlive the screen; on_units is a no-op while it is gone
+  static bool observed = false;
+  if (!observed) {
+    ui_observe(UI_PROP_UNIT, on_units);
+    ui_observe(UI_PROP_UNIT_COUNT, on_units);
+    observed = true;
+  }
 }
@@ -0,0 +1,214 @@
+#include "network/network_manager.h"
+#include "ui/ui.h"
+
+/* Heater history chart. The chart runs in circular mode with one column per
+ * history point: point n of a tier always sits in column n % capacity, so
+ * a new sample overwrites the oldest column and LVGL redraws only that
+ * strip of the chart. The whole tier is copied in only when the screen is
+ * built, the tier changes or the chart fell a full ring behind. Values are
+ * the history's tenths of a degree, used as chart coordinates unchanged. */
+
+#define TC_CHUNK 32        // Points copied per history read
+#define TC_MAX_TENTHS 3000 // Top of the chart, 300 C
+
+lv_obj_t *ui_ScreenTemps = NULL; // Built on first use
+
+/* Widgets; all NULL while the screen is not built */
+static lv_obj_t *chart;
+static lv_obj_t *label_tier;
+static lv_obj_t *label_legend[TH_SENSORS];
+static lv_chart_series_t *s_series[TH_SENSORS];
+
+static TempTier s_tier = TT_FINE; // Kept across visits
+static uint32_t s_end = 0;        // Next history point to append
+
+static const uint32_t kColors[TH_SENSORS] = {0xFF6B6B, 0x4A90E2, 0x4CD964,
+                                             0xFFCC00, 0xFF00FF, 0x00FFFF};
+
+static lv_coord_t chart_value(int16_t v) {
+  return v == TH_NONE ? LV_CHART_POINT_NONE : v;
+}
+
+// Blank the column after the newest point, so the sweep shows where "now"
+// is and the newest point is not joined to the oldest
+static void mark_head() {
+  uint16_t head = s_end % TempHistory::capacity(s_tier);
+  for (auto ser : s_series)
+    lv_chart_set_value_by_id(chart, ser, head, LV_CHART_POINT_NONE);
+}
+
+// Copy the whole tier into the chart
+static void chart_fill() {
+  uint16_t cap = TempHistory::capacity(s_tier);
+  lv_chart_set_point_count(chart, cap);
+  uint32_t end = DataManager.getTempHistoryEnd(s_tier);
+  uint32_t from = end > cap ? end - cap : 0;
+
+  TempPoint pts[TC_CHUNK];
+  for (int s = 0; s < TH_SENSORS; s++) {
+    lv_coord_t *y = lv_chart_get_y_array(chart, s_series[s]);
+    for (uint16_t i = 0; i < cap; i++)
+      y[i] = LV_CHART_POINT_NONE;
+    for (uint32_t i = from; i < end;) {
+      uint16_t want = end - i < TC_CHUNK ? end - i : TC_CHUNK;
+      uint16_t n = DataManager.readTempHistory(s_tier, s, i, pts, want);
+      if (n == 0)
+        break;
+      for (uint16_t k = 0; k < n; k++, i++)
+        y[i % cap] = chart_value(pts[k].current);
+    }
+    lv_chart_set_x_start_point(chart, s_series[s], end % cap);
+  }
+  s_end = end;
+  mark_head();
+  lv_chart_refresh(chart);
+}
+
+// Append the points sampled since the last call, one column each
+static void chart_append() {
+  uint32_t end = DataManager.getTempHistoryEnd(s_tier);
+  if (end == s_end)
+    return;
+  if (end - s_end >= TempHistory::capacity(s_tier)) {
+    chart_fill();
+    return;
+  }
+
+  TempPoint pts[TC_CHUNK];
+  while (s_end < end) {
+    uint16_t want = end - s_end < TC_CHUNK ? end - s_end : TC_CHUNK;
+    uint16_t n = want;
+    for (int s = 0; s < TH_SENSORS; s++) {
+      n = DataManager.readTempHistory(s_tier, s, s_end, pts, want);
+      for (uint16_t k = 0; k < n; k++)
+        lv_chart_set_next_value(chart, s_series[s],
+                                chart_value(pts[k].current));
+    }
+    if (n == 0)
+      break;
+    s_end += n;
+  }
+  mark_head();
+}
+
+// Heater names and readings, in the colour of their line
+static void legend_update() {
+  const PrinterModel &m = DataManager.getModel();
+  for (int s = 0; s < TH_SENSORS; s++) {
+    bool present = s < m.heaterCount;
+    lv_chart_hide_series(chart, s_series[s], !present);
+    if (!present) {
+      ui_observe_set_label(label_legend[s], "");
+      continue;
+    }
+
+    char name[8] = "Bed";
+    if (s > 0)
+      snprintf(name, sizeof(name), "H%d", s);
+    for (int t = 0; t < m.toolCount && t < PM_MAX_TOOLS; t++) {
+      if (m.toolHeater[t] == s)
+        snprintf(name, sizeof(name), "T%d", t);
+    }
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%s %.1f/%.0f", name, m.heaters[s].current,
+             m.heaters[s].active);
+    ui_observe_set_label(label_legend[s], buf);
+  }
+}
+
+static void on_history(UiProp prop, int idx) {
+  if (!chart)
+    return;
+  chart_append();
+  legend_update();
+}
+
+static void btn_tier_event_cb(lv_event_t *e) {
+  s_tier = s_tier == TT_FINE ? TT_COARSE : TT_FINE;
+  lv_label_set_text(label_tier, s_tier == TT_FINE ? "10 min" : "6 h");
+  chart_fill();
+}
+
+static void screen_delete_cb(lv_event_t *e) {
+  chart = NULL;
+  label_tier = NULL;
+  memset(label_legend, 0, sizeof(label_legend));
+  memset(s_series, 0, sizeof(s_series));
+}
+
+void ui_screen_temps_init() {
+  ui_ScreenTemps = lv_obj_create(NULL);
+  lv_obj_add_style(ui_ScreenTemps, &style_base_screen, 0);
+  lv_obj_clear_flag(ui_ScreenTemps, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_event_cb(ui_ScreenTemps, screen_delete_cb, LV_EVENT_DELETE,
+                      NULL);
+
+  /* Header (same as settings) */
+  lv_obj_t *header = lv_obj_create(ui_ScreenTemps);
+  lv_obj_set_size(header, 480, 50);
+  lv_obj_set_style_bg_color(header, lv_color_hex(0x252526), 0);
+  lv_obj_align(header, LV_ALIGN_TOP_MID, 0, 0);
+  lv_obj_clear_flag(header, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_set_scrollbar_mode(header, LV_SCROLLBAR_MODE_OFF);
+  lv_obj_set_style_pad_all(header, 0, 0);
+  lv_obj_set_style_border_width(header, 0, 0);
+
+  lv_obj_t *lbl_header = lv_label_create(header);
+  lv_label_set_text(lbl_header, "Temperatures");
+  lv_obj_set_style_text_font(lbl_header, &lv_font_montserrat_20, 0);
+  lv_obj_set_style_text_color(lbl_header, lv_color_hex(0xFFFFFF), 0);
+  lv_obj_align(lbl_header, LV_ALIGN_LEFT_MID, 10, 0);
+
+  lv_obj_t *btn_tier = lv_btn_create(header);
+  lv_obj_set_size(btn_tier, 90, 50);
+  lv_obj_align(btn_tier, LV_ALIGN_RIGHT_MID, -110, 0);
+  lv_obj_add_event_cb(btn_tier, btn_tier_event_cb, LV_EVENT_CLICKED, NULL);
+  label_tier = lv_label_create(btn_tier);
+  lv_label_set_text(label_tier, s_tier == TT_FINE ? "10 min" : "6 h");
+  lv_obj_center(label_tier);
+
+  lv_obj_t *btn_back = lv_btn_create(header);
+  lv_obj_set_size(btn_back, 100, 50);
+  lv_obj_align(btn_back, LV_ALIGN_RIGHT_MID, -5, 0);
+  lv_obj_add_event_cb(
+      btn_back, [](lv_event_t *e) { ui_screen_load(UI_SCREEN_DASHBOARD); },
+      LV_EVENT_CLICKED, NULL);
+  lv_obj_t *lbl_back = lv_label_create(btn_back);
+  lv_label_set_text(lbl_back, "Back");
+  lv_obj_center(lbl_back);
+
+  /* Legend */
+  for (int s = 0; s < TH_SENSORS; s++) {
+    label_legend[s] = lv_label_create(ui_ScreenTemps);
+    lv_label_set_text(label_legend[s], "");
+    lv_obj_set_style_text_font(label_legend[s], &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(label_legend[s], lv_color_hex(kColors[s]),
+                                0);
+    lv_obj_set_pos(label_legend[s], 10 + (s % 3) * 155, 56 + (s / 3) * 18);
+  }
+
+  /* Chart */
+  chart = lv_chart_create(ui_ScreenTemps);
+  lv_obj_set_size(chart, 460, 220);
+  lv_obj_set_pos(chart, 10, 96);
+  lv_chart_set_type(chart, LV_CHART_TYPE_LINE);
+  lv_chart_set_update_mode(chart, LV_CHART_UPDATE_MODE_CIRCULAR);
+  lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, 0, TC_MAX_TENTHS);
+  lv_chart_set_div_line_count(chart, 7, 0); // Every 50 C
+  lv_obj_set_style_bg_color(chart, lv_color_hex(0x1e1e2e), 0);
+  lv_obj_set_style_border_color(chart, lv_color_hex(0x3a3a4a), 0);
+  lv_obj_set_style_line_color(chart, lv_color_hex(0x3a3a4a), 0);
+  lv_obj_set_style_size(chart, 0, LV_PART_INDICATOR); // No point markers
+  lv_obj_set_style_line_width(chart, 2, LV_PART_ITEMS);
+  for (int s = 0; s < TH_SENSORS; s++)
+    s_series[s] = lv_chart_add_series(chart, lv_color_hex(kColors[s]),
+                                      LV_CHART_AXIS_PRIMARY_Y);
+  chart_fill();
+  legend_update();
+
+  static bool observed = false;
+  if (!observed) {
+    observed = true;
+    ui_observe(UI_PROP_TEMP_HISTORY, on_history);
+  }
+}
@@ -1,8 +1,7 @@
 #include "ui.h"
 #include "../network/network_manager.h"
+#include <esp_heap_caps.h>
 
-// External bypass flag from main.cpp
-extern bool g_bypass_calibration;
 #include "screens/ui_calibration.h"
 
 /* Global Styles */
@@ -11,10 +10,11 @@ lv_style_t style_card;
 lv_style_t style_text_title;
 lv_style_t style_text_value;
 lv_style_t style_btn_primary;
+static lv_style_t style_card_cached; // Card layout over a cached image
 
 /* Objects */
 lv_obj_t *ui_ScreenDashboard;
-lv_obj_t *ui_ScreenSettings;
+lv_obj_t *ui_ScreenSettings = NULL; // Built on first use
 lv_obj_t *label_printer_name = NULL;
 lv_obj_t *label_clock = NULL;
 
@@ -44,6 +44,14 @@ void ui_theme_init() {
   lv_style_set_shadow_color(&style_card, lv_color_hex(0x000000));
   lv_style_set_shadow_opa(&style_card, 60); // More prominent shadow
 
+  /* Same geometry, nothing drawn: the look comes from ui_card_create() */
+  lv_style_init(&style_card_cached);
+  lv_style_set_bg_opa(&style_card_cached, LV_OPA_TRANSP);
+  lv_style_set_border_width(&style_card_cached, 0);
+  lv_style_set_shadow_width(&style_card_cached, 0);
+  lv_style_set_radius(&style_card_cached, 14);
+  lv_style_set_pad_all(&style_card_cached, 12);
+
   /* Text Styles */
   lv_style_init(&style_text_title);
   lv_style_set_text_font(&style_text_title, &lv_font_montserrat_14);
@@ -67,60 +75,214 @@ void ui_theme_init() {
   lv_style_set_shadow_opa(&style_btn_primary, 50);   // Visible glow
 }
 
+lv_color_t ui_led_color(int led) {
+  switch (led) {
+  case LED_RED:
+    return lv_color_hex(0xFF0000);
+  case LED_GREEN:
+    return lv_color_hex(0x00FF00);
+  case LED_BLUE:
+    return lv_color_hex(0x0000FF);
+  case LED_WHITE:
+    return lv_color_hex(0xFFFFFF);
+  case LED_YELLOW:
+    return lv_color_hex(0xFFFF00);
+  case LED_MAGENTA:
+    return lv_color_hex(0xFF00FF);
+  case LED_CYAN:
+    return lv_color_hex(0x00FFFF);
+  }
+  return lv_color_hex(0x888888); // Default gray
+}
+
+/* Card cache. A card's background, border and 25 px shadow are static, but
+ * LVGL re-renders all of them whenever anything inside the card is
+ * invalidated, and software shadows are among the most expensive things it
+ * draws. Instead, one card of each size is rendered once into an
+ * ARGB image in PSRAM; each card is then that image plus a transparent
+ * container for its children, so a label update only blends a small image
+ * region behind the label. */
+#if UI_CARD_CACHE && LV_USE_SNAPSHOT
+#define UI_CARD_CACHE_SLOTS 4
+
+static struct {
+  lv_coord_t w, h;
+  lv_coord_t ext; // Shadow overhang around the card
+  lv_img_dsc_t img;
+} s_card_cache[UI_CARD_CACHE_SLOTS];
+
+static const lv_img_dsc_t *card_image(lv_obj_t *parent, lv_coord_t w,
+                                      lv_coord_t h, lv_coord_t *ext) {
+  int slot = 0;
+  for (; slot < UI_CARD_CACHE_SLOTS && s_card_cache[slot].w; slot++) {
+    if (s_card_cache[slot].w == w && s_card_cache[slot].h == h) {
+      *ext = s_card_cache[slot].ext;
+      return &s_card_cache[slot].img;
+    }
+  }
+  if (slot == UI_CARD_CACHE_SLOTS)
+    return NULL;
+
+  // Render a throwaway card of this size once
+  lv_obj_t *proto = lv_obj_create(parent);
+  lv_obj_add_style(proto, &style_card, 0);
+  lv_obj_set_size(proto, w, h);
+  lv_obj_update_layout(proto);
+
+  const lv_img_cf_t cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+  uint32_t size = lv_snapshot_buf_size_needed(proto, cf);
+  void *buf = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  lv_img_dsc_t *img = &s_card_cache[slot].img;
+  bool ok = buf && lv_snapshot_take_to_buf(proto, cf, img, buf, size) ==
+                       LV_RES_OK;
+  *ext = _lv_obj_get_ext_draw_size(proto);
+  lv_obj_del(proto);
+  if (!ok) {
+    heap_caps_free(buf);
+    return NULL;
+  }
+
+  s_card_cache[slot].w = w;
+  s_card_cache[slot].h = h;
+  s_card_cache[slot].ext = *ext;
+  return img;
+}
+#endif
+
+lv_obj_t *ui_card_create(lv_obj_t *parent, lv_coord_t x, lv_coord_t y,
+                         lv_coord_t w, lv_coord_t h) {
+#if UI_CARD_CACHE && LV_USE_SNAPSHOT
+  lv_coord_t ext = 0;
+  const lv_img_dsc_t *src = card_image(parent, w, h, &ext);
+  if (src) {
+    lv_obj_t *img = lv_img_create(parent);
+    lv_img_set_src(img, src);
+    lv_obj_set_pos(img, x - ext, y - ext);
+    lv_obj_clear_flag(img, LV_OBJ_FLAG_CLICKABLE);
+
+    lv_obj_t *card = lv_obj_create(parent);
+    lv_obj_remove_style_all(card);
+    lv_obj_add_style(card, &style_card_cached, 0);
+    lv_obj_set_size(card, w, h);
+    lv_obj_set_pos(card, x, y);
+    return card;
+  }
+#endif
+  lv_obj_t *card = lv_obj_create(parent);
+  lv_obj_add_style(card, &style_card, 0);
+  lv_obj_set_size(card, w, h);
+  lv_obj_set_pos(card, x, y);
+  return card;
+}
+
+/* Screens, indexed by UiScreen. Only resident screens survive being left. */
+static const struct {
+  const char *name;
+  void (*build)();
+  lv_obj_t **scr;
+  bool resident;
+} kScreens[UI_SCREEN_COUNT] = {
+    {"Dashboard", ui_screen_dashboard_init, &ui_ScreenDashboard, true},
+    {"Settings", ui_screen_settings_init, &ui_ScreenSettings, false},
+    {"Calibration", ui_calibration_screen_init, &ui_ScreenCalibration, false},
+    {"Overview", ui_screen_overview_init, &ui_ScreenOverview, false},
+    {"Temperatures", ui_screen_temps_init, &ui_ScreenTemps, false},
+};
+
+static UiScreenStats s_screen_stats[UI_SCREEN_COUNT];
+static UiScreen s_screen = UI_SCREEN_DASHBOARD;
+
+static uint32_t lv_mem_used() {
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  return mon.total_size - mon.free_size;
+}
+
+void ui_mem_log(const char *tag) {
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  Serial.printf("UI: %s: LVGL heap %u/%u used (%u%%), peak %u, "
+                "largest free %u, frag %u%%\n",
+                tag, (unsigned)(mon.total_size - mon.free_size),
+                (unsigned)mon.total_size, (unsigned)mon.used_pct,
+                (unsigned)mon.max_used, (unsigned)mon.free_biggest_size,
+                (unsigned)mon.frag_pct);
+}
+
+static void screen_build(UiScreen id) {
+  uint32_t used = lv_mem_used();
+  uint32_t start = micros();
+  kScreens[id].build();
+  uint32_t us = micros() - start;
+
+  UiScreenStats &st = s_screen_stats[id];
+  st.builds++;
+  st.lastBuildUs = us;
+  if (us > st.maxBuildUs)
+    st.maxBuildUs = us;
+  st.memBytes = (int32_t)(lv_mem_used() - used);
+  Serial.printf("UI: built %s in %u.%03u ms, %d bytes LVGL heap\n",
+                kScreens[id].name, (unsigned)(us / 1000),
+                (unsigned)(us % 1000), (int)st.memBytes);
+}
+
+void ui_screen_load(UiScreen id) {
+  if (id >= UI_SCREEN_COUNT)
+    return;
+  if (!*kScreens[id].scr)
+    screen_build(id);
+  UiScreen prev = s_screen;
+  s_screen = id;
+  lv_scr_load(*kScreens[id].scr);
+
+#ifndef UI_KEEP_SCREENS
+  if (prev != id && !kScreens[prev].resident && *kScreens[prev].scr) {
+    // Usually called from a button on the screen being left, so the delete
+    // has to wait until that event has finished
+    lv_obj_del_async(*kScreens[prev].scr);
+    *kScreens[prev].scr = NULL;
+  }
+#endif
+}
+
+const UiScreenStats &ui_screen_stats(UiScreen id) {
+  return s_screen_stats[id < UI_SCREEN_COUNT ? id : UI_SCREEN_DASHBOARD];
+}
+
 void ui_init() {
   ui_theme_init();
-  ui_screen_dashboard_init();
-  ui_screen_settings_init();
-  ui_calibration_screen_init();
-
-  /* Load dashboard screen with calibration */
-  g_bypass_calibration = false;
+  screen_build(UI_SCREEN_DASHBOARD);
   lv_scr_load(ui_ScreenDashboard);
+  ui_observe_invalidate(); // Fill every bound widget on the first pass
+  ui_mem_log("boot");
 }
 
 void ui_update_status() {
-  static float lastProg = -1.0f;
-  static String lastStatus = "";
-  static String lastName = "";
-  static String lastTime = "";
-  static int lastToolIdx = -1;
-  static int lastActiveUnit = -1;
-  static bool lastLaneLoaded[4] = {false, false, false, false};
-  static String lastLaneNames[4] = {"", "", "", ""};
-
-  float progress = DataManager.getProgress();
-  String status = DataManager.getStatus();
-  String name = DataManager.getPrinterName();
-  String time = DataManager.getFormattedTime();
-  int toolIdx = DataManager.getSelectedTool();
-  int activeUnit = DataManager.getActiveAFCUnit();
-
-  bool laneChanged = (activeUnit != lastActiveUnit);
-  for (int i = 0; i < 4; i++) {
-    int idx = activeUnit * 4 + i;
-    if (DataManager.isLaneLoaded(idx) != lastLaneLoaded[i] ||
-        DataManager.getLaneName(idx) != lastLaneNames[i]) {
-      laneChanged = true;
-      lastLaneLoaded[i] = DataManager.isLaneLoaded(idx);
-      lastLaneNames[i] = DataManager.getLaneName(idx);
-    }
-  }
-  lastActiveUnit = activeUnit;
-
-  if (progress != lastProg || status != lastStatus || name != lastName ||
-      time != lastTime || toolIdx != lastToolIdx || laneChanged) {
-    ui_dashboard_update(status.c_str(), progress, name.c_str(), time.c_str(),
-                        toolIdx);
-    lastProg = progress;
-    lastStatus = status;
-    lastName = name;
-    lastTime = time;
-    lastToolIdx = toolIdx;
-  }
+  ui_observe_poll();
 
-  // Refresh settings screen to update unit buttons when new units discovered
-  if (lv_scr_act() == ui_ScreenSettings) {
-    extern void ui_settings_refresh();
-    ui_settings_refresh();
+#ifdef UI_OBSERVE_STATS
+  static uint32_t lastLog = 0;
+  if (millis() - lastLog > 10000) {
+    const UiObserveStats &st = ui_observe_stats();
+    Serial.printf("UI: polls=%u syncs=%u events=%u updates=%u skipped=%u "
+                  "allocs=%u\n",
+                  (unsigned)st.polls, (unsigned)st.syncs, (unsigned)st.events,
+                  (unsigned)st.updates, (unsigned)st.skipped,
+                  (unsigned)st.allocs);
+    Serial.printf("UI: redraws=%u last=%upx max=%upx avg=%upx %ums total\n",
+                  (unsigned)st.redraws, (unsigned)st.lastRedrawPx,
+                  (unsigned)st.maxRedrawPx,
+                  (unsigned)(st.redraws ? st.redrawPx / st.redraws : 0),
+                  (unsigned)st.redrawMs);
+    const UiModalStats &ms = ui_modal_stats();
+    Serial.printf("UI: modal opens=%u last=%uus max=%uus avg=%uus frag=%u%% "
+                  "max frag=%u%%\n",
+                  (unsigned)ms.opens, (unsigned)ms.lastOpenUs,
+                  (unsigned)ms.maxOpenUs,
+                  (unsigned)(ms.opens ? ms.totalOpenUs / ms.opens : 0),
+                  (unsigned)ms.fragPct, (unsigned)ms.maxFragPct);
+    ui_mem_log(kScreens[s_screen].name);
+    lastLog = millis();
   }
+#endif
 }
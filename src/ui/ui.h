@@ -1,9 +1,15 @@
 #pragma once
 #include <lvgl.h>
 
+#include "ui_modal.h"
+#include "ui_observe.h"
+
 /* UI Events and Global State */
 void ui_init();
-void ui_update_status(); // Call this periodically or on event
+void ui_update_status(); // Call every loop pass: raises model change events
+#ifdef UI_BENCHMARK
+void ui_bench_run(void (*wait_flush)()); // Scripted redraw benchmark
+#endif
 
 /* Theme & Styles */
 void ui_theme_init();
@@ -13,15 +19,61 @@ extern lv_style_t style_text_title;
 extern lv_style_t style_text_value;
 extern lv_style_t style_btn_primary;
 
+/* Card with style_card's look. With UI_CARD_CACHE the static background,
+ * border and shadow come from an image rendered once per card size. */
+#ifndef UI_CARD_CACHE
+#define UI_CARD_CACHE 1
+#endif
+lv_obj_t *ui_card_create(lv_obj_t *parent, lv_coord_t x, lv_coord_t y,
+                         lv_coord_t w, lv_coord_t h);
+
 /* Screens */
 extern lv_obj_t *ui_ScreenDashboard;
 extern lv_obj_t *ui_ScreenSettings;
 extern lv_obj_t *ui_ScreenCalibration;
+extern lv_obj_t *ui_ScreenOverview;
+extern lv_obj_t *ui_ScreenTemps;
 
 void ui_screen_dashboard_init();
-void ui_dashboard_update(const char *status, float progress, const char *name,
-                         const char *time, int toolIdx);
 void ui_screen_settings_init();
+void ui_screen_overview_init(); // Every unit and lane in one grid
+void ui_screen_temps_init();    // Heater history chart
+
+/* Display colour for an AFC_LED_array value */
+lv_color_t ui_led_color(int led);
+
+/* Dashboard modals (pooled): configure for a lane and show */
+void ui_dashboard_lane_options(int lane);
+int ui_dashboard_lanes(); // Lane cards shown for the active unit
+
+/* Filament picker: searchable, virtualized list over the filament catalog */
+void ui_filament_picker_create(lv_obj_t *parent);
+void ui_filament_picker_open(int lane);
+void ui_filament_picker_search(const char *query); // As if typed
+void ui_filament_picker_scroll(int32_t top);       // List offset in px
+
+/* Screen navigation. The dashboard is built in ui_init(); every other
+ * screen is built the first time it is shown and deleted again when it is
+ * left, unless the firmware is built with -D UI_KEEP_SCREENS. */
+enum UiScreen : uint8_t {
+  UI_SCREEN_DASHBOARD,
+  UI_SCREEN_SETTINGS,
+  UI_SCREEN_CALIBRATION,
+  UI_SCREEN_OVERVIEW,
+  UI_SCREEN_TEMPS,
+  UI_SCREEN_COUNT
+};
+
+struct UiScreenStats {
+  uint32_t builds;
+  uint32_t lastBuildUs;
+  uint32_t maxBuildUs;
+  int32_t memBytes; // LVGL heap taken by the last build
+};
+
+void ui_screen_load(UiScreen id);
+const UiScreenStats &ui_screen_stats(UiScreen id);
+void ui_mem_log(const char *tag); // lv_mem_monitor() figures on Serial
 
 /* Navigation */
 void ui_nav_create(lv_obj_t *parent);
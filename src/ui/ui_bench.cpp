@@ -0,0 +1,271 @@
+#ifdef UI_BENCHMARK
+#include "../network/network_manager.h"
+#include "ui.h"
+
+/* Scripted UI benchmark: replays synthetic printer-model changes through
+ * the normal change-event path on the real display and reports, per step,
+ * the render time, the redrawn area and the LVGL heap in use. A modal soak
+ * then opens and closes the pooled modals and tracks LVGL heap use and
+ * fragmentation, and the filament picker is timed against synthetic
+ * catalogs of up to 2,000 names. The all-units overview is timed at its
+ * largest, 8 units of 8 lanes. Enable with -D UI_BENCHMARK; it runs once
+ * at boot before the network model arrives. */
+
+typedef void (*ui_bench_step_t)(PrinterModel &m, int i);
+
+static int s_base = 0;  // First lane of the active unit in PrinterModel::lanes
+static int s_lanes = 1; // Lane cards the dashboard shows for it
+
+static LaneInfo &lane(PrinterModel &m, int i) {
+  return m.lanes[s_base + i % s_lanes];
+}
+
+static void step_idle(PrinterModel &m, int i) {}
+static void step_status(PrinterModel &m, int i) {
+  m.status = (i & 1) ? PS_PROCESSING : PS_IDLE;
+}
+static void step_led(PrinterModel &m, int i) {
+  lane(m, i).led = (LedColor)(i % (LED_CYAN + 1));
+}
+static void step_loaded(PrinterModel &m, int i) {
+  lane(m, i).loaded = !lane(m, i).loaded;
+}
+static void step_filament(PrinterModel &m, int i) {
+  snprintf(lane(m, i).filament, PM_NAME_LEN, "PLA %d", i);
+}
+static void step_all_lanes(PrinterModel &m, int i) {
+  for (int l = 0; l < s_lanes; l++) {
+    lane(m, l).loaded = (i + l) & 1;
+    lane(m, l).led = (LedColor)((i + l) % (LED_CYAN + 1));
+    snprintf(lane(m, l).filament, PM_NAME_LEN, "PETG %d", i + l);
+  }
+}
+
+struct UiBenchStep {
+  const char *name;
+  ui_bench_step_t step;
+};
+
+static const UiBenchStep kSteps[] = {
+    {"idle", step_idle},
+    {"status", step_status},
+    {"lane LED", step_led},
+    {"lane loaded", step_loaded},
+    {"lane filament", step_filament},
+    {"all lanes", step_all_lanes},
+};
+
+/* Overview steps, on a model of PM_MAX_UNITS x PM_MAX_UNIT_LANES */
+static void step_grid_lane(PrinterModel &m, int i) {
+  LaneInfo &l = m.lanes[i * 7 % PM_MAX_LANES];
+  l.loaded = !l.loaded;
+}
+static void step_grid_unit(PrinterModel &m, int i) {
+  for (int l = 0; l < PM_MAX_UNIT_LANES; l++)
+    m.lanes[PrinterModel::laneIndex(i % PM_MAX_UNITS, l)].led =
+        (LedColor)((i + l) % (LED_CYAN + 1));
+}
+static void step_grid_all(PrinterModel &m, int i) {
+  for (int l = 0; l < PM_MAX_LANES; l++)
+    snprintf(m.lanes[l].filament, PM_NAME_LEN, "PLA %d", i + l);
+}
+
+static const UiBenchStep kGridSteps[] = {
+    {"overview idle", step_idle},
+    {"overview one lane", step_grid_lane},
+    {"overview one unit", step_grid_unit},
+    {"overview all lanes", step_grid_all},
+};
+
+// Publish each step's change, deliver it and draw it; log per step
+static void run_steps(PrinterModel &m, const UiBenchStep *steps, int count,
+                      void (*wait_flush)()) {
+  const int reps = 16;
+  for (int s = 0; s < count; s++) {
+    uint32_t us = 0, px = 0, maxPx = 0;
+    for (int i = 0; i < reps; i++) {
+      steps[s].step(m, i);
+      uint32_t before = ui_observe_stats().redraws;
+      uint32_t start = micros();
+      DataManager.benchSetModel(m);
+      ui_update_status();
+      lv_refr_now(NULL);
+      wait_flush();
+      us += micros() - start;
+      if (ui_observe_stats().redraws != before) {
+        uint32_t p = ui_observe_stats().lastRedrawPx;
+        px += p;
+        if (p > maxPx)
+          maxPx = p;
+      }
+    }
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    Serial.printf("UIBENCH: %s, %u, %u, %u, %u\n", steps[s].name,
+                  (unsigned)(us / reps), (unsigned)(px / reps),
+                  (unsigned)maxPx,
+                  (unsigned)(mon.total_size - mon.free_size));
+  }
+}
+
+// Fill every unit and lane, open the overview and change lanes under it.
+// A lane change should cost one cell, not the grid.
+static void overview_bench(PrinterModel &m, void (*wait_flush)()) {
+  m.unitCount = PM_MAX_UNITS;
+  for (int u = 0; u < PM_MAX_UNITS; u++)
+    m.unitLanes[u] = PM_MAX_UNIT_LANES;
+  for (int i = 0; i < PM_MAX_LANES; i++) {
+    m.lanes[i].loaded = i & 1;
+    m.lanes[i].tool = i;
+    m.lanes[i].led = (LedColor)(i % (LED_CYAN + 1));
+    snprintf(m.lanes[i].filament, PM_NAME_LEN, "PETG %d", i);
+  }
+  DataManager.benchSetModel(m);
+  ui_update_status();
+
+  uint32_t start = micros();
+  ui_screen_load(UI_SCREEN_OVERVIEW);
+  lv_refr_now(NULL);
+  wait_flush();
+  uint32_t openUs = micros() - start;
+  const UiScreenStats &st = ui_screen_stats(UI_SCREEN_OVERVIEW);
+  Serial.printf("UIBENCH: overview %dx%d, open %u us, build %u us, "
+                "%d bytes LVGL heap\n",
+                PM_MAX_UNITS, PM_MAX_UNIT_LANES, (unsigned)openUs,
+                (unsigned)st.lastBuildUs, (int)st.memBytes);
+
+  run_steps(m, kGridSteps, sizeof(kGridSteps) / sizeof(kGridSteps[0]),
+            wait_flush);
+
+  ui_screen_load(UI_SCREEN_DASHBOARD);
+  lv_refr_now(NULL);
+  wait_flush();
+}
+
+static void log_soak(int cycle) {
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  const UiModalStats &st = ui_modal_stats();
+  Serial.printf("UIBENCH: modal soak, %d, %u, %u, %u, %u, %u\n", cycle,
+                (unsigned)(st.opens ? st.totalOpenUs / st.opens : 0),
+                (unsigned)st.maxOpenUs,
+                (unsigned)(mon.total_size - mon.free_size),
+                (unsigned)mon.free_biggest_size, (unsigned)mon.frag_pct);
+}
+
+// Open and close the pooled modals, alternating between them and between
+// lanes, drawing each state as a tap would
+static void modal_soak(void (*wait_flush)()) {
+  const int cycles = 1000;
+  Serial.println("UIBENCH: modal soak, cycle, avg open us, max open us, "
+                 "lvgl used, largest free, frag %");
+  log_soak(0);
+  for (int i = 1; i <= cycles; i++) {
+    if (i & 1)
+      ui_filament_picker_open(i % s_lanes);
+    else
+      ui_dashboard_lane_options(i % s_lanes);
+    lv_refr_now(NULL);
+    wait_flush();
+    ui_modal_hide_all();
+    lv_refr_now(NULL);
+    wait_flush();
+    if (i % 250 == 0)
+      log_soak(i);
+  }
+}
+
+// Time a UI action through to the end of its redraw
+static uint32_t timed(void (*wait_flush)(), void (*action)(int), int arg) {
+  uint32_t start = micros();
+  action(arg);
+  lv_refr_now(NULL);
+  wait_flush();
+  return micros() - start;
+}
+
+static const char kQuery[] = "polymaker petg";
+static char s_query[sizeof(kQuery)];
+static void act_open(int lane) { ui_filament_picker_open(lane); }
+static void act_search(int len) {
+  strlcpy(s_query, kQuery, len + 1); // First len letters
+  ui_filament_picker_search(s_query);
+}
+static void act_scroll(int top) { ui_filament_picker_scroll(top); }
+
+// Open the picker, type a query a letter at a time and scroll the full
+// list, each step drawn. All of it should fit in a frame at any size.
+static void filament_bench(void (*wait_flush)()) {
+  static const char *const kBrands[] = {"Prusament", "Polymaker", "eSun",
+                                        "Sunlu",     "Elegoo",    "Bambu",
+                                        "Overture",  "Hatchbox"};
+  static const char *const kTypes[] = {"PLA", "PETG", "ABS", "ASA",
+                                       "TPU", "PA-CF", "PC"};
+  static const int kSizes[] = {100, 1000, 2000};
+
+  Serial.println("UIBENCH: filaments, entries, catalog bytes, build us, "
+                 "open us, avg key us, max key us, avg scroll us, "
+                 "max scroll us");
+  for (int n : kSizes) {
+    FilamentCatalog catalog;
+    uint32_t start = micros();
+    for (int i = 0; i < n; i++) {
+      char name[FC_MAX_NAME];
+      int len = snprintf(name, sizeof(name), "%s %s %04d", kBrands[i % 8],
+                         kTypes[i / 8 % 7], i);
+      catalog.add(name, len);
+    }
+    catalog.finish();
+    uint32_t buildUs = micros() - start;
+    size_t bytes = catalog.bytes();
+    DataManager.benchSetFilaments(catalog);
+    ui_update_status(); // Deliver the catalog change
+
+    uint32_t openUs = timed(wait_flush, act_open, 0);
+
+    const int keys = sizeof(kQuery) - 1;
+    uint32_t keyUs = 0, maxKeyUs = 0;
+    for (int len = 1; len <= keys; len++) {
+      uint32_t us = timed(wait_flush, act_search, len);
+      keyUs += us;
+      if (us > maxKeyUs)
+        maxKeyUs = us;
+    }
+
+    timed(wait_flush, act_search, 0);
+    const int scrolls = 40;
+    uint32_t scrollUs = 0, maxScrollUs = 0;
+    for (int i = 1; i <= scrolls; i++) {
+      // Jumps through the whole list: every row is rebound each step
+      uint32_t us = timed(wait_flush, act_scroll, n * 34 * i / scrolls);
+      scrollUs += us;
+      if (us > maxScrollUs)
+        maxScrollUs = us;
+    }
+    ui_modal_hide_all();
+    lv_refr_now(NULL);
+    wait_flush();
+
+    Serial.printf("UIBENCH: filaments, %d, %u, %u, %u, %u, %u, %u, %u\n", n,
+                  (unsigned)bytes, (unsigned)buildUs, (unsigned)openUs,
+                  (unsigned)(keyUs / keys), (unsigned)maxKeyUs,
+                  (unsigned)(scrollUs / scrolls), (unsigned)maxScrollUs);
+  }
+}
+
+void ui_bench_run(void (*wait_flush)()) {
+  static PrinterModel m; // Too large for the loop task stack
+  m = DataManager.getModel();
+  s_base = PrinterModel::laneIndex(DataManager.getActiveAFCUnit(), 0);
+  if (s_base + UI_OBSERVE_LANES > PM_MAX_LANES)
+    s_base = 0;
+  s_lanes = ui_dashboard_lanes();
+
+  Serial.println("UIBENCH: step, avg us, avg px, max px, lvgl used");
+  run_steps(m, kSteps, sizeof(kSteps) / sizeof(kSteps[0]), wait_flush);
+  overview_bench(m, wait_flush);
+
+  modal_soak(wait_flush);
+  filament_bench(wait_flush);
+}
+#endif
@@ -0,0 +1,375 @@
+#include "../network/network_manager.h"
+#include "ui.h"
+#include <esp_heap_caps.h>
+
+/* Filament picker: a pooled modal with a search box over a virtualized list.
+ *
+ * Only FP_ROWS row widgets exist, however large the catalog. They form a
+ * ring: catalog row r is drawn by slot r % FP_ROWS, so scrolling by one row
+ * rebinds one label. LVGL coordinates top out at 8191 px, far short of a
+ * 1,000-entry list, so the list is not an LVGL scroll container: it keeps
+ * its own 32-bit scroll offset and places the rows relative to it. */
+#define FP_ROW_H 34
+#define FP_LIST_H 170
+#define FP_ROWS (FP_LIST_H / FP_ROW_H + 2) // Visible rows plus a partial one
+#define FP_DRAG_SLOP 8                     // px of travel before a drag
+
+static lv_obj_t *fp_modal = NULL;
+static lv_obj_t *fp_title;
+static lv_obj_t *fp_count_label;
+static lv_obj_t *fp_ta;
+static lv_obj_t *fp_kb;
+static lv_obj_t *fp_list;
+static lv_obj_t *fp_thumb; // Scroll position indicator
+static lv_obj_t *fp_rows[FP_ROWS];
+static lv_obj_t *fp_row_labels[FP_ROWS];
+static lv_style_t fp_row_style;
+
+/* Picker state, plain data */
+static struct {
+  int lane;
+  uint32_t seq;      // Catalog the indices below refer to
+  uint16_t *buf[2];  // Search results, double buffered for narrowing
+  uint16_t cap;      // Entries per buffer
+  uint16_t *match;   // Current result, one of buf[]
+  uint16_t count;    // Entries in match
+  bool valid;        // match holds the result for query
+  char query[FC_MAX_NAME];
+  int32_t top;       // Scroll offset in px
+  int32_t dragged;   // Travel since the press, px
+  int selected;      // Catalog index, -1 for none
+  int bound[FP_ROWS]; // Catalog index shown by each slot, -1 for none
+  lv_coord_t rowY[FP_ROWS];
+  bool filling;      // Programmatic text change, not typing
+} fp;
+
+// Flag changes invalidate even when nothing changes; skip those
+static void fp_set_hidden(lv_obj_t *obj, bool hidden) {
+  if (lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN) == hidden)
+    return;
+  if (hidden)
+    lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+  else
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+}
+
+static int32_t fp_max_top() {
+  int32_t total = (int32_t)fp.count * FP_ROW_H;
+  return total > FP_LIST_H ? total - FP_LIST_H : 0;
+}
+
+// Place and label the rows that intersect the viewport
+static void fp_layout() {
+  if (fp.top > fp_max_top())
+    fp.top = fp_max_top();
+  if (fp.top < 0)
+    fp.top = 0;
+
+  int first = fp.top / FP_ROW_H;
+  for (int r = first; r < first + FP_ROWS; r++) {
+    int k = r % FP_ROWS;
+    lv_obj_t *row = fp_rows[k];
+    if (r >= fp.count) {
+      fp_set_hidden(row, true);
+      fp.bound[k] = -1;
+      continue;
+    }
+
+    int idx = fp.match[r];
+    if (fp.bound[k] != idx) {
+      char name[FC_MAX_NAME];
+      DataManager.copyFilamentName(idx, name, sizeof(name));
+      lv_label_set_text(fp_row_labels[k], name);
+      fp.bound[k] = idx;
+    }
+    lv_coord_t y = r * FP_ROW_H - fp.top;
+    if (fp.rowY[k] != y) {
+      lv_obj_set_y(row, y);
+      fp.rowY[k] = y;
+    }
+    if (idx == fp.selected)
+      lv_obj_add_state(row, LV_STATE_CHECKED);
+    else
+      lv_obj_clear_state(row, LV_STATE_CHECKED);
+    fp_set_hidden(row, false);
+  }
+
+  // Thumb: proportional height, at least a finger's width
+  int32_t total = (int32_t)fp.count * FP_ROW_H;
+  if (total <= FP_LIST_H) {
+    fp_set_hidden(fp_thumb, true);
+  } else {
+    int32_t h = (int32_t)FP_LIST_H * FP_LIST_H / total;
+    if (h < 20)
+      h = 20;
+    lv_obj_set_height(fp_thumb, h);
+    lv_obj_set_y(fp_thumb, (FP_LIST_H - h) * fp.top / fp_max_top());
+    fp_set_hidden(fp_thumb, false);
+  }
+}
+
+// Size the result buffers for the current catalog; forget stale indices
+static void fp_sync_catalog() {
+  uint32_t seq = DataManager.getFilamentSeq();
+  if (fp.buf[0] && seq == fp.seq)
+    return;
+
+  uint16_t need = DataManager.getFilamentCount();
+  if (need == 0)
+    need = 1;
+  if (need > fp.cap) {
+    const uint32_t caps = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+    heap_caps_free(fp.buf[0]);
+    heap_caps_free(fp.buf[1]);
+    fp.buf[0] = (uint16_t *)heap_caps_malloc(need * sizeof(uint16_t), caps);
+    fp.buf[1] = (uint16_t *)heap_caps_malloc(need * sizeof(uint16_t), caps);
+    if (!fp.buf[0] || !fp.buf[1]) {
+      heap_caps_free(fp.buf[0]);
+      heap_caps_free(fp.buf[1]);
+      fp.buf[0] = fp.buf[1] = NULL;
+      fp.cap = 0;
+      fp.match = NULL;
+      fp.count = 0;
+      return;
+    }
+    fp.cap = need;
+  }
+  fp.match = fp.buf[0];
+  fp.count = 0;
+  fp.seq = seq;
+  fp.valid = false;
+  fp.selected = -1;
+  for (int k = 0; k < FP_ROWS; k++)
+    fp.bound[k] = -1;
+}
+
+static void fp_filter(const char *query, bool keepTop) {
+  if (!fp.buf[0])
+    return;
+  // A query extending the last one only needs to narrow its result
+  size_t plen = strlen(fp.query);
+  bool narrow = fp.valid && plen > 0 && strncasecmp(query, fp.query, plen) == 0;
+  uint16_t *out = fp.match == fp.buf[0] ? fp.buf[1] : fp.buf[0];
+  fp.count = DataManager.searchFilaments(query, out, fp.cap,
+                                         narrow ? fp.match : NULL,
+                                         narrow ? fp.count : 0);
+  fp.match = out;
+  fp.valid = true;
+  strlcpy(fp.query, query, sizeof(fp.query));
+  if (!keepTop)
+    fp.top = 0;
+
+  int total = DataManager.getFilamentCount();
+  if (total == 0)
+    lv_label_set_text(fp_count_label, "No filaments found");
+  else
+    lv_label_set_text_fmt(fp_count_label, "%u of %d", (unsigned)fp.count,
+                          total);
+  fp_layout();
+}
+
+static void fp_on_filaments(UiProp prop, int idx) {
+  if (!ui_modal_visible(fp_modal))
+    return; // Picked up on the next open
+  fp_sync_catalog();
+  fp_filter(lv_textarea_get_text(fp_ta), true);
+}
+
+static void fp_list_event_cb(lv_event_t *e) {
+  lv_event_code_t code = lv_event_get_code(e);
+  lv_indev_t *indev = lv_indev_get_act();
+  if (!indev)
+    return;
+
+  if (code == LV_EVENT_PRESSED) {
+    fp.dragged = 0;
+  } else if (code == LV_EVENT_PRESSING) {
+    lv_point_t v;
+    lv_indev_get_vect(indev, &v);
+    fp.dragged += LV_ABS(v.y);
+    if (fp.dragged > FP_DRAG_SLOP && v.y) {
+      fp.top -= v.y;
+      fp_layout();
+    }
+  } else if (code == LV_EVENT_CLICKED && fp.dragged <= FP_DRAG_SLOP) {
+    lv_point_t p;
+    lv_indev_get_point(indev, &p);
+    lv_area_t a;
+    lv_obj_get_coords(fp_list, &a);
+    int r = (p.y - a.y1 + fp.top) / FP_ROW_H;
+    if (r >= 0 && r < fp.count) {
+      fp.selected = fp.match[r];
+      fp_layout();
+    }
+  }
+}
+
+static void fp_ta_event_cb(lv_event_t *e) {
+  lv_event_code_t code = lv_event_get_code(e);
+  if (code == LV_EVENT_CLICKED || code == LV_EVENT_FOCUSED) {
+    lv_keyboard_set_textarea(fp_kb, fp_ta);
+    lv_obj_clear_flag(fp_kb, LV_OBJ_FLAG_HIDDEN);
+  } else if (code == LV_EVENT_VALUE_CHANGED && !fp.filling) {
+    fp_filter(lv_textarea_get_text(fp_ta), false);
+  }
+}
+
+static void fp_kb_event_cb(lv_event_t *e) {
+  lv_event_code_t code = lv_event_get_code(e);
+  if (code == LV_EVENT_READY || code == LV_EVENT_CANCEL) {
+    lv_obj_add_flag(fp_kb, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_clear_state(fp_ta, LV_STATE_FOCUSED);
+  }
+}
+
+void ui_filament_picker_create(lv_obj_t *parent) {
+  fp_modal = ui_modal_create(parent, 470, 310);
+  lv_obj_set_style_bg_color(fp_modal, lv_color_hex(0x1E1E1E), 0);
+  lv_obj_set_style_border_color(fp_modal, lv_color_hex(0x444444), 0);
+  lv_obj_set_style_border_width(fp_modal, 2, 0);
+  lv_obj_set_style_pad_all(fp_modal, 6, 0);
+
+  // Title and match count
+  fp_title = lv_label_create(fp_modal);
+  lv_label_set_text(fp_title, "Select Filament");
+  lv_obj_set_style_text_font(fp_title, &lv_font_montserrat_16, 0);
+  lv_obj_align(fp_title, LV_ALIGN_TOP_LEFT, 0, 0);
+
+  fp_count_label = lv_label_create(fp_modal);
+  lv_label_set_text(fp_count_label, "");
+  lv_obj_set_style_text_color(fp_count_label, lv_color_hex(0xAAAAAA), 0);
+  lv_obj_align(fp_count_label, LV_ALIGN_TOP_RIGHT, 0, 2);
+
+  // Search box
+  fp_ta = lv_textarea_create(fp_modal);
+  lv_textarea_set_one_line(fp_ta, true);
+  lv_textarea_set_placeholder_text(fp_ta, "Search filaments");
+  lv_textarea_set_max_length(fp_ta, FC_MAX_NAME - 1);
+  lv_obj_set_size(fp_ta, lv_pct(100), 40);
+  lv_obj_align(fp_ta, LV_ALIGN_TOP_LEFT, 0, 24);
+  lv_obj_add_event_cb(fp_ta, fp_ta_event_cb, LV_EVENT_ALL, NULL);
+
+  // List viewport: rows are placed by fp_layout(), not scrolled by LVGL
+  fp_list = lv_obj_create(fp_modal);
+  lv_obj_set_size(fp_list, lv_pct(100), FP_LIST_H);
+  lv_obj_align(fp_list, LV_ALIGN_TOP_LEFT, 0, 70);
+  lv_obj_set_style_pad_all(fp_list, 0, 0);
+  lv_obj_set_style_border_width(fp_list, 0, 0);
+  lv_obj_set_style_bg_color(fp_list, lv_color_hex(0x161620), 0);
+  lv_obj_clear_flag(fp_list, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_event_cb(fp_list, fp_list_event_cb, LV_EVENT_ALL, NULL);
+
+  lv_style_init(&fp_row_style);
+  lv_style_set_bg_opa(&fp_row_style, LV_OPA_COVER);
+  lv_style_set_bg_color(&fp_row_style, lv_color_hex(0x26263a));
+  lv_style_set_radius(&fp_row_style, 6);
+  lv_style_set_pad_hor(&fp_row_style, 10);
+  lv_style_set_text_color(&fp_row_style, lv_color_hex(0xFFFFFF));
+
+  for (int k = 0; k < FP_ROWS; k++) {
+    // Rows take no input: presses fall through to the list
+    lv_obj_t *row = lv_obj_create(fp_list);
+    lv_obj_remove_style_all(row);
+    lv_obj_add_style(row, &fp_row_style, 0);
+    lv_obj_set_style_bg_color(row, lv_color_hex(0x7c3aed), LV_STATE_CHECKED);
+    lv_obj_set_size(row, lv_pct(100), FP_ROW_H - 2);
+    lv_obj_clear_flag(row, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(row, LV_OBJ_FLAG_HIDDEN);
+
+    fp_row_labels[k] = lv_label_create(row);
+    lv_label_set_long_mode(fp_row_labels[k], LV_LABEL_LONG_DOT);
+    lv_obj_set_width(fp_row_labels[k], lv_pct(100));
+    lv_obj_align(fp_row_labels[k], LV_ALIGN_LEFT_MID, 0, 0);
+
+    fp_rows[k] = row;
+    fp.bound[k] = -1;
+    fp.rowY[k] = LV_COORD_MIN;
+  }
+
+  fp_thumb = lv_obj_create(fp_list);
+  lv_obj_remove_style_all(fp_thumb);
+  lv_obj_set_style_bg_opa(fp_thumb, LV_OPA_60, 0);
+  lv_obj_set_style_bg_color(fp_thumb, lv_color_hex(0xAAAAAA), 0);
+  lv_obj_set_style_radius(fp_thumb, 2, 0);
+  lv_obj_set_width(fp_thumb, 4);
+  lv_obj_align(fp_thumb, LV_ALIGN_TOP_RIGHT, 0, 0);
+  lv_obj_clear_flag(fp_thumb, LV_OBJ_FLAG_CLICKABLE);
+  lv_obj_add_flag(fp_thumb, LV_OBJ_FLAG_HIDDEN);
+
+  // OK Button
+  lv_obj_t *btn_ok = lv_btn_create(fp_modal);
+  lv_obj_set_size(btn_ok, 120, 40);
+  lv_obj_align(btn_ok, LV_ALIGN_BOTTOM_LEFT, 10, 0);
+  lv_obj_set_style_bg_color(btn_ok, lv_color_hex(0x4CD964), 0);
+
+  lv_obj_t *lbl_ok = lv_label_create(btn_ok);
+  lv_label_set_text(lbl_ok, "OK");
+  lv_obj_center(lbl_ok);
+
+  lv_obj_add_event_cb(
+      btn_ok,
+      [](lv_event_t *e) {
+        // Indices are only meaningful for the catalog they came from
+        if (fp.lane >= 0 && fp.selected >= 0 &&
+            DataManager.getFilamentSeq() == fp.seq) {
+          String filamentName = DataManager.getFilamentName(fp.selected);
+          int unit = DataManager.getActiveAFCUnit();
+          DataManager.setLaneFilament(unit, fp.lane, filamentName);
+        }
+        ui_modal_hide(fp_modal);
+      },
+      LV_EVENT_CLICKED, NULL);
+
+  // Cancel Button
+  lv_obj_t *btn_cancel = lv_btn_create(fp_modal);
+  lv_obj_set_size(btn_cancel, 120, 40);
+  lv_obj_align(btn_cancel, LV_ALIGN_BOTTOM_RIGHT, -10, 0);
+  lv_obj_set_style_bg_color(btn_cancel, lv_color_hex(0xFF6B6B), 0);
+
+  lv_obj_t *lbl_cancel = lv_label_create(btn_cancel);
+  lv_label_set_text(lbl_cancel, "Cancel");
+  lv_obj_center(lbl_cancel);
+
+  lv_obj_add_event_cb(
+      btn_cancel, [](lv_event_t *e) { ui_modal_hide(fp_modal); },
+      LV_EVENT_CLICKED, NULL);
+
+  // Keyboard over the lower half while the search box has focus
+  fp_kb = lv_keyboard_create(fp_modal);
+  lv_obj_set_size(fp_kb, lv_pct(100), 150);
+  lv_obj_align(fp_kb, LV_ALIGN_BOTTOM_MID, 0, 0);
+  lv_obj_add_flag(fp_kb, LV_OBJ_FLAG_HIDDEN);
+  lv_obj_add_event_cb(fp_kb, fp_kb_event_cb, LV_EVENT_ALL, NULL);
+
+  fp.lane = -1;
+  fp.selected = -1;
+  ui_observe(UI_PROP_FILAMENTS, fp_on_filaments);
+}
+
+void ui_filament_picker_open(int lane) {
+  uint32_t start = micros();
+  fp.lane = lane;
+
+  char title[32];
+  snprintf(title, sizeof(title), "Select Filament - Lane %d", lane);
+  lv_label_set_text(fp_title, title);
+  lv_obj_add_flag(fp_kb, LV_OBJ_FLAG_HIDDEN);
+
+  fp_sync_catalog();
+  fp.selected = -1;
+  fp.filling = true;
+  lv_textarea_set_text(fp_ta, "");
+  fp.filling = false;
+  fp.valid = false;
+  fp_filter("", false);
+  ui_modal_show(fp_modal, start);
+}
+
+void ui_filament_picker_search(const char *query) {
+  lv_textarea_set_text(fp_ta, query); // Filters via VALUE_CHANGED
+}
+
+void ui_filament_picker_scroll(int32_t top) {
+  fp.top = top;
+  fp_layout();
+}
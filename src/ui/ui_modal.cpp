@@ -0,0 +1,71 @@
+#include "ui_modal.h"
+#include <Arduino.h>
+
+static lv_obj_t *s_pool[UI_MODAL_POOL];
+static UiModalStats s_stats;
+static bool s_opening = false; // A shown modal has not been drawn yet
+static uint32_t s_openStart = 0;
+
+lv_obj_t *ui_modal_create(lv_obj_t *parent, lv_coord_t w, lv_coord_t h) {
+  lv_obj_t *modal = lv_obj_create(parent);
+  lv_obj_set_size(modal, w, h);
+  lv_obj_center(modal);
+  lv_obj_clear_flag(modal, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(modal, LV_OBJ_FLAG_HIDDEN);
+
+  for (auto &slot : s_pool) {
+    if (slot == NULL) {
+      slot = modal;
+      return modal;
+    }
+  }
+  LV_LOG_WARN("ui_modal: pool full");
+  return modal;
+}
+
+void ui_modal_show(lv_obj_t *modal, uint32_t startUs) {
+  for (auto slot : s_pool) {
+    if (slot && slot != modal)
+      lv_obj_add_flag(slot, LV_OBJ_FLAG_HIDDEN);
+  }
+  lv_obj_clear_flag(modal, LV_OBJ_FLAG_HIDDEN);
+  lv_obj_move_foreground(modal);
+
+  s_stats.opens++;
+  s_openStart = startUs ? startUs : micros();
+  s_opening = true;
+}
+
+void ui_modal_hide(lv_obj_t *modal) {
+  if (!modal || lv_obj_has_flag(modal, LV_OBJ_FLAG_HIDDEN))
+    return;
+  lv_obj_add_flag(modal, LV_OBJ_FLAG_HIDDEN);
+
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  s_stats.fragPct = mon.frag_pct;
+  if (mon.frag_pct > s_stats.maxFragPct)
+    s_stats.maxFragPct = mon.frag_pct;
+}
+
+void ui_modal_hide_all() {
+  for (auto slot : s_pool)
+    ui_modal_hide(slot);
+}
+
+bool ui_modal_visible(lv_obj_t *modal) {
+  return modal && !lv_obj_has_flag(modal, LV_OBJ_FLAG_HIDDEN);
+}
+
+const UiModalStats &ui_modal_stats() { return s_stats; }
+
+void ui_modal_record_redraw() {
+  if (!s_opening)
+    return;
+  s_opening = false;
+  uint32_t us = micros() - s_openStart;
+  s_stats.lastOpenUs = us;
+  if (us > s_stats.maxOpenUs)
+    s_stats.maxOpenUs = us;
+  s_stats.totalOpenUs += us;
+}
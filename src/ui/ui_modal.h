@@ -0,0 +1,35 @@
+#pragma once
+#include <lvgl.h>
+#include <stdint.h>
+
+/* Modal pool.
+ *
+ * Modals are built once, hidden, and from then on only reconfigured and
+ * shown or hidden. Opening one therefore allocates nothing from the LVGL
+ * heap, so repeated opening neither fragments it nor waits on a rebuild.
+ * Pooled modals must live on a resident screen. */
+#define UI_MODAL_POOL 4
+
+struct UiModalStats {
+  uint32_t opens;
+  uint32_t lastOpenUs; // Open request to the end of the first redraw
+  uint32_t maxOpenUs;
+  uint64_t totalOpenUs;
+  uint8_t fragPct;     // LVGL heap fragmentation at the last close
+  uint8_t maxFragPct;
+};
+
+/* Hidden, centred container on parent, added to the pool */
+lv_obj_t *ui_modal_create(lv_obj_t *parent, lv_coord_t w, lv_coord_t h);
+
+/* Show a modal, hiding any other. startUs is when the open was requested
+ * (0: now), so reconfiguring the modal counts towards time-to-open. */
+void ui_modal_show(lv_obj_t *modal, uint32_t startUs = 0);
+void ui_modal_hide(lv_obj_t *modal);
+void ui_modal_hide_all();
+bool ui_modal_visible(lv_obj_t *modal);
+
+const UiModalStats &ui_modal_stats();
+
+/* Feed from lv_disp_drv_t.monitor_cb: completes a pending time-to-open */
+void ui_modal_record_redraw();
@@ -0,0 +1,254 @@
+#include "ui_observe.h"
+#include "../network/network_manager.h"
+#include <time.h>
+
+static_assert(UI_OBSERVE_LANES == PM_MAX_UNIT_LANES,
+              "the dashboard shows every lane a unit can have");
+
+/* Last delivered values. Plain data only: comparing them allocates nothing */
+static struct {
+  PrinterStatus status;
+  bool wifiConnected;
+  uint32_t localIP;
+  char ssid[sizeof(PrinterModel::ssid)];
+  int progress;
+  char name[sizeof(PrinterModel::printerName)];
+  uint32_t clockSec;
+  int unit;
+  int unitCount;
+  bool laneLoaded[UI_OBSERVE_LANES];
+  char laneFilament[UI_OBSERVE_LANES][PM_NAME_LEN];
+  LedColor laneLed[UI_OBSERVE_LANES];
+  uint8_t unitLanes[PM_MAX_UNITS]; // PrinterModel::laneCount()
+  LaneInfo lanes[PM_MAX_LANES]; // Every unit, for the overview
+  uint32_t filamentSeq;
+  uint32_t historySeq;
+} s_last;
+
+static bool s_force = true; // Nothing delivered yet
+static uint32_t s_modelSeq = 0;
+static ui_prop_cb_t s_subs[UI_PROP_COUNT][UI_OBSERVE_SUBSCRIBERS];
+static UiObserveStats s_stats;
+
+void ui_observe(UiProp prop, ui_prop_cb_t cb) {
+  for (int i = 0; i < UI_OBSERVE_SUBSCRIBERS; i++) {
+    if (s_subs[prop][i] == NULL) {
+      s_subs[prop][i] = cb;
+      return;
+    }
+  }
+  LV_LOG_WARN("ui_observe: too many subscribers");
+}
+
+void ui_observe_invalidate() { s_force = true; }
+
+const UiObserveStats &ui_observe_stats() { return s_stats; }
+
+int ui_observe_unit() { return s_last.unit; }
+
+static bool lane_equal(const LaneInfo &a, const LaneInfo &b) {
+  return a.loaded == b.loaded && a.tool == b.tool && a.led == b.led &&
+         strcmp(a.filament, b.filament) == 0;
+}
+
+static void notify(UiProp prop, int index = 0) {
+  s_stats.events++;
+  for (int i = 0; i < UI_OBSERVE_SUBSCRIBERS && s_subs[prop][i]; i++)
+    s_subs[prop][i](prop, index);
+}
+
+/* Seconds counter for the clock: wall time once NTP has synced, uptime
+ * before that */
+static bool clock_synced(struct tm *tm) {
+  time_t now = time(NULL);
+  localtime_r(&now, tm);
+  return tm->tm_year > (2016 - 1900);
+}
+
+static uint32_t clock_second() {
+  struct tm tm;
+  return clock_synced(&tm) ? (uint32_t)time(NULL) : millis() / 1000;
+}
+
+void ui_observe_clock_text(char *buf, size_t len) {
+  struct tm tm;
+  if (clock_synced(&tm)) {
+    strftime(buf, len, "%H:%M:%S", &tm);
+  } else {
+    uint32_t s = millis() / 1000;
+    snprintf(buf, len, "%02u:%02u:%02u", (unsigned)(s / 3600),
+             (unsigned)(s / 60 % 60), (unsigned)(s % 60));
+  }
+}
+
+void ui_observe_set_label(lv_obj_t *label, const char *text) {
+  if (!label)
+    return;
+  if (strcmp(lv_label_get_text(label), text) == 0) {
+    s_stats.skipped++;
+    return;
+  }
+  lv_label_set_text(label, text); // LVGL keeps its own copy
+  s_stats.updates++;
+  s_stats.allocs++;
+}
+
+void ui_observe_set_text_color(lv_obj_t *obj, lv_color_t color) {
+  if (!obj)
+    return;
+  if (lv_obj_get_style_text_color(obj, LV_PART_MAIN).full == color.full) {
+    s_stats.skipped++;
+    return;
+  }
+  lv_obj_set_style_text_color(obj, color, 0);
+  s_stats.updates++;
+}
+
+void ui_observe_set_bg_color(lv_obj_t *obj, lv_color_t color) {
+  if (!obj)
+    return;
+  if (lv_obj_get_style_bg_color(obj, LV_PART_MAIN).full == color.full) {
+    s_stats.skipped++;
+    return;
+  }
+  lv_obj_set_style_bg_color(obj, color, 0);
+  s_stats.updates++;
+}
+
+void ui_observe_set_border_color(lv_obj_t *obj, lv_color_t color) {
+  if (!obj)
+    return;
+  if (lv_obj_get_style_border_color(obj, LV_PART_MAIN).full == color.full) {
+    s_stats.skipped++;
+    return;
+  }
+  lv_obj_set_style_border_color(obj, color, 0);
+  s_stats.updates++;
+}
+
+void ui_observe_set_state(lv_obj_t *obj, lv_state_t state, bool on) {
+  if (!obj)
+    return;
+  if (lv_obj_has_state(obj, state) == on) {
+    s_stats.skipped++;
+    return;
+  }
+  if (on)
+    lv_obj_add_state(obj, state);
+  else
+    lv_obj_clear_state(obj, state);
+  s_stats.updates++;
+}
+
+void ui_observe_record_redraw(uint32_t ms, uint32_t px) {
+  s_stats.redraws++;
+  s_stats.lastRedrawPx = px;
+  if (px > s_stats.maxRedrawPx)
+    s_stats.maxRedrawPx = px;
+  s_stats.redrawPx += px;
+  s_stats.redrawMs += ms;
+}
+
+void ui_observe_count_update() { s_stats.updates++; }
+
+void ui_observe_poll() {
+  s_stats.polls++;
+  bool force = s_force;
+  s_force = false;
+
+  uint32_t sec = clock_second();
+  if (force || sec != s_last.clockSec) {
+    s_last.clockSec = sec;
+    notify(UI_PROP_CLOCK);
+  }
+
+  uint32_t filamentSeq = DataManager.getFilamentSeq();
+  if (force || filamentSeq != s_last.filamentSeq) {
+    s_last.filamentSeq = filamentSeq;
+    notify(UI_PROP_FILAMENTS);
+  }
+
+  uint32_t historySeq = DataManager.getTempHistorySeq();
+  if (force || historySeq != s_last.historySeq) {
+    s_last.historySeq = historySeq;
+    notify(UI_PROP_TEMP_HISTORY);
+  }
+
+  uint32_t seq = DataManager.getModelSeq();
+  int unit = DataManager.getActiveAFCUnit();
+  if (!force && seq == s_modelSeq && unit == s_last.unit)
+    return;
+  s_modelSeq = seq;
+  s_stats.syncs++;
+
+  const PrinterModel &m = DataManager.getModel();
+
+  if (force || m.status != s_last.status ||
+      m.wifiConnected != s_last.wifiConnected) {
+    s_last.status = m.status;
+    notify(UI_PROP_STATUS);
+  }
+  if (force || m.wifiConnected != s_last.wifiConnected ||
+      m.localIP != s_last.localIP || strcmp(m.ssid, s_last.ssid) != 0) {
+    s_last.wifiConnected = m.wifiConnected;
+    s_last.localIP = m.localIP;
+    strlcpy(s_last.ssid, m.ssid, sizeof(s_last.ssid));
+    notify(UI_PROP_NETWORK);
+  }
+  int progress = (int)m.progress;
+  if (force || progress != s_last.progress) {
+    s_last.progress = progress;
+    notify(UI_PROP_PROGRESS);
+  }
+  if (force || strcmp(m.printerName, s_last.name) != 0) {
+    strlcpy(s_last.name, m.printerName, sizeof(s_last.name));
+    notify(UI_PROP_PRINTER_NAME);
+  }
+  if (force || m.unitCount != s_last.unitCount) {
+    s_last.unitCount = m.unitCount;
+    notify(UI_PROP_UNIT_COUNT);
+  }
+  if (force || unit != s_last.unit) {
+    s_last.unit = unit;
+    notify(UI_PROP_UNIT);
+  }
+
+  for (int i = 0; i < UI_OBSERVE_LANES; i++) {
+    const LaneInfo *l = m.lane(unit, i);
+    bool loaded = l && l->loaded;
+    const char *filament = l ? l->filament : "";
+    LedColor led = l ? l->led : LED_UNKNOWN;
+
+    if (force || loaded != s_last.laneLoaded[i]) {
+      s_last.laneLoaded[i] = loaded;
+      notify(UI_PROP_LANE_LOADED, i);
+    }
+    if (force || strcmp(filament, s_last.laneFilament[i]) != 0) {
+      strlcpy(s_last.laneFilament[i], filament, PM_NAME_LEN);
+      notify(UI_PROP_LANE_FILAMENT, i);
+    }
+    if (force || led != s_last.laneLed[i]) {
+      s_last.laneLed[i] = led;
+      notify(UI_PROP_LANE_LED, i);
+    }
+  }
+
+  bool shape = force;
+  for (int u = 0; u < PM_MAX_UNITS; u++) {
+    if (m.laneCount(u) != s_last.unitLanes[u]) {
+      s_last.unitLanes[u] = m.laneCount(u); // 0 past the last unit
+      shape = true;
+    }
+  }
+  if (shape)
+    notify(UI_PROP_UNIT_LANES);
+  for (int u = 0; u < m.unitCount && u < PM_MAX_UNITS; u++) {
+    for (int l = 0; l < m.laneCount(u); l++) {
+      int i = PrinterModel::laneIndex(u, l);
+      if (force || !lane_equal(m.lanes[i], s_last.lanes[i])) {
+        s_last.lanes[i] = m.lanes[i];
+        notify(UI_PROP_LANE, i);
+      }
+    }
+  }
+}
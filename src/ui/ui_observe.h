@@ -0,0 +1,71 @@
+#pragma once
+#include <lvgl.h>
+#include <stdint.h>
+
+/* Observable dashboard properties.
+ *
+ * ui_observe_poll() runs every loop pass. It does no work unless the network
+ * task has published a new model snapshot, the active unit changed or the
+ * clock ticked over to a new second; it then compares plain values against
+ * the last ones it delivered and raises one event per changed property.
+ * Widgets subscribe per property, so each change touches only the widgets
+ * bound to it. */
+enum UiProp : uint8_t {
+  UI_PROP_STATUS,        // Printer status / connection
+  UI_PROP_NETWORK,       // Panel WiFi: connected, SSID, IP
+  UI_PROP_PROGRESS,      // Job progress, whole percent
+  UI_PROP_PRINTER_NAME,
+  UI_PROP_CLOCK,         // Once per second
+  UI_PROP_UNIT,          // Active AFC unit
+  UI_PROP_UNIT_COUNT,
+  UI_PROP_LANE_LOADED,   // index: lane within the active unit
+  UI_PROP_LANE_FILAMENT, // index: lane within the active unit
+  UI_PROP_LANE_LED,      // index: lane within the active unit
+  UI_PROP_UNIT_LANES,    // Units x lanes shape (AFC_unit_total_lanes)
+  UI_PROP_LANE,          // index: PrinterModel::laneIndex(), any unit
+  UI_PROP_FILAMENTS,     // Filament catalog refreshed
+  UI_PROP_TEMP_HISTORY,  // New heater history sample
+  UI_PROP_COUNT
+};
+
+#define UI_OBSERVE_LANES 8 // Lanes of the active unit: PM_MAX_UNIT_LANES
+#define UI_OBSERVE_SUBSCRIBERS 4
+
+typedef void (*ui_prop_cb_t)(UiProp prop, int index);
+
+struct UiObserveStats {
+  uint32_t polls;   // ui_observe_poll() calls
+  uint32_t syncs;   // Polls that had something to compare
+  uint32_t events;  // Property change events raised
+  uint32_t updates; // Widget writes that changed something
+  uint32_t skipped; // Widget writes dropped because nothing changed
+  uint32_t allocs;  // Heap allocations on the update path (LVGL text copies)
+
+  // Display refreshes, from the LVGL monitor callback
+  uint32_t redraws;
+  uint32_t lastRedrawPx;
+  uint32_t maxRedrawPx;
+  uint64_t redrawPx;
+  uint32_t redrawMs;
+};
+
+void ui_observe(UiProp prop, ui_prop_cb_t cb);
+void ui_observe_poll();
+void ui_observe_invalidate(); // Raise every property on the next poll
+const UiObserveStats &ui_observe_stats();
+
+/* Current values, valid inside a subscriber */
+int ui_observe_unit();
+void ui_observe_clock_text(char *buf, size_t len); // "HH:MM:SS"
+
+/* Widget writes for subscribers. Each compares against what the widget
+ * already shows and only writes (and so only invalidates) on a difference. */
+void ui_observe_set_label(lv_obj_t *label, const char *text);
+void ui_observe_set_text_color(lv_obj_t *obj, lv_color_t color);
+void ui_observe_set_bg_color(lv_obj_t *obj, lv_color_t color);
+void ui_observe_set_border_color(lv_obj_t *obj, lv_color_t color);
+void ui_observe_set_state(lv_obj_t *obj, lv_state_t state, bool on);
+void ui_observe_count_update();
+
+/* Feed from lv_disp_drv_t.monitor_cb: one call per display refresh */
+void ui_observe_record_redraw(uint32_t ms, uint32_t px);
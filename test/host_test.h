@@ -0,0 +1,49 @@
+#pragma once
+#include <stdio.h>
+
+/* Minimal test harness for the host build (see CMakeLists.txt).
+ *
+ *   TEST(coalesces_setpoints) {
+ *     CHECK(q.pending() == 1);
+ *     CHECK_EQ(q.coalesced(), 9);
+ *   }
+ *
+ * Every TEST in a file runs in order of definition; a failed check is
+ * reported with its line and the test carries on. The executable exits
+ * non-zero when any check failed. */
+typedef void (*HostTestFn)();
+
+struct HostTest {
+  HostTest(const char *name, HostTestFn fn);
+};
+
+void host_test_fail(const char *file, int line, const char *expr);
+void host_test_fail_eq(const char *file, int line, const char *expr,
+                       double actual, double expected);
+
+#define TEST(name)                                                            \
+  static void test_##name();                                                  \
+  static HostTest host_test_##name(#name, test_##name);                       \
+  static void test_##name()
+
+#define CHECK(cond)                                                           \
+  do {                                                                        \
+    if (!(cond))                                                              \
+      host_test_fail(__FILE__, __LINE__, #cond);                              \
+  } while (0)
+
+// Numeric equality, printing both sides on failure
+#define CHECK_EQ(actual, expected)                                            \
+  do {                                                                        \
+    double a_ = (double)(actual), e_ = (double)(expected);                    \
+    if (a_ != e_)                                                             \
+      host_test_fail_eq(__FILE__, __LINE__, #actual, a_, e_);                 \
+  } while (0)
+
+// |actual - expected| <= tol
+#define CHECK_NEAR(actual, expected, tol)                                     \
+  do {                                                                        \
+    double a_ = (double)(actual), e_ = (double)(expected);                    \
+    if (!(a_ - e_ <= (tol) && e_ - a_ <= (tol)))                              \
+      host_test_fail_eq(__FILE__, __LINE__, #actual, a_, e_);                 \
+  } while (0)
@@ -0,0 +1,45 @@
+#include "host_test.h"
+#include <vector>
+
+namespace {
+struct Entry {
+  const char *name;
+  HostTestFn fn;
+};
+
+std::vector<Entry> &registry() {
+  static std::vector<Entry> tests;
+  return tests;
+}
+
+int s_failures = 0;
+} // namespace
+
+HostTest::HostTest(const char *name, HostTestFn fn) {
+  registry().push_back({name, fn});
+}
+
+void host_test_fail(const char *file, int line, const char *expr) {
+  fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expr);
+  s_failures++;
+}
+
+void host_test_fail_eq(const char *file, int line, const char *expr,
+                       double actual, double expected) {
+  fprintf(stderr, "%s:%d: %s is %g, expected %g\n", file, line, expr, actual,
+          expected);
+  s_failures++;
+}
+
+int main() {
+  int failed = 0;
+  for (const Entry &t : registry()) {
+    int before = s_failures;
+    t.fn();
+    bool ok = s_failures == before;
+    printf("%s %s\n", ok ? "PASS" : "FAIL", t.name);
+    failed += !ok;
+  }
+  printf("%d of %d tests failed\n", failed, (int)registry().size());
+  return failed ? 1 : 0;
+}
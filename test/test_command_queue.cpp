@@ -0,0 +1,159 @@
+// CommandQueue: coalescing rules, ordering, batching and completion state
+#include "host_test.h"
+#include "network/command_queue.h"
+#include <atomic>
+#include <thread>
+
+namespace {
+size_t drain(CommandQueue &q, GCodeCommand *out, size_t max = 8,
+             size_t chars = 384) {
+  return q.takeBatch(out, max, chars);
+}
+} // namespace
+
+TEST(ten_taps_become_one_setpoint) {
+  CommandQueue q;
+  uint32_t first = q.pushSetpoint(CMD_SETPOINT_BED, 65, "M140 S65");
+  for (int i = 2; i <= 10; i++) {
+    char g[32];
+    snprintf(g, sizeof(g), "M140 S%d", 60 + 5 * i);
+    CHECK_EQ(q.pushSetpoint(CMD_SETPOINT_BED, 60 + 5 * i, g), first);
+  }
+  CHECK_EQ(q.pending(), 1);
+  CHECK_EQ(q.coalesced(), 9);
+
+  GCodeCommand b[8];
+  CHECK_EQ(drain(q, b), 1);
+  CHECK_EQ(b[0].value, 110);
+  CHECK(strcmp(b[0].text, "M140 S110") == 0); // Newest text, too
+}
+
+TEST(plain_gcode_is_a_barrier) {
+  CommandQueue q;
+  uint32_t a = q.pushSetpoint(CMD_SETPOINT_BED, 60, "M140 S60");
+  q.push("M98 P\"heat_soak.g\"");
+  uint32_t c = q.pushSetpoint(CMD_SETPOINT_BED, 70, "M140 S70");
+  CHECK(c != a); // Not merged across the macro
+  CHECK_EQ(q.pending(), 3);
+
+  GCodeCommand b[8];
+  CHECK_EQ(drain(q, b), 3);
+  CHECK_EQ(b[0].value, 60);
+  CHECK(strncmp(b[1].text, "M98", 3) == 0);
+  CHECK_EQ(b[2].value, 70);
+}
+
+TEST(different_targets_commute_but_keep_their_slots) {
+  CommandQueue q;
+  uint32_t bed = q.pushSetpoint(CMD_SETPOINT_BED, 60, "M140 S60");
+  uint32_t t0 = q.pushSetpoint(CMD_SETPOINT_TOOL(0), 200, "G10 P0 S200");
+  CHECK_EQ(q.pushSetpoint(CMD_SETPOINT_BED, 65, "M140 S65"), bed);
+  CHECK_EQ(q.pushSetpoint(CMD_SETPOINT_TOOL(0), 210, "G10 P0 S210"), t0);
+  uint32_t t1 = q.pushSetpoint(CMD_SETPOINT_TOOL(1), 190, "G10 P1 S190");
+  CHECK(t1 != t0);
+
+  GCodeCommand b[8];
+  CHECK_EQ(drain(q, b), 3);
+  CHECK_EQ(b[0].id, bed); // First-queued order is kept
+  CHECK_EQ(b[0].value, 65);
+  CHECK_EQ(b[1].id, t0);
+  CHECK_EQ(b[1].value, 210);
+  CHECK_EQ(b[2].id, t1);
+}
+
+TEST(in_flight_setpoints_are_not_rewritten) {
+  CommandQueue q;
+  uint32_t a = q.pushSetpoint(CMD_SETPOINT_BED, 60, "M140 S60");
+  GCodeCommand b[8];
+  CHECK_EQ(drain(q, b), 1);
+  CHECK(q.state(a) == CMD_SENT);
+
+  uint32_t c = q.pushSetpoint(CMD_SETPOINT_BED, 70, "M140 S70");
+  CHECK(c != a);
+  CHECK_EQ(b[0].value, 60); // The copy being sent is untouched
+  q.complete(1, true);
+  CHECK_EQ(drain(q, b), 1);
+  CHECK_EQ(b[0].id, c);
+}
+
+TEST(batches_respect_count_and_length) {
+  CommandQueue q;
+  for (int i = 0; i < 5; i++)
+    q.push("G1 X10"); // 6 chars each, 7 with the separator
+  GCodeCommand b[8];
+  CHECK_EQ(drain(q, b, 3), 3);
+  q.complete(3, true);
+  CHECK_EQ(drain(q, b, 8, 6 + 7 - 1), 1); // The second would overflow
+  q.complete(1, true);
+
+  // A command longer than the limit still goes, on its own
+  q.push("M117 a message longer than the batch limit");
+  CHECK_EQ(drain(q, b, 8, 10), 1);
+}
+
+TEST(completion_states) {
+  CommandQueue q;
+  CHECK(q.state(0) == CMD_UNKNOWN);
+  uint32_t a = q.push("M300");
+  uint32_t c = q.push("M400");
+  CHECK(q.state(a) == CMD_PENDING);
+  GCodeCommand b[8];
+  drain(q, b, 1);
+  CHECK(q.state(a) == CMD_SENT);
+  CHECK(q.state(c) == CMD_PENDING);
+  q.complete(1, true);
+  CHECK(q.state(a) == CMD_ACKED);
+
+  drain(q, b);
+  q.complete(1, false);
+  CHECK(q.state(c) == CMD_FAILED);
+  CHECK(q.state(c + 1) == CMD_UNKNOWN); // Never issued
+  CHECK_EQ(q.pending(), 0);
+}
+
+TEST(full_queue_refuses_but_still_coalesces) {
+  CommandQueue q;
+  uint32_t bed = q.pushSetpoint(CMD_SETPOINT_BED, 60, "M140 S60");
+  for (int i = 1; i < CMD_QUEUE_DEPTH; i++)
+    CHECK(q.pushSetpoint(CMD_SETPOINT_TOOL(0), i, "G10 P0 S1") != 0);
+  CHECK_EQ(q.pending(), 2); // Tool taps merged into one slot
+
+  for (int i = 2; i < CMD_QUEUE_DEPTH; i++)
+    CHECK(q.push("M400") != 0);
+  CHECK_EQ(q.pending(), CMD_QUEUE_DEPTH);
+  CHECK_EQ(q.push("M400"), 0);
+  // The bed setpoint is behind a barrier now, so it cannot merge either
+  CHECK_EQ(q.pushSetpoint(CMD_SETPOINT_BED, 70, "M140 S70"), 0);
+  CHECK(q.state(bed) == CMD_PENDING);
+}
+
+TEST(ids_keep_order_across_threads) {
+  // UI thread queueing while the network task drains, as on the device
+  CommandQueue q;
+  std::atomic<bool> done{false};
+  uint32_t last = 0, out_of_order = 0, received = 0;
+  std::thread sender([&] {
+    GCodeCommand b[8];
+    while (!done || q.pending()) {
+      size_t n = q.takeBatch(b, 8, 384);
+      for (size_t i = 0; i < n; i++) {
+        out_of_order += b[i].id <= last;
+        last = b[i].id;
+      }
+      received += n;
+      q.complete(n, true);
+      std::this_thread::yield();
+    }
+  });
+  uint32_t pushed = 0;
+  while (pushed < 5000) {
+    if (q.push("G4 P0"))
+      pushed++;
+    else
+      std::this_thread::yield();
+  }
+  done = true;
+  sender.join();
+  CHECK_EQ(received, 5000);
+  CHECK_EQ(out_of_order, 0);
+}
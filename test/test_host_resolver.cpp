@@ -0,0 +1,154 @@
+// HostResolver on the virtual clock, against the scripted resolver in
+// host/shims/fake_dns.h
+#include "host_test.h"
+#include "fake_dns.h"
+#include "network/host_resolver.h"
+
+namespace {
+const uint32_t kPrinter = IPAddress(192, 168, 1, 20);
+const uint32_t kMoved = IPAddress(192, 168, 1, 21);
+
+void setup() {
+  fake_dns_reset();
+  host_clock_set(1000000);
+}
+
+void advance_ms(uint32_t ms) { host_clock_advance((uint64_t)ms * 1000); }
+} // namespace
+
+TEST(ip_literals_never_query) {
+  setup();
+  HostResolver r;
+  r.setHost("192.168.1.20");
+  IPAddress ip;
+  CHECK(r.lookup(ip));
+  CHECK(ip == IPAddress(kPrinter));
+  CHECK_EQ(fake_dns_queries(), 0);
+}
+
+TEST(first_lookup_is_pending_then_cached_for_the_ttl) {
+  setup();
+  fake_dns_set("printer.local", kPrinter);
+  HostResolver r;
+  r.setHost("printer.local");
+  IPAddress ip;
+  CHECK(!r.lookup(ip)); // In flight; the caller does not wait
+  CHECK(r.pending());
+  CHECK(!r.lookup(ip)); // Not asked twice
+  CHECK_EQ(fake_dns_queries(), 1);
+
+  advance_ms(40);
+  CHECK_EQ(fake_dns_deliver(), 1);
+  CHECK(r.lookup(ip));
+  CHECK(ip == IPAddress(kPrinter));
+  CHECK_EQ(r.lastQueryMs(), 40);
+
+  for (int i = 0; i < 100; i++) {
+    advance_ms(RESOLVE_TTL_MS / 100 - 1);
+    CHECK(r.lookup(ip)); // Every request path hits the cache
+  }
+  CHECK_EQ(fake_dns_queries(), 1);
+}
+
+TEST(refresh_serves_the_old_answer_meanwhile) {
+  setup();
+  fake_dns_set("printer.local", kPrinter, FAKE_DNS_CACHED);
+  HostResolver r;
+  r.setHost("printer.local");
+  IPAddress ip;
+  CHECK(r.lookup(ip)); // Answered from lwIP's cache straight away
+
+  fake_dns_set("printer.local", kMoved);
+  advance_ms(RESOLVE_TTL_MS);
+  CHECK(r.lookup(ip)); // Refresh started, stale answer still usable
+  CHECK(ip == IPAddress(kPrinter));
+  CHECK_EQ(fake_dns_queries(), 2);
+  fake_dns_deliver();
+  CHECK(r.lookup(ip));
+  CHECK(ip == IPAddress(kMoved));
+}
+
+TEST(failures_back_off_exponentially) {
+  setup();
+  HostResolver r;
+  r.setHost("nosuchprinter.local"); // Unknown: fails asynchronously
+  IPAddress ip;
+  uint32_t elapsed = 0;
+  while (elapsed < 300000) {
+    CHECK(!r.lookup(ip));
+    fake_dns_deliver();
+    advance_ms(100);
+    elapsed += 100;
+  }
+  // 2, 4, 8, 16, 32 then every 60 s: 9 queries in five minutes, not 3000
+  CHECK_EQ(fake_dns_queries(), 9);
+  CHECK_EQ(r.failures(), 9);
+}
+
+TEST(failure_keeps_the_previous_answer) {
+  setup();
+  fake_dns_set("printer.local", kPrinter, FAKE_DNS_CACHED);
+  HostResolver r;
+  r.setHost("printer.local");
+  IPAddress ip;
+  CHECK(r.lookup(ip));
+
+  fake_dns_set("printer.local", 0); // DNS server lost the name
+  r.invalidate();
+  CHECK(r.lookup(ip));
+  fake_dns_deliver();
+  CHECK(r.lookup(ip)); // A flaky server does not take the printer offline
+  CHECK(ip == IPAddress(kPrinter));
+  CHECK_EQ(r.failures(), 1);
+}
+
+TEST(unanswered_query_times_out_and_late_answers_are_ignored) {
+  setup();
+  fake_dns_set("printer.local", kPrinter, FAKE_DNS_SILENT);
+  HostResolver r;
+  r.setHost("printer.local");
+  IPAddress ip;
+  CHECK(!r.lookup(ip));
+  advance_ms(RESOLVE_TIMEOUT_MS);
+  CHECK(!r.lookup(ip));
+  CHECK(!r.pending());
+  CHECK_EQ(r.failures(), 1);
+
+  fake_dns_set("printer.local", kMoved, FAKE_DNS_ASYNC);
+  fake_dns_deliver(); // The timed-out query finally answers
+  CHECK(!r.lookup(ip));
+}
+
+TEST(only_a_new_host_drops_the_cache) {
+  setup();
+  fake_dns_set("printer.local", kPrinter, FAKE_DNS_CACHED);
+  fake_dns_set("other.local", kMoved, FAKE_DNS_ASYNC);
+  HostResolver r;
+  r.setHost("printer.local");
+  IPAddress ip;
+  CHECK(r.lookup(ip));
+
+  r.setHost("printer.local"); // An unrelated settings save
+  CHECK(r.lookup(ip));
+  CHECK_EQ(fake_dns_queries(), 1);
+
+  r.setHost("other.local");
+  CHECK(!r.lookup(ip)); // The old printer's address is not reused
+  fake_dns_deliver();
+  CHECK(r.lookup(ip));
+  CHECK(ip == IPAddress(kMoved));
+}
+
+TEST(answer_for_a_replaced_name_is_dropped) {
+  setup();
+  fake_dns_set("old.local", kPrinter);
+  fake_dns_set("new.local", kMoved, FAKE_DNS_SILENT);
+  HostResolver r;
+  r.setHost("old.local");
+  IPAddress ip;
+  CHECK(!r.lookup(ip));
+  r.setHost("new.local");
+  CHECK(!r.lookup(ip));
+  fake_dns_deliver(); // old.local answers after the switch
+  CHECK(!r.lookup(ip));
+}
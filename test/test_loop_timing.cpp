@@ -0,0 +1,143 @@
+// loop() sleep policy, and a virtual-clock simulation of the UI loop
+// against the original fixed delay(5) + lv_tick_inc(5) loop.
+//
+// The simulated loop has LVGL's two default timers (display refresh and
+// touch read, 30 ms each), a 1 ms pass of its own work, a 4 ms render
+// plus a 6 ms DMA flush after each touch, and a 400 ms pass every 10 s (a
+// screen being rebuilt). Touches land off any grid, every 1237 ms.
+#include "host_test.h"
+#include "loop_timing.h"
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+#define LV_NO_TIMER_READY 0xFFFFFFFF // lv_timer.h
+
+#define SIM_US 120000000ull // Two minutes
+#define PASS_US 1000
+#define LONG_PASS_US 400000
+#define LONG_PASS_EVERY_US 10000000
+#define RENDER_US 4000
+#define FLUSH_US 6000
+#define TOUCH_EVERY_US 1237000
+
+namespace {
+struct LvTimer {
+  uint32_t period;
+  uint32_t last;
+  bool ready;
+};
+
+struct Result {
+  uint32_t passes;
+  std::vector<uint32_t> touchUs; // Touch to LVGL reading it
+  uint32_t maxFlushUs;  // DMA done to loop() noticing
+  int64_t clockErrorMs; // LVGL's clock minus real time at the end
+};
+
+Result simulate(bool adaptive) {
+  Result r = {};
+  uint64_t now = 0;
+  uint32_t ticks = 0; // lv_tick_inc() total, for the fixed loop
+  LvTimer refr = {30, 0, false}, read = {30, 0, false};
+  uint64_t touchAt = 100000; // Next touch; read once now passes it
+  uint64_t nextLong = LONG_PASS_EVERY_US;
+  uint64_t flushDone = 0;
+  bool flushing = false, dirty = false;
+
+  while (now < SIM_US) {
+    r.passes++;
+    if (flushing && now >= flushDone) { // flush_poll()
+      flushing = false;
+      if (now - flushDone > r.maxFlushUs)
+        r.maxFlushUs = (uint32_t)(now - flushDone);
+    }
+    bool touched = now >= touchAt;
+    if (adaptive && touched)
+      read.ready = true; // touch_input_pending()
+
+    now += PASS_US; // DataManager.loop(), ui_update_status()
+    if (now >= nextLong) {
+      now += LONG_PASS_US;
+      nextLong += LONG_PASS_EVERY_US;
+    }
+
+    // lv_timer_handler()
+    uint32_t lvMs = adaptive ? (uint32_t)(now / 1000) : ticks;
+    uint32_t idle = LV_NO_TIMER_READY;
+    LvTimer *timers[] = {&read, &refr};
+    for (LvTimer *t : timers) {
+      if (t->ready || lvMs - t->last >= t->period) {
+        t->ready = false;
+        t->last = lvMs;
+        if (t == &read && now >= touchAt) {
+          uint32_t us = (uint32_t)(now - touchAt);
+          r.touchUs.push_back(us);
+          touchAt += TOUCH_EVERY_US;
+          dirty = true;
+        } else if (t == &refr && dirty && !flushing) {
+          now += RENDER_US;
+          flushDone = now + FLUSH_US;
+          flushing = true;
+          dirty = false;
+        }
+      }
+      uint32_t left = t->period - (lvMs - t->last);
+      if (left < idle)
+        idle = left;
+    }
+
+    if (!adaptive) {
+      ticks += 5;
+      now += 5000;
+      continue;
+    }
+    uint64_t wake = now + 1000ull * loop_sleep_ms(idle, flushing);
+    if (touchAt > now && touchAt < wake)
+      wake = touchAt; // The touch task's notification
+    now = wake;
+  }
+  r.clockErrorMs = adaptive ? 0 : (int64_t)ticks - (int64_t)(now / 1000);
+  std::sort(r.touchUs.begin(), r.touchUs.end());
+  return r;
+}
+
+uint32_t median(const Result &r) { return r.touchUs[r.touchUs.size() / 2]; }
+
+void report(const char *name, const Result &r) {
+  printf("%-8s passes/s %5.1f | touch latency median %6.2f ms max %6.2f ms "
+         "| flush seen within %4.1f ms | LVGL clock off by %lld ms\n",
+         name, r.passes / (SIM_US / 1e6), median(r) / 1000.0,
+         r.touchUs.back() / 1000.0, r.maxFlushUs / 1000.0,
+         (long long)r.clockErrorMs);
+}
+} // namespace
+
+TEST(sleep_policy) {
+  CHECK_EQ(loop_sleep_ms(7, false), 7); // Until the next LVGL timer
+  CHECK_EQ(loop_sleep_ms(LV_NO_TIMER_READY, false), LOOP_MAX_SLEEP_MS);
+  CHECK_EQ(loop_sleep_ms(LOOP_MAX_SLEEP_MS + 1, false), LOOP_MAX_SLEEP_MS);
+  CHECK_EQ(loop_sleep_ms(0, false), 1); // Never a zero wait
+  CHECK_EQ(loop_sleep_ms(30, true), 1); // Poll a flush on the bus
+}
+
+TEST(adaptive_loop_against_fixed_delay) {
+  Result fixed = simulate(false), adaptive = simulate(true);
+  report("fixed", fixed);
+  report("adaptive", adaptive);
+  CHECK(adaptive.touchUs.size() >= SIM_US / TOUCH_EVERY_US - 1);
+  CHECK(fixed.touchUs.size() >= SIM_US / TOUCH_EVERY_US - 1);
+
+  // A touch is read in the pass it wakes, not at the next read period.
+  // Either loop makes a touch during a long pass wait for its end.
+  CHECK(median(adaptive) <= PASS_US);
+  CHECK(median(adaptive) * 10 < median(fixed));
+  CHECK(adaptive.touchUs.back() <= fixed.touchUs.back());
+  // A flush is noticed within a tick and a pass
+  CHECK(adaptive.maxFlushUs <= 1000 + PASS_US);
+  // The fixed loop loses real time every pass and 395 ms every long pass
+  CHECK(fixed.clockErrorMs < -(int64_t)(SIM_US / LONG_PASS_EVERY_US) * 395);
+  // ...and wakes more than twice as often: every 6 ms against LVGL's two
+  // 30 ms timers and the touches
+  CHECK(adaptive.passes * 2 < fixed.passes);
+}
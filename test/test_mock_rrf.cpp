@@ -0,0 +1,204 @@
+// PrinterLink against the mock printer in tools/mock_rrf over real
+// sockets: the endpoints the firmware uses, setpoint read-back, the
+// offline scenario and injected latency, and keep-alive against a
+// connection per request. Registered when Python 3 is found.
+#include "host_test.h"
+#include "fake_http.h"
+#include "network/filament_catalog.h"
+#include "network/printer_link.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace {
+// The server on a free port for the life of the object
+class MockServer {
+public:
+  explicit MockServer(const char *scenario, const char *args = "") {
+    std::string cmd = std::string(MOCK_RRF_SERVER " --quiet --port 0 ") +
+                      args + " " MOCK_RRF_SCENARIOS "/" + scenario;
+    _out = popen(cmd.c_str(), "r");
+    char line[128];
+    unsigned port;
+    if (_out && fgets(line, sizeof(line), _out) &&
+        sscanf(line, "mock_rrf: listening on %*[^:]:%u", &port) == 1)
+      _port = port;
+    if (_port)
+      fake_http_forward("127.0.0.1", _port);
+  }
+  ~MockServer() {
+    if (_port)
+      get("/mock/shutdown");
+    _link.close();
+    if (_out) {
+      // Read the summary the server prints on exit, so it can finish
+      char line[256];
+      while (fgets(line, sizeof(line), _out))
+        ;
+      pclose(_out);
+    }
+    fake_http_set_handler(nullptr);
+  }
+
+  bool running() const { return _port != 0; }
+  PrinterLink &link() { return _link; }
+
+  // Body of a successful GET, "" otherwise
+  std::string get(const char *uri, int *code = nullptr) {
+    _link.setHost("printer.local");
+    int c = _link.get(uri, 2000);
+    if (code)
+      *code = c;
+    std::string body = c == 200 ? _link.body().c_str() : "";
+    _link.end();
+    return body;
+  }
+
+private:
+  FILE *_out = nullptr;
+  uint16_t _port = 0;
+  PrinterLink _link;
+};
+
+bool has(const std::string &s, const char *part) {
+  return s.find(part) != std::string::npos;
+}
+} // namespace
+
+TEST(serves_model_keys_and_the_live_poll) {
+  MockServer m("idle.json");
+  CHECK(m.running());
+  CHECK(has(m.get("/rr_model?key=state"), "\"status\":\"idle\""));
+  CHECK(has(m.get("/rr_model?key=global.AFC_lanes"), "Generic PLA"));
+  std::string live = m.get("/rr_model?flags=d99fn");
+  CHECK(has(live, "\"seqs\":{"));
+  CHECK(has(live, "\"heaters\":[{"));
+  CHECK(!has(live, "\"network\":{")); // Not live: only through its seq
+}
+
+TEST(setpoints_and_globals_read_back) {
+  MockServer m("idle.json");
+  CHECK(has(m.get("/rr_gcode?gcode=M140%20S60%0AG10%20P0%20S215"),
+            "\"buff\""));
+  std::string heat = m.get("/rr_model?key=heat");
+  CHECK(has(heat, "\"active\":60,"));
+  CHECK(has(heat, "\"active\":215,"));
+
+  std::string before = m.get("/rr_model?flags=d99fn");
+  m.get("/rr_gcode?gcode=set%20global.AFC_lanes%5B1%5D%5B0%5D%5B4%5D%5B0%5D"
+        "%20%3D%20%22eSUN%20PLA%2B%22");
+  CHECK(has(m.get("/rr_model?key=global.AFC_lanes"), "eSUN PLA+"));
+  CHECK(before != m.get("/rr_model?flags=d99fn")); // seqs.global moved
+
+  m.get("/rr_gcode?gcode=echo%20%22hello%22");
+  CHECK(m.get("/rr_reply") == "hello");
+  CHECK(m.get("/rr_reply").empty()); // Taken once
+}
+
+TEST(filament_list_streams_into_the_catalog) {
+  MockServer m("idle.json");
+  std::string list =
+      m.get("/rr_download?name=0:/sys/filamentList.json");
+  FilamentCatalog cat;
+  cat.beginParse();
+  cat.feed(list.data(), list.size());
+  CHECK(cat.endParse());
+  CHECK_EQ(cat.count(), 12);
+  int code;
+  m.get("/rr_download?name=0:/sys/config.g", &code);
+  CHECK_EQ(code, 404);
+}
+
+TEST(offline_scenario_drops_then_recovers) {
+  // Ten times real speed: online for 1 s, offline for 1.5 s, then back
+  MockServer m("offline.json", "--speed 10");
+  int changes = 0;
+  bool wasUp = true;
+  for (uint32_t start = millis(); millis() - start < 3500; delay(50)) {
+    int code;
+    m.get("/rr_model?key=state", &code);
+    bool up = code == 200;
+    CHECK(up || code <= 0); // A transport error, as on the device
+    changes += up != wasUp;
+    wasUp = up;
+  }
+  CHECK_EQ(changes, 2); // Down once, back once
+  CHECK(wasUp);
+}
+
+TEST(injected_latency_and_stats) {
+  MockServer m("idle.json", "--latency 80");
+  uint32_t start = millis();
+  CHECK(has(m.get("/rr_model?key=network"), "\"name\""));
+  CHECK(millis() - start >= 80);
+  std::string stats = m.get("/mock/stats");
+  CHECK(has(stats, "\"rr_model network\": {\"requests\": 1"));
+}
+
+TEST(chunked_and_slow_bodies) {
+  MockServer m("idle.json", "--chunked --slow-body 20000");
+  std::string heat = m.get("/rr_model?key=heat"); // About 3 KB in 150 ms
+  CHECK(has(heat, "\"key\":\"heat\""));
+  CHECK(heat[heat.size() - 1] == '}');
+}
+
+// The polling mix of one seqs-mode interval and a tap, sent back to back
+static const char *const kMix[] = {
+    "/rr_model?flags=d99fn",
+    "/rr_model?key=state",
+    "/rr_model?flags=d99fn",
+    "/rr_model?key=global.AFC_lanes",
+    "/rr_gcode?gcode=M140%20S60",
+    "/rr_reply",
+};
+#define MIX_ROUNDS 100
+
+struct LinkRun {
+  uint32_t requests, failed, connects;
+  double perSec;
+  uint32_t p50Us, p99Us;
+};
+
+static LinkRun run_mix(const char *args) {
+  MockServer m("idle.json", args);
+  PrinterLink &link = m.link();
+  link.setHost("printer.local");
+  std::vector<uint32_t> us;
+  LinkRun r = {0, 0, 0, 0, 0, 0};
+  uint32_t start = micros();
+  for (int round = 0; round < MIX_ROUNDS; round++) {
+    for (const char *uri : kMix) {
+      uint32_t t = micros();
+      int code = link.get(uri, 2000, strncmp(uri, "/rr_gcode", 9) != 0);
+      if (code == 200)
+        link.body();
+      link.end();
+      us.push_back(micros() - t);
+      r.failed += code != 200;
+    }
+  }
+  uint32_t total = micros() - start;
+  r.requests = us.size();
+  r.connects = link.connects();
+  r.perSec = r.requests * 1e6 / total;
+  std::sort(us.begin(), us.end());
+  r.p50Us = us[us.size() * 50 / 100];
+  r.p99Us = us[us.size() * 99 / 100];
+  printf("  %-24s %6u req %4u connects %8.0f req/s  p50 %6u us  p99 %6u us\n",
+         *args ? "connection per request" : "keep-alive", (unsigned)r.requests,
+         (unsigned)r.connects, r.perSec, (unsigned)r.p50Us, (unsigned)r.p99Us);
+  return r;
+}
+
+TEST(keep_alive_against_a_connection_per_request) {
+  // The same mix, with the server closing after every response (the
+  // firmware before PrinterLink) and keeping the socket open
+  LinkRun close = run_mix("--no-keepalive");
+  LinkRun keep = run_mix("");
+  CHECK_EQ(close.failed, 0);
+  CHECK_EQ(keep.failed, 0);
+  CHECK_EQ(close.connects, close.requests);
+  CHECK_EQ(keep.connects, 1);
+  CHECK(keep.requests == close.requests);
+}
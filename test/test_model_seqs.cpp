@@ -0,0 +1,191 @@
+// Request counts for the two polling modes, on a simulated printer.
+//
+// The loop below is NetworkManager::serviceWiFi() and pollBySeqs() with
+// the HTTP requests counted instead of sent: PollScheduler picks the key
+// and, in seqs mode, ModelSeqs decides which branches a flags=d99fn
+// response makes stale. The printer moves its seqs counters the way RRF
+// does in three scenarios: idle, printing, and AFC lane changes.
+#include "host_test.h"
+#include "network/model_seqs.h"
+#include "network/poll_scheduler.h"
+#include <stdio.h>
+
+#define SIM_MS 600000 // Ten minutes per scenario
+#define SIM_STEP_MS 10
+#define POLL_INTERVAL_MS 1500 // Settings default
+#define POLL_IDLE_MS 120000   // network_manager.cpp
+
+namespace {
+struct Printer {
+  uint32_t seqs[SB_COUNT] = {};
+  PollActivity activity = PA_NORMAL;
+  uint32_t lanesChangedAt = 0;
+  bool lanesUnseen = false;
+
+  void change(SeqBranch b, uint32_t now) {
+    seqs[b]++;
+    if (b == SB_GLOBAL) {
+      lanesChangedAt = now;
+      lanesUnseen = true;
+    }
+  }
+};
+
+typedef void (*Scenario)(Printer &p, uint32_t now);
+
+// Nothing happens; polling relaxes once no one has touched the panel
+void idle(Printer &p, uint32_t now) {
+  p.activity = now < POLL_IDLE_MS ? PA_NORMAL : PA_IDLE;
+}
+
+// A job: live values move all the time but only appear in d99fn; the job
+// branch moves on each layer
+void printing(Printer &p, uint32_t now) {
+  p.activity = PA_PRINTING;
+  if (now % 30000 == 0)
+    p.change(SB_JOB, now);
+}
+
+// Three lane swaps: the AFC macro runs as "busy" for 20 s and writes its
+// global variables on unload, load and the LED update
+void lane_changes(Printer &p, uint32_t now) {
+  uint32_t t = now % 180000;
+  p.activity = t >= 60000 && t < 80000 ? PA_BOOST : PA_NORMAL;
+  if (t == 60000 || t == 80000)
+    p.change(SB_STATE, now);
+  if (t == 62130 || t == 70270 || t == 78410)
+    p.change(SB_GLOBAL, now);
+}
+
+struct Result {
+  uint32_t requests;
+  uint32_t lanesFetches;
+  uint32_t laneLatencyMs; // Worst lane change to fetched, in ms
+};
+
+void fetched(Printer &p, PollKey key, uint32_t now, Result &r) {
+  if (key != PK_AFC_LANES)
+    return;
+  r.lanesFetches++;
+  if (p.lanesUnseen) {
+    uint32_t ms = now - p.lanesChangedAt;
+    if (ms > r.laneLatencyMs)
+      r.laneLatencyMs = ms;
+    p.lanesUnseen = false;
+  }
+}
+
+Result simulate(bool bySeqs, Scenario scenario) {
+  Printer p;
+  PollScheduler sched;
+  ModelSeqs seqs;
+  Result r = {};
+  sched.setBaseInterval(POLL_INTERVAL_MS);
+  sched.setEnabled(bySeqs ? PK_MASK(PK_LIVE)
+                          : (PK_MASK(PK_COUNT) - 1) & ~PK_MASK(PK_LIVE));
+  sched.setProbe(bySeqs ? PK_LIVE : PK_STATE);
+
+  for (uint32_t now = 0; now < SIM_MS; now += SIM_STEP_MS) {
+    scenario(p, now);
+    sched.setActivity(p.activity);
+    int key = sched.next(now);
+    if (key < 0)
+      continue;
+    r.requests++;
+    if (key == PK_LIVE) {
+      for (int b = 0; b < SB_COUNT; b++) {
+        SeqBranch branch = (SeqBranch)b;
+        if (!seqs.stale(branch, p.seqs[b]))
+          continue;
+        for (int k = 0; k < PK_COUNT; k++) {
+          if (ModelSeqs::keys(branch) & PK_MASK(k)) {
+            r.requests++;
+            fetched(p, (PollKey)k, now, r);
+          }
+        }
+        seqs.refreshed(branch, p.seqs[b]);
+      }
+    } else {
+      fetched(p, (PollKey)key, now, r);
+    }
+    sched.markFetched((PollKey)key, now);
+  }
+  return r;
+}
+
+void report(const char *name, const Result &perKey, const Result &bySeqs) {
+  printf("%-13s requests per-key %5u seqs %5u | lane change seen within "
+         "per-key %5u ms seqs %5u ms\n",
+         name, (unsigned)perKey.requests, (unsigned)bySeqs.requests,
+         (unsigned)perKey.laneLatencyMs, (unsigned)bySeqs.laneLatencyMs);
+}
+} // namespace
+
+TEST(branches_map_to_their_keys) {
+  CHECK(ModelSeqs::keys(SB_STATE) == PK_MASK(PK_STATE));
+  CHECK(ModelSeqs::keys(SB_NETWORK) == PK_MASK(PK_NETWORK));
+  uint32_t all = 0;
+  for (int b = 0; b < SB_COUNT; b++) {
+    CHECK((all & ModelSeqs::keys((SeqBranch)b)) == 0); // No key twice
+    all |= ModelSeqs::keys((SeqBranch)b);
+  }
+  // Every key but the d99fn request and heat (live, in d99fn) is covered
+  CHECK(all == ((PK_MASK(PK_COUNT) - 1) & ~PK_MASK(PK_LIVE) &
+                ~PK_MASK(PK_HEAT)));
+  CHECK(ModelSeqs::name(SB_GLOBAL)[0] == 'g');
+}
+
+TEST(stale_until_refreshed_and_after_invalidate) {
+  ModelSeqs s;
+  CHECK(s.stale(SB_JOB, 0)); // Nothing refreshed yet, even at counter 0
+  for (int b = 0; b < SB_COUNT; b++)
+    s.refreshed((SeqBranch)b, 7);
+  CHECK(!s.stale(SB_JOB, 7));
+  CHECK(s.stale(SB_JOB, 8));
+  s.invalidate(); // Printer was offline
+  CHECK(s.stale(SB_JOB, 7));
+}
+
+TEST(a_failed_refetch_leaves_only_its_branches_stale) {
+  // First sync: state and job come back, then tools fails and the pass
+  // stops. The next pass refetches tools onwards, not state and job.
+  ModelSeqs s;
+  s.refreshed(SB_STATE, 3);
+  s.refreshed(SB_JOB, 5);
+  CHECK(!s.stale(SB_STATE, 3));
+  CHECK(!s.stale(SB_JOB, 5));
+  for (int b = SB_TOOLS; b < SB_COUNT; b++)
+    CHECK(s.stale((SeqBranch)b, 0));
+  s.invalidate();
+  CHECK(s.stale(SB_STATE, 3));
+}
+
+TEST(idle_printer) {
+  Result perKey = simulate(false, idle), bySeqs = simulate(true, idle);
+  report("idle", perKey, bySeqs);
+  // One d99fn per interval, plus the first refetch of every branch
+  uint32_t live = POLL_IDLE_MS / POLL_INTERVAL_MS +
+                  (SIM_MS - POLL_IDLE_MS) / (4 * POLL_INTERVAL_MS);
+  CHECK(bySeqs.requests <= live + 10);
+  CHECK_EQ(bySeqs.lanesFetches, 1);
+  CHECK(bySeqs.requests * 2 < perKey.requests);
+}
+
+TEST(printing) {
+  Result perKey = simulate(false, printing), bySeqs = simulate(true, printing);
+  report("printing", perKey, bySeqs);
+  CHECK_EQ(bySeqs.lanesFetches, 1); // AFC untouched by the job
+  CHECK(bySeqs.requests < perKey.requests);
+}
+
+TEST(lane_changes) {
+  Result perKey = simulate(false, lane_changes),
+         bySeqs = simulate(true, lane_changes);
+  report("lane changes", perKey, bySeqs);
+  // Seen by the next d99fn: within one (boosted) interval
+  CHECK(bySeqs.laneLatencyMs <= 500 + 100);
+  CHECK(bySeqs.laneLatencyMs < perKey.laneLatencyMs);
+  CHECK(bySeqs.requests < perKey.requests);
+  // Three swaps, three global writes each, plus the first refetch
+  CHECK(bySeqs.lanesFetches <= 1 + 3 * 3);
+}
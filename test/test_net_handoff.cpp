@@ -0,0 +1,192 @@
+// The UI/network hand-off: SnapshotBuffer for the model, CommandQueue for
+// G-code and setpoint read-back, PrinterLink on a scripted transport.
+//
+// A stand-in network task makes the same calls NetworkManager::taskLoop()
+// makes (flush commands, poll, publish) against a printer that is slow or
+// unreachable. The UI side makes the calls loop() and the dashboard make:
+// pick up the latest snapshot, read targets, queue taps. However long the
+// transport blocks, no UI pass may wait for it.
+#include "host_test.h"
+#include "network/command_queue.h"
+#include "network/printer_link.h"
+#include "network/printer_model.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#define SLOW_MS 200      // Printer answering slowly
+#define TIMEOUT_MS 500   // Printer gone: each request runs to its timeout
+#define UI_BUDGET_MS 20  // A UI pass costing this much would be a stall
+
+namespace {
+struct Shared {
+  SnapshotBuffer<PrinterModel> snapshot;
+  CommandQueue commands;
+  std::atomic<bool> stop{false};
+  std::atomic<bool> offline{false};
+  std::atomic<uint32_t> polls{0};
+  std::atomic<uint32_t> sent{0};
+};
+
+void net_task(Shared &s) {
+  PrinterLink poll, cmd;
+  poll.setHost("192.168.1.20");
+  cmd.setHost("192.168.1.20");
+  PrinterModel work;
+  work.heaterCount = 1;
+  while (!s.stop) {
+    GCodeCommand batch[8];
+    size_t n = s.commands.takeBatch(batch, 8, 384);
+    if (n) {
+      for (size_t i = 0; i < n; i++) {
+        if (batch[i].setpoint == CMD_SETPOINT_BED)
+          work.heaters[0].active = batch[i].value;
+      }
+      s.snapshot.publish(work);
+      bool ok = cmd.get("/rr_gcode?gcode=M140", TIMEOUT_MS, false) == 200;
+      cmd.end();
+      s.commands.complete(n, ok, s.snapshot.seq());
+      s.sent += n;
+    }
+
+    int code = poll.get("/rr_model?flags=d99fn", TIMEOUT_MS);
+    poll.end();
+    work.status = code == 200 ? PS_IDLE : PS_OFFLINE;
+    work.heaters[0].current += 0.1f;
+    s.snapshot.publish(work);
+    s.polls++;
+  }
+}
+
+void install_printer(Shared &s) {
+  fake_http_set_handler(
+      [&s](const FakeHttpRequest &, FakeHttpResponse &res) {
+        if (s.offline) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(TIMEOUT_MS));
+          res.code = HTTPC_ERROR_CONNECTION_REFUSED;
+        } else {
+          std::this_thread::sleep_for(std::chrono::milliseconds(SLOW_MS));
+          res.body = "{}";
+        }
+      });
+}
+
+// UI passes for `ms` of wall time; returns the slowest pass in us
+uint32_t run_ui(Shared &s, uint32_t ms, uint32_t &passes, uint32_t &seqs) {
+  PrinterModel view;
+  uint32_t viewSeq = 0, worst = 0;
+  auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+  passes = seqs = 0;
+  while (std::chrono::steady_clock::now() < end) {
+    auto t0 = std::chrono::steady_clock::now();
+    if (s.snapshot.seq() != viewSeq) {
+      viewSeq = s.snapshot.read(view);
+      seqs++;
+    }
+    float target;
+    if (!s.commands.setpoint(CMD_SETPOINT_BED, viewSeq, target))
+      target = view.heaters[0].active;
+    if (passes % 64 == 0)
+      s.commands.pushSetpoint(CMD_SETPOINT_BED, target + 5, "M140 S65");
+    uint32_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - t0)
+                      .count();
+    if (us > worst)
+      worst = us;
+    passes++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return worst;
+}
+} // namespace
+
+TEST(ui_never_waits_on_a_slow_printer) {
+  host_clock_real();
+  Shared s;
+  install_printer(s);
+  std::thread net(net_task, std::ref(s));
+  uint32_t passes, seqs;
+  uint32_t worstUs = run_ui(s, 1000, passes, seqs);
+  s.stop = true;
+  net.join();
+  fake_http_set_handler(nullptr);
+
+  CHECK(worstUs < UI_BUDGET_MS * 1000);
+  CHECK(passes > 200);   // ~1 ms per pass, not SLOW_MS
+  CHECK(s.polls >= 2);   // The network side was really blocked meanwhile
+  CHECK(s.sent > 0);
+  CHECK(seqs >= 2);      // and what it published reached the UI
+}
+
+TEST(ui_never_waits_on_an_offline_printer) {
+  host_clock_real();
+  Shared s;
+  s.offline = true;
+  install_printer(s);
+  std::thread net(net_task, std::ref(s));
+  uint32_t passes, seqs;
+  uint32_t worstUs = run_ui(s, 1200, passes, seqs);
+  s.stop = true;
+  net.join();
+  fake_http_set_handler(nullptr);
+
+  PrinterModel view;
+  s.snapshot.read(view);
+  CHECK(view.isOffline());
+  CHECK(worstUs < UI_BUDGET_MS * 1000);
+  CHECK(passes > 200);
+}
+
+// Virtual clock: the target the UI shows follows the taps until a
+// published snapshot carries them, and the model after that
+TEST(targets_read_back_until_a_snapshot_carries_them) {
+  host_clock_set(0);
+  SnapshotBuffer<PrinterModel> snapshot;
+  CommandQueue commands;
+  PrinterModel work, view;
+  work.heaterCount = 1;
+  work.heaters[0].active = 60;
+  snapshot.publish(work);
+  uint32_t viewSeq = snapshot.read(view);
+
+  float v = 0;
+  CHECK(!commands.setpoint(CMD_SETPOINT_BED, viewSeq, v)); // Model current
+
+  // Two taps before the network task runs: the second builds on the first
+  commands.pushSetpoint(CMD_SETPOINT_BED, 65, "M140 S65");
+  CHECK(commands.setpoint(CMD_SETPOINT_BED, viewSeq, v));
+  CHECK_EQ(v, 65);
+  commands.pushSetpoint(CMD_SETPOINT_BED, v + 5, "M140 S70");
+  CHECK(commands.setpoint(CMD_SETPOINT_BED, viewSeq, v));
+  CHECK_EQ(v, 70);
+  CHECK_EQ(commands.pending(), 1); // Coalesced
+
+  // Network task: apply, publish, send (200 ms on the virtual clock)
+  GCodeCommand batch[4];
+  size_t n = commands.takeBatch(batch, 4, 384);
+  CHECK_EQ(n, 1);
+  work.heaters[0].active = batch[0].value;
+  snapshot.publish(work);
+  CHECK(commands.setpoint(CMD_SETPOINT_BED, viewSeq, v)); // In flight
+  CHECK_EQ(v, 70);
+  delay(200);
+  commands.complete(n, true, snapshot.seq());
+  CHECK_EQ(host_clock_us(), 200000);
+
+  // Sent, but the UI has not picked up that snapshot yet
+  CHECK(commands.setpoint(CMD_SETPOINT_BED, viewSeq, v));
+  CHECK_EQ(v, 70);
+
+  // Once it has, the model is the truth again
+  viewSeq = snapshot.read(view);
+  CHECK(!commands.setpoint(CMD_SETPOINT_BED, viewSeq, v));
+  CHECK_EQ(view.heaters[0].active, 70);
+
+  // A later poll overriding the value (someone else changed it) wins
+  work.heaters[0].active = 50;
+  snapshot.publish(work);
+  viewSeq = snapshot.read(view);
+  CHECK(!commands.setpoint(CMD_SETPOINT_BED, viewSeq, v));
+  CHECK_EQ(view.heaters[0].active, 50);
+  host_clock_real();
+}
@@ -0,0 +1,150 @@
+// PollScheduler: per-key staleness against the target periods, on a
+// simulated link where every request keeps the network task busy
+#include "host_test.h"
+#include "network/poll_scheduler.h"
+#include <stdio.h>
+
+#define ALL_KEYS ((PK_MASK(PK_COUNT) - 1) & ~PK_MASK(PK_LIVE))
+
+namespace {
+// Run for `ms`, each request keeping the task busy for `requestMs`
+void simulate(PollScheduler &s, PollActivity a, uint32_t ms,
+              uint32_t requestMs, uint32_t start = 0) {
+  s.setActivity(a);
+  for (uint32_t now = start; now < start + ms;) {
+    int k = s.next(now);
+    if (k < 0) {
+      now += 10; // The task's idle wait
+      continue;
+    }
+    now += requestMs;
+    s.markFetched((PollKey)k, now);
+  }
+}
+
+// Worst lateness any key saw beyond its period
+uint32_t worst_late(const PollScheduler &s, uint32_t mask) {
+  uint32_t worst = 0;
+  for (int k = 0; k < PK_COUNT; k++) {
+    if ((mask & PK_MASK(k)) && s.maxLate((PollKey)k) > worst)
+      worst = s.maxLate((PollKey)k);
+  }
+  return worst;
+}
+} // namespace
+
+TEST(every_key_meets_its_period_at_each_activity) {
+  static const PollActivity levels[] = {PA_IDLE, PA_NORMAL, PA_PRINTING,
+                                        PA_BOOST};
+  for (PollActivity a : levels) {
+    PollScheduler s;
+    s.setEnabled(ALL_KEYS);
+    s.setBaseInterval(1500);
+    simulate(s, a, 600000, 80);
+    printf("%-8s worst late %4u ms, state fetched %4u, network %3u\n",
+           PollScheduler::activityName(a), (unsigned)worst_late(s, ALL_KEYS),
+           (unsigned)s.fetches(PK_STATE), (unsigned)s.fetches(PK_NETWORK));
+    // The top-priority keys wait for at most the request in flight and
+    // the rate gap; every key stays within 1.5x its target period, and is
+    // never fetched more often than the period asks
+    CHECK(s.maxLate(PK_STATE) <= 2 * 100);
+    CHECK(s.maxLate(PK_HEAT) <= 2 * 100);
+    for (int k = 1; k < PK_COUNT; k++) {
+      uint32_t p = s.period((PollKey)k);
+      CHECK(s.maxLate((PollKey)k) < p / 2);
+      CHECK(s.fetches((PollKey)k) <= 600000 / p + 1);
+      CHECK(s.fetches((PollKey)k) >= 600000 / (p + p / 2));
+    }
+  }
+}
+
+TEST(printing_tightens_live_keys_and_leaves_network_alone) {
+  PollScheduler s;
+  s.setBaseInterval(1500);
+  s.setActivity(PA_IDLE);
+  uint32_t idleState = s.period(PK_STATE);
+  s.setActivity(PA_PRINTING);
+  CHECK(s.period(PK_STATE) < idleState);
+  CHECK_EQ(s.period(PK_STATE), 500);
+  CHECK_EQ(s.period(PK_NETWORK), 60000);
+  s.setActivity(PA_BOOST);
+  CHECK(s.period(PK_AFC_LANES) < 2000); // AFC moves after a command
+  s.setActivity(PA_OFFLINE);
+  CHECK_EQ(s.period(PK_STATE), 5000);
+}
+
+TEST(saturated_link_sheds_low_priority_keys_first) {
+  PollScheduler s;
+  s.setEnabled(ALL_KEYS);
+  s.setBaseInterval(100); // Faster than the link can serve every key
+  simulate(s, PA_NORMAL, 120000, 250);
+  CHECK(s.maxLate(PK_STATE) <= 2 * 250);
+  CHECK(s.maxLate(PK_HEAT) <= 2 * 250);
+  // network (priority 0) gets at most the odd slot
+  CHECK(s.fetches(PK_NETWORK) <= 1);
+  CHECK(s.age(PK_NETWORK, 120000) > s.period(PK_NETWORK));
+}
+
+TEST(request_rate_is_capped) {
+  PollScheduler s;
+  s.setEnabled(ALL_KEYS);
+  s.setBaseInterval(1);
+  uint32_t issued = 0;
+  s.setActivity(PA_NORMAL);
+  for (uint32_t now = 0; now < 10000; now++) {
+    int k = s.next(now);
+    if (k >= 0) {
+      issued++;
+      s.markFetched((PollKey)k, now);
+    }
+  }
+  CHECK(issued <= 10000 / 100 + 1);
+}
+
+TEST(failed_key_ages_and_retries_after_a_period) {
+  PollScheduler s;
+  s.setEnabled(PK_MASK(PK_STATE));
+  s.setBaseInterval(1500);
+  s.setActivity(PA_NORMAL);
+  CHECK_EQ(s.next(0), PK_STATE);
+  s.markFetched(PK_STATE, 0);
+
+  CHECK_EQ(s.next(1500), PK_STATE);
+  s.markFailed(PK_STATE, 1500);
+  CHECK_EQ(s.next(1600), -1); // Not hammered while it keeps failing
+  CHECK_EQ(s.next(2999), -1);
+  CHECK_EQ(s.age(PK_STATE, 2999), 2999); // Still the first fetch's age
+  CHECK_EQ(s.next(3000), PK_STATE);
+  s.markFetched(PK_STATE, 3000);
+  CHECK_EQ(s.maxLate(PK_STATE), 1500);
+  CHECK_EQ(s.age(PK_STATE, 3000), 0);
+}
+
+TEST(expedite_makes_everything_due) {
+  PollScheduler s;
+  s.setEnabled(PK_MASK(PK_STATE) | PK_MASK(PK_NETWORK));
+  s.setActivity(PA_NORMAL);
+  s.markFetched(PK_STATE, 0);
+  s.markFetched(PK_NETWORK, 0);
+  s.markFailed(PK_NETWORK, 100);
+  CHECK_EQ(s.next(200), -1);
+  s.expedite();
+  CHECK_EQ(s.next(200), PK_STATE); // Priority order
+  s.markFetched(PK_STATE, 250);
+  CHECK_EQ(s.next(300), PK_NETWORK);
+}
+
+TEST(offline_polls_only_the_probe) {
+  PollScheduler s;
+  s.setEnabled(ALL_KEYS);
+  s.setProbe(PK_STATE);
+  s.setActivity(PA_OFFLINE);
+  for (uint32_t now = 0; now < 60000; now += 10) {
+    int k = s.next(now);
+    if (k >= 0) {
+      CHECK_EQ(k, PK_STATE);
+      s.markFailed((PollKey)k, now);
+    }
+  }
+  CHECK_EQ(s.fetches(PK_NETWORK), 0);
+}
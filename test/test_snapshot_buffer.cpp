@@ -0,0 +1,88 @@
+// SnapshotBuffer from two threads: one publishing as fast as it can, one
+// reading. Each snapshot is filled from its own number and carries a
+// checksum, so a copy that mixes two snapshots fails the check however the
+// words were interleaved.
+#include "host_test.h"
+#include "network/printer_model.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#define SNAP_WORDS 1024 // 4 KB, about the size of PrinterModel
+
+namespace {
+struct Snapshot {
+  uint32_t n;
+  uint32_t words[SNAP_WORDS];
+  uint32_t sum;
+
+  void fill(uint32_t number) {
+    n = number;
+    sum = number;
+    for (int i = 0; i < SNAP_WORDS; i++) {
+      words[i] = number * 2654435761u + i;
+      sum = sum * 31 + words[i];
+    }
+  }
+
+  bool valid() const {
+    uint32_t s = n;
+    for (int i = 0; i < SNAP_WORDS; i++) {
+      if (words[i] != n * 2654435761u + i)
+        return false;
+      s = s * 31 + words[i];
+    }
+    return s == sum;
+  }
+};
+} // namespace
+
+TEST(reads_are_never_torn_by_concurrent_publishes) {
+  static SnapshotBuffer<Snapshot> snap;
+  std::atomic<bool> stop{false};
+  std::thread writer([&] {
+    Snapshot s;
+    for (uint32_t i = 1; !stop; i++) {
+      s.fill(i);
+      snap.publish(s);
+    }
+  });
+  while (snap.seq() == 0)
+    std::this_thread::yield();
+
+  // Wall time rather than a read count, so the writer also gets to run
+  // (and preempt reads mid-copy) on a single-core host
+  static Snapshot s;
+  uint32_t torn = 0, mislabeled = 0, backwards = 0, reads = 0, last = 0;
+  auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+  while (std::chrono::steady_clock::now() < end) {
+    uint32_t seq = snap.read(s);
+    torn += !s.valid();
+    mislabeled += seq != s.n; // The number read() returns is the one copied
+    backwards += s.n < last;
+    last = s.n;
+    reads++;
+  }
+  stop = true;
+  writer.join();
+  CHECK_EQ(torn, 0);
+  CHECK_EQ(mislabeled, 0);
+  CHECK_EQ(backwards, 0);
+  CHECK(reads > 1000);
+  CHECK(last > 1000); // The writer kept publishing throughout
+}
+
+TEST(seq_counts_publishes) {
+  static SnapshotBuffer<Snapshot> snap;
+  static Snapshot s;
+  CHECK_EQ(snap.seq(), 0);
+  for (uint32_t i = 1; i <= 5; i++) {
+    s.fill(i);
+    snap.publish(s);
+    CHECK_EQ(snap.seq(), i);
+  }
+  s.fill(0);
+  CHECK_EQ(snap.read(s), 5);
+  CHECK_EQ(s.n, 5);
+  CHECK(s.valid());
+}
@@ -0,0 +1,134 @@
+// TempHistory: encoding, the two tiers, ring wrap-around and the sample grid
+#include "host_test.h"
+#include "network/temp_history.h"
+
+namespace {
+PrinterModel heating(float bed, float tool) {
+  PrinterModel m;
+  m.status = PS_IDLE;
+  m.heaterCount = 2;
+  m.heaters[0] = {bed, 60.0f};
+  m.heaters[1] = {tool, 215.0f};
+  return m;
+}
+
+// Feed `n` samples on the fine grid starting at `t`, returns the next time
+uint32_t feed(TempHistory &h, uint32_t t, int n, const PrinterModel &m) {
+  for (int i = 0; i < n; i++, t += TH_FINE_MS)
+    h.sample(t, m);
+  return t;
+}
+
+TempPoint buf[TH_COARSE_LEN];
+} // namespace
+
+TEST(memory_budget) {
+  CHECK_EQ(TempHistory::bytes(), 15840);
+  CHECK_EQ(TempHistory::capacity(TT_FINE) * TempHistory::periodMs(TT_FINE),
+           10 * 60000);
+  CHECK_EQ(TempHistory::capacity(TT_COARSE) *
+               TempHistory::periodMs(TT_COARSE),
+           6 * 3600000);
+}
+
+TEST(encoding_rounds_and_clamps) {
+  CHECK_EQ(TempHistory::encode(215.34f), 2153);
+  CHECK_EQ(TempHistory::encode(215.35f), 2154);
+  CHECK_EQ(TempHistory::encode(-0.06f), -1);
+  CHECK_EQ(TempHistory::encode(0.0f), 0);
+  CHECK_EQ(TempHistory::encode(1e6f), INT16_MAX);
+  // Nothing but "no reading" may encode as TH_NONE
+  CHECK_EQ(TempHistory::encode(-1e6f), TH_NONE + 1);
+  CHECK_EQ(TempHistory::encode(0.0f / 0.0f), TH_NONE + 1);
+  CHECK_NEAR(TempHistory::decode(TempHistory::encode(60.1f)), 60.1f, 0.05f);
+}
+
+TEST(fine_ring_keeps_the_last_ten_minutes) {
+  static TempHistory h;
+  PrinterModel m = heating(20.0f, 25.0f);
+  uint32_t t = 0;
+  for (int i = 0; i < TH_FINE_LEN + 50; i++, t += TH_FINE_MS) {
+    m.heaters[1].current = 25.0f + i * 0.1f;
+    h.sample(t, m);
+  }
+  CHECK_EQ(h.end(TT_FINE), TH_FINE_LEN + 50);
+  CHECK_EQ(h.first(TT_FINE), 50);
+
+  static TempPoint all[TH_FINE_LEN];
+  CHECK_EQ(h.read(TT_FINE, 1, 0, all, TH_FINE_LEN), TH_FINE_LEN);
+  CHECK_EQ(all[0].current, 250 + 50); // Oldest held, oldest first
+  CHECK_EQ(all[TH_FINE_LEN - 1].current, 250 + TH_FINE_LEN + 49);
+  CHECK_EQ(all[0].target, 2150);
+
+  // A chart that remembers end() reads only what is new
+  uint32_t seen = h.end(TT_FINE);
+  CHECK_EQ(h.read(TT_FINE, 1, seen, buf, 10), 0);
+  feed(h, t, 3, m);
+  CHECK_EQ(h.read(TT_FINE, 1, seen, buf, 10), 3);
+  CHECK_EQ(h.read(TT_FINE, 1, seen, buf, 2), 2); // Bounded by max
+}
+
+TEST(coarse_points_are_bucket_means) {
+  static TempHistory h;
+  PrinterModel m = heating(20.0f, 100.0f);
+  uint32_t t = 0;
+  const int bucket = TH_COARSE_MS / TH_FINE_MS;
+  for (int i = 0; i < bucket; i++, t += TH_FINE_MS) {
+    m.heaters[0].current = 20.0f + i; // 20..49, mean 34.5
+    h.sample(t, m);
+  }
+  CHECK_EQ(h.end(TT_COARSE), 1);
+  CHECK_EQ(h.read(TT_COARSE, 0, 0, buf, 4), 1);
+  CHECK_EQ(buf[0].current, 345);
+  CHECK_EQ(buf[0].target, 600);
+  CHECK_EQ(h.read(TT_COARSE, 1, 0, buf, 4), 1);
+  CHECK_EQ(buf[0].current, 1000);
+
+  // Seven hours in all: the six-hour ring has dropped the first hour
+  t = feed(h, t, (7 * 3600000 - TH_COARSE_MS) / TH_FINE_MS, m);
+  CHECK_EQ(h.end(TT_COARSE), 7 * 60);
+  CHECK_EQ(h.first(TT_COARSE), 60);
+  CHECK_EQ(h.read(TT_COARSE, 0, 0, buf, TH_COARSE_LEN), TH_COARSE_LEN);
+}
+
+TEST(offline_and_missing_heaters_record_no_reading) {
+  static TempHistory h;
+  PrinterModel m = heating(60.0f, 215.0f);
+  const int bucket = TH_COARSE_MS / TH_FINE_MS;
+  uint32_t t = feed(h, 0, bucket / 2, m);
+  m.status = PS_OFFLINE;
+  feed(h, t, bucket - bucket / 2, m);
+
+  CHECK_EQ(h.read(TT_FINE, 1, h.end(TT_FINE) - 1, buf, 1), 1);
+  CHECK_EQ(buf[0].current, TH_NONE);
+  CHECK_EQ(buf[0].target, TH_NONE);
+  CHECK_EQ(h.read(TT_FINE, 4, 0, buf, 1), 1); // Beyond heaterCount
+  CHECK_EQ(buf[0].current, TH_NONE);
+  CHECK_EQ(h.read(TT_FINE, TH_SENSORS, 0, buf, 1), 0);
+
+  // The mean covers only the online half; a fully offline bucket is empty
+  CHECK_EQ(h.read(TT_COARSE, 0, 0, buf, 1), 1);
+  CHECK_EQ(buf[0].current, 600);
+  CHECK_EQ(h.read(TT_COARSE, 4, 0, buf, 1), 1);
+  CHECK_EQ(buf[0].current, TH_NONE);
+}
+
+TEST(samples_stay_on_the_grid) {
+  static TempHistory h;
+  PrinterModel m = heating(20.0f, 20.0f);
+  CHECK(h.due(12345)); // First sample whenever the task gets to it
+  h.sample(1000, m);
+  CHECK(!h.due(2999));
+  CHECK(h.due(3000));
+  h.sample(3400, m); // A late pass does not shift the grid
+  CHECK(!h.due(4999));
+  CHECK(h.due(5000));
+  h.sample(5000, m);
+
+  // After a stall of several periods, sample from now rather than
+  // bursting to catch up
+  h.sample(60000, m);
+  CHECK(!h.due(61999));
+  CHECK(h.due(62000));
+  CHECK_EQ(h.end(TT_FINE), 4);
+}
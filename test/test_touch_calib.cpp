@@ -0,0 +1,146 @@
+// TouchCalibration: least-squares fits on known point sets, rejection of
+// unusable ones and the fixed-point map
+#include "host_test.h"
+#include "input/touch_calib.h"
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+// The panel's own mapping (axes swapped, x mirrored), rounded to the
+// raw readings the calibration screen would average
+void panel(float sx, float sy, float &rawX, float &rawY) {
+  rawX = 310 - (sy - 20) * 294 / 280;
+  rawY = 19 + (sx - 20) * 459 / 440;
+}
+
+// Five-dot pattern the calibration screen shows
+const int16_t kDots[][2] = {
+    {40, 40}, {440, 40}, {240, 160}, {40, 280}, {440, 280}};
+const int kDotCount = sizeof(kDots) / sizeof(kDots[0]);
+
+int fill(TouchPair *p, float noise = 0) {
+  for (int i = 0; i < kDotCount; i++) {
+    p[i].x = kDots[i][0];
+    p[i].y = kDots[i][1];
+    panel(p[i].x, p[i].y, p[i].rawX, p[i].rawY);
+    // Alternating offsets, so the noise does not average out to a shift
+    p[i].rawX += (i & 1) ? noise : -noise;
+    p[i].rawY += (i & 2) ? noise : -noise;
+  }
+  return kDotCount;
+}
+} // namespace
+
+TEST(default_matches_the_original_formula) {
+  TouchCalibration cal;
+  int worst = 0;
+  for (int xr = 5; xr <= 315; xr++) {
+    for (int yr = 19; yr <= 478; yr += 7) {
+      int32_t x, y;
+      cal.map(xr, yr, x, y);
+      // main.cpp before calibration truncated; map() rounds
+      int ox = (yr - 19) * 440 / 459 + 20;
+      int oy = (310 - xr) * 280 / 294 + 20;
+      worst = std::max(worst, std::max(abs(x - ox), abs(y - oy)));
+    }
+  }
+  CHECK(worst <= 1);
+  CHECK_EQ(cal.rmsError(), 0.0f);
+}
+
+TEST(exact_points_fit_exactly) {
+  TouchPair p[kDotCount];
+  TouchCalibration cal;
+  CHECK(cal.solve(p, fill(p)));
+  CHECK(cal.rmsError() < 0.01f);
+  for (int i = 0; i < kDotCount; i++) {
+    int32_t x, y;
+    cal.map((uint16_t)lroundf(p[i].rawX), (uint16_t)lroundf(p[i].rawY), x,
+            y);
+    CHECK(abs(x - p[i].x) <= 1);
+    CHECK(abs(y - p[i].y) <= 1);
+  }
+}
+
+TEST(noisy_points_fit_within_their_noise) {
+  TouchPair p[kDotCount];
+  TouchCalibration cal;
+  CHECK(cal.solve(p, fill(p, 1.5f)));
+  CHECK(cal.rmsError() > 0.1f);
+  // Never more than the injected error, about 1.5 * sqrt(2) px per dot
+  CHECK(cal.rmsError() < 2.1f);
+  // The middle of the screen still lands within a pixel of the truth
+  float rx, ry;
+  panel(240, 160, rx, ry);
+  int32_t x, y;
+  cal.map((uint16_t)lroundf(rx), (uint16_t)lroundf(ry), x, y);
+  CHECK(abs(x - 240) <= 2);
+  CHECK(abs(y - 160) <= 2);
+}
+
+TEST(unusable_point_sets_are_rejected) {
+  TouchCalibration cal;
+  TouchPair good[kDotCount];
+  CHECK(cal.solve(good, fill(good, 0.5f)));
+  int32_t before[6];
+  memcpy(before, cal.matrix(), sizeof(before));
+  float rms = cal.rmsError();
+
+  TouchPair p[kDotCount];
+  fill(p);
+  CHECK(!cal.solve(p, 2)); // Too few
+
+  for (int i = 0; i < kDotCount; i++) { // All on the diagonal
+    p[i].x = p[i].y = 40 + 50 * i;
+    panel(p[i].x, p[i].y, p[i].rawX, p[i].rawY);
+  }
+  CHECK(!cal.solve(p, kDotCount));
+
+  fill(p); // A finger that never moved: every dot read the same
+  for (int i = 0; i < kDotCount; i++) {
+    p[i].rawX = 150 + (i & 1);
+    p[i].rawY = 250 + (i >> 1);
+  }
+  CHECK(!cal.solve(p, kDotCount)); // Gain far beyond TCAL_MAX_GAIN
+
+  CHECK(memcmp(before, cal.matrix(), sizeof(before)) == 0);
+  CHECK_EQ(cal.rmsError(), rms);
+}
+
+TEST(stored_matrix_is_bounded_and_resets_the_residual) {
+  TouchCalibration cal;
+  TouchPair p[kDotCount];
+  CHECK(cal.solve(p, fill(p, 1.0f)));
+  CHECK(cal.rmsError() > 0);
+
+  int32_t m[6];
+  memcpy(m, cal.matrix(), sizeof(m));
+  TouchCalibration loaded;
+  CHECK(loaded.set(m));
+  CHECK(memcmp(loaded.matrix(), m, sizeof(m)) == 0);
+  CHECK(cal.set(m));
+  CHECK_EQ(cal.rmsError(), 0.0f); // No residual known for a stored fit
+
+  int32_t bad[6];
+  memcpy(bad, m, sizeof(bad));
+  bad[0] = (TCAL_MAX_GAIN << TCAL_FRAC_BITS) + 1;
+  CHECK(!loaded.set(bad));
+  memcpy(bad, m, sizeof(bad));
+  bad[5] = -(TCAL_MAX_OFFSET << TCAL_FRAC_BITS) - 1;
+  CHECK(!loaded.set(bad));
+  CHECK(memcmp(loaded.matrix(), m, sizeof(m)) == 0);
+}
+
+TEST(map_rounds_to_nearest) {
+  TouchCalibration cal;
+  cal.setAffine(0.5, 0, 0, 0, 0.25, 10);
+  int32_t x, y;
+  cal.map(3, 5, x, y); // 1.5, 11.25
+  CHECK_EQ(x, 2);
+  CHECK_EQ(y, 11);
+  cal.map(4095, 4095, x, y); // 12-bit extremes do not overflow
+  CHECK_EQ(x, 2048);
+  CHECK_EQ(y, 1034);
+}
@@ -0,0 +1,212 @@
+// TouchFilter replaying traces in the TOUCH_TRACE log format, and the
+// TouchRing that carries samples from the touch task to the UI
+#include "host_test.h"
+#include "input/touch_filter.h"
+#include "input/touch_ring.h"
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+namespace {
+struct Edge {
+  uint32_t us;
+  bool down;
+  uint16_t x, y;
+};
+
+// Feed "TRACE: us,x,y,down" lines as LVGL's read callback would: samples
+// as they arrive, with update() on a 5 ms read period in between and for
+// `tailUs` after the last one. Returns every change of the pressed state.
+std::vector<Edge> replay(TouchFilter &f, const char *trace,
+                         uint32_t tailUs = 500000) {
+  std::vector<Edge> edges;
+  bool was = false;
+  uint32_t now = 0;
+  auto check = [&](uint32_t us) {
+    if (f.update(us) != was) {
+      was = f.pressed();
+      edges.push_back({us, was, f.x(), f.y()});
+    }
+  };
+  for (const char *line = trace; line && *line;) {
+    unsigned us, x, y;
+    int down;
+    if (sscanf(line, "TRACE: %u,%u,%u,%d", &us, &x, &y, &down) == 4) {
+      TouchSample s = {us, (uint16_t)x, (uint16_t)y, down != 0};
+      for (uint32_t t = now + 5000; t < us; t += 5000)
+        check(t); // Timeouts due before this sample
+      f.push(s);
+      check(us);
+      now = us;
+    }
+    line = strchr(line, '\n');
+    if (line)
+      line++;
+  }
+  for (uint32_t t = now; t <= now + tailUs; t += 5000)
+    check(t);
+  return edges;
+}
+} // namespace
+
+TEST(press_is_reported_on_its_first_sample) {
+  TouchFilter f;
+  f.push({1000, 412, 300, true});
+  CHECK(f.update(1000));
+  CHECK_EQ(f.x(), 412);
+  CHECK_EQ(f.y(), 300);
+  CHECK_EQ(f.pressUs(), 1000);
+}
+
+TEST(dropout_mid_press_is_merged) {
+  // One tap; the controller reports a lift for 12 ms in the middle
+  TouchFilter f;
+  std::vector<Edge> e = replay(f, "TRACE: 0,200,150,1\n"
+                                  "TRACE: 16000,201,150,1\n"
+                                  "TRACE: 32000,200,150,0\n"
+                                  "TRACE: 44000,200,151,1\n"
+                                  "TRACE: 60000,200,150,1\n"
+                                  "TRACE: 76000,200,150,0\n");
+  CHECK_EQ(e.size(), 2);
+  CHECK_EQ(f.presses(), 1);
+  CHECK_EQ(f.merged(), 1);
+  CHECK(e[0].down && e[0].us == 0);
+  CHECK(!e[1].down && e[1].us == 76000 + TF_RELEASE_US);
+}
+
+TEST(double_tap_stays_two_taps) {
+  TouchFilter f;
+  std::vector<Edge> e = replay(f, "TRACE: 0,200,150,1\n"
+                                  "TRACE: 16000,200,150,1\n"
+                                  "TRACE: 32000,200,150,0\n"
+                                  "TRACE: 90000,202,148,1\n"
+                                  "TRACE: 106000,202,148,1\n"
+                                  "TRACE: 122000,202,148,0\n");
+  CHECK_EQ(e.size(), 4);
+  CHECK_EQ(f.presses(), 2);
+  CHECK_EQ(f.merged(), 0);
+  CHECK(!e[1].down && e[1].us == 32000 + TF_RELEASE_US);
+  CHECK(e[2].down && e[2].us == 90000);
+}
+
+TEST(lift_seen_only_on_the_next_press) {
+  // Samples delivered late: the gap is only visible from the next press
+  TouchFilter f;
+  f.push({0, 100, 100, true});
+  f.push({10000, 100, 100, false});
+  f.push({60000, 300, 200, true});
+  CHECK_EQ(f.presses(), 2);
+  CHECK_EQ(f.x(), 300); // New press, not smoothed towards the old one
+}
+
+TEST(held_finger_stays_put) {
+  TouchFilter f;
+  static const int16_t wobble[] = {0, 1, -1, 2, -2, 1, 0, -1, 2, 1};
+  f.push({0, 240, 160, true});
+  uint32_t us = 0;
+  for (int r = 0; r < 10; r++) {
+    for (int16_t w : wobble) {
+      us += 16000;
+      f.push({us, (uint16_t)(240 + w), (uint16_t)(160 - w), true});
+      CHECK(f.update(us));
+      CHECK_EQ(f.x(), 240);
+      CHECK_EQ(f.y(), 160);
+    }
+  }
+  CHECK_EQ(f.held(), 100);
+}
+
+TEST(drags_are_smoothed_and_large_moves_snap) {
+  TouchFilter f;
+  f.push({0, 100, 100, true});
+  f.push({16000, 110, 100, true}); // Mid-sized: halfway
+  CHECK_EQ(f.x(), 105);
+  f.push({32000, 110, 100, true});
+  CHECK_EQ(f.x(), 107);
+  f.push({48000, 110 + TF_SNAP + 3, 100, true}); // Fast drag: no lag
+  CHECK_EQ(f.x(), 110 + TF_SNAP + 3);
+  f.push({64000, 40, 100, true}); // Same leftwards
+  CHECK_EQ(f.x(), 40);
+  CHECK_EQ(f.y(), 100);
+}
+
+TEST(swipe_trace_follows_the_finger) {
+  // A 300-unit swipe at 15 units per report, then lift
+  char trace[4096];
+  size_t n = 0;
+  uint32_t us = 0;
+  for (int i = 0; i <= 20; i++, us += 16000)
+    n += snprintf(trace + n, sizeof(trace) - n, "TRACE: %u,%d,200,1\n",
+                  (unsigned)us, 50 + 15 * i);
+  snprintf(trace + n, sizeof(trace) - n, "TRACE: %u,350,200,0\n",
+           (unsigned)us);
+  TouchFilter f;
+  std::vector<Edge> e = replay(f, trace);
+  CHECK_EQ(e.size(), 2);
+  CHECK(!e[1].down);
+  // Halving every step trails a steady drag by at most one step
+  CHECK(350 - e[1].x <= 15);
+}
+
+TEST(stuck_press_times_out) {
+  // The controller stops answering with a finger down
+  TouchFilter f;
+  f.push({0, 10, 10, true});
+  f.push({20000, 10, 10, true});
+  CHECK(f.update(20000 + TF_STALE_US - 1));
+  CHECK(!f.update(20000 + TF_STALE_US));
+  f.push({300000, 10, 10, true}); // Next report is a fresh press
+  CHECK_EQ(f.presses(), 2);
+}
+
+TEST(timeouts_survive_the_microsecond_wrap) {
+  TouchFilter f;
+  uint32_t t = 0xFFFFFFFFu - 10000;
+  f.push({t, 10, 10, true});
+  f.push({t + 5000, 10, 10, false});
+  CHECK(f.update(t + 5000 + TF_RELEASE_US - 1));
+  CHECK(!f.update(t + 5000 + TF_RELEASE_US));
+}
+
+TEST(ring_refuses_when_full) {
+  TouchRing<TouchSample, 4> r;
+  TouchSample s = {0, 1, 2, true};
+  for (int i = 0; i < 4; i++)
+    CHECK(r.push(s));
+  CHECK(!r.push(s)); // Unread samples are not overwritten
+  TouchSample out;
+  CHECK(r.pop(out));
+  CHECK(r.push(s));
+  int n = 0;
+  while (r.pop(out))
+    n++;
+  CHECK_EQ(n, 4);
+  CHECK(r.empty());
+}
+
+TEST(ring_hands_samples_across_threads_in_order) {
+  TouchRing<TouchSample, 16> r;
+  const uint32_t count = 100000;
+  std::thread producer([&] {
+    for (uint32_t i = 1; i <= count;) {
+      TouchSample s = {i, (uint16_t)i, (uint16_t)(i >> 16), true};
+      if (r.push(s))
+        i++;
+      else
+        std::this_thread::yield();
+    }
+  });
+  uint32_t expect = 1, bad = 0;
+  while (expect <= count) {
+    TouchSample s;
+    if (!r.pop(s)) {
+      std::this_thread::yield();
+      continue;
+    }
+    bad += s.us != expect || s.x != (uint16_t)expect;
+    expect++;
+  }
+  producer.join();
+  CHECK_EQ(bad, 0);
+}
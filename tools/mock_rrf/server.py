@@ -0,0 +1,509 @@
+#!/usr/bin/env python3
+"""Mock RepRapFirmware printer for the BoxTurtle display.
+
+Serves the requests the firmware makes, from a scenario file:
+
+  /rr_model?key=<key>          one object-model key, dotted for globals
+                               (global.AFC_lanes)
+  /rr_model?flags=d99fn        live values of every branch, plus seqs
+  /rr_gcode?gcode=<G-code>     heater setpoints and `set global.` are
+                               applied to the model, echo goes to the reply
+  /rr_reply                    G-code replies since the last call
+  /rr_download?name=0:/sys/filamentList.json
+
+A scenario is an object model plus a timeline of changes; see
+scenarios/*.json. Faults can be injected into every request: latency and
+jitter, dropped connections, slow bodies, chunked encoding. Each request is
+logged with its timing, and a summary per endpoint is printed on exit and
+served at /mock/stats. /mock/reset restarts the scenario and the stats.
+
+  tools/mock_rrf/server.py tools/mock_rrf/scenarios/printing.json
+  tools/mock_rrf/server.py --latency 40 --jitter 60 --drop 0.02 \\
+      tools/mock_rrf/scenarios/lane_swap.json
+
+The firmware always connects to port 80, so a device on a test LAN needs
+--port 80 (root, or CAP_NET_BIND_SERVICE). Host tests pass --port 0 and
+read the port from the first line of output.
+
+Python 3.7 or later, standard library only.
+"""
+
+import argparse
+import copy
+import json
+import os
+import random
+import re
+import sys
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlsplit
+
+# Fields RRF reports in a flags=d99fn response: the live values, which
+# change without moving the branch's seqs counter
+LIVE = {
+    "heat": {"heaters": {"*": ["active", "current", "standby", "state"]}},
+    "job": ["duration", "filePosition", "layer", "layerTime", "timesLeft",
+            "warmUpDuration"],
+    "state": ["currentTool", "msUpTime", "status", "time", "upTime"],
+    "tools": {"*": ["active", "isRetracted", "standby", "state"]},
+}
+
+AMBIENT = 25.0
+FILAMENT_LIST = "0:/sys/filamentList.json"
+
+
+def deep_merge(base, over):
+    """Objects merge by key, arrays of objects element by element"""
+    if isinstance(over, dict) and isinstance(base, dict):
+        for k, v in over.items():
+            base[k] = deep_merge(base[k], v) if k in base else v
+        return base
+    if (isinstance(over, list) and isinstance(base, list) and
+            all(isinstance(v, dict) for v in over)):
+        for i, v in enumerate(over):
+            if i < len(base):
+                base[i] = deep_merge(base[i], v)
+            else:
+                base.append(v)
+        return base
+    return over
+
+
+def load_scenario(path):
+    """A scenario and the model, filaments, rates and heating of the one it
+    names as its base; the timeline is its own"""
+    with open(path) as f:
+        scn = json.load(f)
+    if "base" in scn:
+        base = load_scenario(os.path.join(os.path.dirname(path), scn["base"]))
+        scn["model"] = deep_merge(base.get("model", {}), scn.get("model", {}))
+        for k in ("filaments", "rates", "heat_rate"):
+            if k in base:
+                scn.setdefault(k, base[k])
+    scn.setdefault("timeline", [])
+    scn.setdefault("rates", {})
+    scn["timeline"].sort(key=lambda e: e["at"])
+    return scn
+
+
+def split_path(path):
+    """heat.heaters.1.current or AFC_lanes[0][1][4][0] -> list of parts"""
+    parts = []
+    for p in re.split(r"\.|(?=\[)", path):
+        if p.startswith("["):
+            parts.append(int(p[1:-1]))
+        elif p.isdigit():
+            parts.append(int(p))
+        elif p:
+            parts.append(p)
+    return parts
+
+
+def lookup(model, parts):
+    node = model
+    for p in parts:
+        try:
+            node = node[p]
+        except (KeyError, IndexError, TypeError):
+            return None
+    return node
+
+
+def assign(model, parts, value):
+    node = model
+    for p in parts[:-1]:
+        node = node[p]
+    node[parts[-1]] = value
+
+
+def number(v):
+    """JSON number as RRF prints it: integral values without a fraction"""
+    return int(v) if float(v).is_integer() else v
+
+
+def project(value, spec):
+    if isinstance(spec, list):
+        return {k: value[k] for k in spec if k in value}
+    if "*" in spec:
+        return [project(v, spec["*"]) for v in value]
+    return {k: project(value[k], s) for k, s in spec.items() if k in value}
+
+
+def is_live(parts):
+    spec = LIVE.get(parts[0])
+    for p in parts[1:]:
+        if spec is None:
+            return False
+        if isinstance(spec, list):
+            return p in spec
+        spec = spec.get("*" if isinstance(p, int) else p)
+    return spec is not None
+
+
+class Printer:
+    """Object model moving along the scenario timeline, in scenario time
+    (wall time times --speed), looping if the scenario says so"""
+
+    def __init__(self, scenario, speed):
+        self.scenario = scenario
+        self.speed = speed
+        self.lock = threading.Lock()
+        self.seqs = copy.deepcopy(scenario["model"].get("seqs", {}))
+        self.reset()
+
+    def reset(self):
+        with self.lock:
+            self.start = time.monotonic()
+            self.restart()
+
+    def restart(self):
+        """Back to the start of the timeline; lock held"""
+        self.model = copy.deepcopy(self.scenario["model"])
+        self.model["seqs"] = self.seqs
+        for branch, seq in self.seqs.items():
+            if isinstance(seq, int):
+                self.seqs[branch] += 1  # Everything may have changed
+        self.offline = False
+        self.replies = []
+        self.next_event = 0
+        self.t = 0.0
+        self.set_rates(self.scenario["rates"])
+
+    def now(self):
+        return (time.monotonic() - self.start) * self.speed
+
+    def advance(self):
+        """Bring the model up to the current scenario time; lock held"""
+        t = self.now()
+        loop = self.scenario.get("loop")
+        if loop and t >= loop:
+            self.start += (t // loop) * loop / self.speed
+            self.restart()
+            t = self.now()
+        events = self.scenario["timeline"]
+        prev = self.t
+        while self.next_event < len(events) and events[self.next_event]["at"] <= t:
+            self.t = events[self.next_event]["at"]  # Rates start from here
+            self.apply(events[self.next_event])
+            self.next_event += 1
+        dt, self.t = t - prev, t
+        # A printer that stopped answering carries on printing regardless
+        for path, (t0, v0, per_s) in self.rates.items():
+            v = v0 + per_s * (t - t0)
+            assign(self.model, split_path(path),
+                   int(v) if isinstance(v0, int) else round(v, 1))
+        self.settle_heaters(dt)
+
+    def set_rates(self, rates):
+        """Values moving steadily from now on, e.g. job.filePosition"""
+        self.rates = {}
+        for path, per_s in rates.items():
+            v0 = lookup(self.model, split_path(path))
+            if v0 is not None:
+                self.rates[path] = (self.t, v0, per_s)
+
+    def apply(self, event):
+        if "offline" in event:
+            self.offline = event["offline"]
+        if "rates" in event:
+            self.set_rates(event["rates"])
+        for path, value in event.get("set", {}).items():
+            self.set(split_path(path), value)
+
+    def set(self, parts, value):
+        assign(self.model, parts, value)
+        if not is_live(parts) and parts[0] in self.seqs:
+            self.seqs[parts[0]] += 1
+
+    def settle_heaters(self, dt):
+        rate = self.scenario.get("heat_rate", 0)
+        if not rate or dt <= 0:
+            return
+        for h in self.model["heat"]["heaters"]:
+            target = h["active"] if h.get("state") != "off" else AMBIENT
+            step = rate * dt
+            cur = h["current"]
+            cur = min(cur + step, target) if cur < target else max(cur - step, target)
+            h["current"] = round(cur, 1)
+
+    # Requests
+
+    def key(self, key):
+        with self.lock:
+            self.advance()
+            if self.offline:
+                return None
+            value = lookup(self.model, split_path(key)) if key else None
+            return {"key": key, "flags": "", "result": value}
+
+    def live(self):
+        with self.lock:
+            self.advance()
+            if self.offline:
+                return None
+            result = {b: project(self.model[b], s) for b, s in LIVE.items()}
+            result["seqs"] = self.seqs
+            return {"key": "", "flags": "d99fn", "result": result}
+
+    def gcode(self, text):
+        with self.lock:
+            self.advance()
+            if self.offline:
+                return None
+            for line in text.split("\n"):
+                self.run_line(line.strip())
+            return {"buff": 255}
+
+    def run_line(self, line):
+        m = re.match(r"set global\.(\S+)\s*=\s*(.+)$", line)
+        if m:
+            try:
+                self.set(["global"] + split_path(m.group(1)), json.loads(m.group(2)))
+            except (ValueError, KeyError, IndexError, TypeError):
+                self.reply("Error: bad set: " + line)
+            return
+        m = re.match(r'echo\s+"?(.*?)"?$', line)
+        if m:
+            self.reply(m.group(1))
+            return
+        words = dict((w[0].upper(), w[1:]) for w in line.split()[1:] if w)
+        cmd = line.split()[0].upper() if line else ""
+        if cmd == "M140" and "S" in words:
+            self.setpoint(self.model["heat"]["bedHeaters"][0], words["S"])
+        elif cmd in ("G10", "M104", "M568") and "S" in words:
+            tool = int(words.get("P", words.get("T", self.model["state"]["currentTool"])))
+            tools = self.model["tools"]
+            if 0 <= tool < len(tools):
+                tools[tool]["active"][0] = number(float(words["S"]))
+                self.setpoint(tools[tool]["heaters"][0], words["S"])
+
+    def setpoint(self, heater, value):
+        heaters = self.model["heat"]["heaters"]
+        if 0 <= heater < len(heaters):
+            v = number(float(value))
+            heaters[heater]["active"] = v
+            heaters[heater]["state"] = "active" if v > 0 else "off"
+
+    def reply(self, text):
+        self.replies.append(text)
+        self.seqs["reply"] = self.seqs.get("reply", 0) + 1
+
+    def take_reply(self):
+        with self.lock:
+            self.advance()
+            if self.offline:
+                return None
+            text, self.replies = "\n".join(self.replies), []
+            return text
+
+    def filaments(self):
+        with self.lock:
+            self.advance()
+            if self.offline:
+                return None
+            return {"listValues": self.scenario.get("filaments", [])}
+
+
+class Stats:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.clear()
+
+    def clear(self):
+        self.rows = {}
+        self.start = time.monotonic()
+
+    def add(self, label, ok, nbytes, ms):
+        with self.lock:
+            r = self.rows.setdefault(label, {"ms": [], "failed": 0, "bytes": 0})
+            r["ms"].append(ms)
+            r["bytes"] += nbytes
+            r["failed"] += not ok
+
+    def summary(self):
+        with self.lock:
+            out = {"seconds": round(time.monotonic() - self.start, 3), "endpoints": {}}
+            for label, r in sorted(self.rows.items()):
+                ms = sorted(r["ms"])
+                out["endpoints"][label] = {
+                    "requests": len(ms),
+                    "failed": r["failed"],
+                    "bytes": r["bytes"],
+                    "mean_ms": round(sum(ms) / len(ms), 2),
+                    "p50_ms": round(ms[len(ms) // 2], 2),
+                    "p95_ms": round(ms[min(len(ms) - 1, int(len(ms) * 0.95))], 2),
+                    "max_ms": round(ms[-1], 2),
+                }
+            return out
+
+    def report(self, f=sys.stdout):
+        s = self.summary()
+        total = sum(e["requests"] for e in s["endpoints"].values())
+        print("\n%d requests in %.1f s (%.2f/s)" % (
+            total, s["seconds"], total / s["seconds"] if s["seconds"] else 0), file=f)
+        print("%-32s %6s %6s %9s %8s %8s %8s" % (
+            "endpoint", "count", "failed", "bytes", "mean ms", "p95 ms", "max ms"), file=f)
+        for label, e in s["endpoints"].items():
+            print("%-32s %6d %6d %9d %8.1f %8.1f %8.1f" % (
+                label, e["requests"], e["failed"], e["bytes"], e["mean_ms"],
+                e["p95_ms"], e["max_ms"]), file=f)
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # Keep-alive, as RRF serves it
+    # Headers and body are separate writes. With Nagle on, a kept-alive
+    # socket holds the body until the client's delayed ACK (40 ms on Linux).
+    disable_nagle_algorithm = True
+
+    def do_GET(self):
+        start = time.monotonic()
+        cfg = self.server.cfg
+        url = urlsplit(self.path)
+        q = {k: v[0] for k, v in parse_qs(url.query).items()}
+        label = url.path.lstrip("/")
+        if url.path == "/rr_model":
+            label += " " + (q.get("key") or q.get("flags", ""))
+
+        if url.path.startswith("/mock/"):
+            self.mock(url.path)
+            return
+        if random.random() < cfg.drop:
+            self.fail(start, label, "drop")
+            return
+        delay = cfg.latency + random.uniform(0, cfg.jitter)
+        if delay:
+            time.sleep(delay / 1000.0)
+
+        printer = self.server.printer
+        if url.path == "/rr_model":
+            body = printer.key(q["key"]) if q.get("key") else printer.live()
+        elif url.path == "/rr_gcode":
+            body = printer.gcode(q.get("gcode", ""))
+        elif url.path == "/rr_reply":
+            body = printer.take_reply()
+        elif url.path == "/rr_download" and q.get("name") == FILAMENT_LIST:
+            body = printer.filaments()
+        else:
+            self.send(404, b"", start, label)
+            return
+        if body is None:  # Printer offline
+            self.fail(start, label, cfg.offline_mode)
+            return
+        if isinstance(body, str):
+            self.send(200, body.encode(), start, label, "text/plain")
+        else:
+            self.send(200, json.dumps(body, separators=(",", ":")).encode(), start, label)
+
+    def mock(self, path):
+        if path == "/mock/stats":
+            body = json.dumps(self.server.stats.summary()).encode()
+        elif path == "/mock/reset":
+            self.server.printer.reset()
+            self.server.stats.clear()
+            body = b"{}"
+        elif path == "/mock/shutdown":
+            body = b"{}"
+            threading.Thread(target=self.server.shutdown).start()
+        else:
+            body = b""
+        self.send_response(200 if body else 404)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def fail(self, start, label, mode):
+        if mode == "hang":  # Never answers: the client runs to its timeout
+            time.sleep(self.server.cfg.hang)
+        self.close_connection = True
+        self.log(start, label, mode, 0)
+
+    def send(self, code, body, start, label, ctype="application/json"):
+        cfg = self.server.cfg
+        self.send_response(code)
+        self.send_header("Content-Type", ctype)
+        if cfg.chunked:
+            self.send_header("Transfer-Encoding", "chunked")
+        else:
+            self.send_header("Content-Length", str(len(body)))
+        if cfg.no_keepalive:
+            self.send_header("Connection", "close")
+            self.close_connection = True
+        self.end_headers()
+        piece = 256 if cfg.slow_body else max(len(body), 1)
+        for i in range(0, len(body), piece):
+            part = body[i:i + piece]
+            if cfg.chunked:
+                self.wfile.write(b"%x\r\n%s\r\n" % (len(part), part))
+            else:
+                self.wfile.write(part)
+            if cfg.slow_body:
+                self.wfile.flush()
+                time.sleep(len(part) / float(cfg.slow_body))
+        if cfg.chunked:
+            self.wfile.write(b"0\r\n\r\n")
+        self.log(start, label, str(code), len(body))
+
+    def log(self, start, label, result, nbytes):
+        ms = (time.monotonic() - start) * 1000.0
+        self.server.stats.add(label, result == "200", nbytes, ms)
+        if not self.server.cfg.quiet:
+            t = self.server.printer.now()
+            line = "%9.3f  %-32s %-5s %6d B %8.1f ms" % (t, label, result, nbytes, ms)
+            print(line, file=sys.stderr, flush=True)
+        if self.server.csv:
+            with self.server.stats.lock:
+                self.server.csv.write("%.3f,%s,%s,%d,%.2f\n" % (
+                    time.time(), label, result, nbytes, ms))
+                self.server.csv.flush()
+
+    def log_message(self, fmt, *args):
+        pass  # Requests are logged by log() with their timing
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("scenario", help="scenario JSON file")
+    ap.add_argument("--host", default="0.0.0.0")
+    ap.add_argument("--port", type=int, default=8080, help="0 picks a free port")
+    ap.add_argument("--speed", type=float, default=1.0,
+                    help="scenario seconds per wall-clock second")
+    ap.add_argument("--latency", type=float, default=0, help="ms added to every request")
+    ap.add_argument("--jitter", type=float, default=0, help="uniform extra ms, 0..N")
+    ap.add_argument("--drop", type=float, default=0,
+                    help="share of requests dropped without a response, 0..1")
+    ap.add_argument("--slow-body", type=int, default=0, metavar="BYTES_PER_S",
+                    help="send bodies in 256-byte pieces at this rate")
+    ap.add_argument("--chunked", action="store_true",
+                    help="chunked bodies, without Content-Length")
+    ap.add_argument("--no-keepalive", action="store_true",
+                    help="close the connection after each response")
+    ap.add_argument("--offline-mode", choices=("drop", "hang"), default="drop",
+                    help="while offline: close at once, or never answer")
+    ap.add_argument("--hang", type=float, default=10, help="seconds a hang lasts")
+    ap.add_argument("--seed", type=int, help="random seed, for repeatable faults")
+    ap.add_argument("--csv", help="append one row per request to this file")
+    ap.add_argument("--quiet", action="store_true", help="no per-request log")
+    cfg = ap.parse_args()
+
+    random.seed(cfg.seed)
+    server = ThreadingHTTPServer((cfg.host, cfg.port), Handler)
+    server.daemon_threads = True
+    server.cfg = cfg
+    server.printer = Printer(load_scenario(cfg.scenario), cfg.speed)
+    server.stats = Stats()
+    server.csv = open(cfg.csv, "a") if cfg.csv else None
+    host, port = server.server_address[:2]
+    print("mock_rrf: listening on %s:%d" % (host, port), flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    server.server_close()
+    server.stats.report()
+
+
+if __name__ == "__main__":
+    main()